@@ -27,6 +27,7 @@
 #include <librepcb/common/debug.h>
 #include <librepcb/common/exceptions.h>
 #include <librepcb/common/network/networkaccessmanager.h>
+#include <librepcb/common/tracer.h>
 #include <librepcb/workspace/workspace.h>
 #include "firstrunwizard/firstrunwizard.h"
 #include "controlpanel/controlpanel.h"
@@ -44,6 +45,7 @@ using namespace librepcb::application;
 
 static void setApplicationMetadata() noexcept;
 static void writeLogHeader() noexcept;
+static void initTracing() noexcept;
 static void installTranslations() noexcept;
 static void init3rdPartyLibs() noexcept;
 static void cleanup3rdPartyLibs() noexcept;
@@ -72,6 +74,9 @@ int main(int argc, char* argv[])
     // Write some information about the application instance to the log.
     writeLogHeader();
 
+    // Enable recording of trace spans if requested (to profile loading projects etc.)
+    initTracing();
+
     // Install translation files. This must be done before any widget is shown.
     installTranslations();
 
@@ -104,6 +109,9 @@ int main(int argc, char* argv[])
     // Cleanup all 3rd party libraries
     cleanup3rdPartyLibs();
 
+    // Write the recorded trace spans to the trace file (if tracing is enabled)
+    Tracer::instance().disable();
+
     qDebug() << "Exit application with code" << retval;
     return retval;
 }
@@ -141,6 +149,24 @@ static void writeLogHeader() noexcept
     }
 }
 
+/*****************************************************************************************
+ *  initTracing()
+ ****************************************************************************************/
+
+static void initTracing() noexcept
+{
+    // the trace file can be set either by environment variable or by command line
+    QString filepath = QString::fromLocal8Bit(qgetenv("LIBREPCB_TRACE_FILE"));
+    foreach (const QString& arg, Application::arguments()) {
+        if (arg.startsWith("--trace-file=")) {
+            filepath = arg.mid(QString("--trace-file=").length());
+        }
+    }
+    if (!filepath.isEmpty()) {
+        Tracer::instance().enable(FilePath(QFileInfo(filepath).absoluteFilePath()));
+    }
+}
+
 /*****************************************************************************************
  *  installTranslations()
  ****************************************************************************************/
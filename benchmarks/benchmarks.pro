@@ -0,0 +1,54 @@
+#-------------------------------------------------
+#
+# Project created 2026-10-15
+#
+#-------------------------------------------------
+
+TEMPLATE = app
+TARGET = librepcb-benchmarks
+
+# Set the path for the generated binary
+GENERATED_DIR = ../generated
+
+# Use common project definitions
+include(../common.pri)
+
+QT += core widgets network printsupport xml opengl sql concurrent
+
+CONFIG += console
+CONFIG -= app_bundle
+
+LIBS += \
+    -L$${DESTDIR} \
+    -llibrepcbproject \
+    -llibrepcblibrary \    # Note: The order of the libraries is very important for the linker!
+    -llibrepcbcommon \     # Another order could end up in "undefined reference" errors!
+    -lsexpresso \
+    -lclipper \
+
+INCLUDEPATH += \
+    ../libs \
+
+DEPENDPATH += \
+    ../libs/librepcb/project \
+    ../libs/librepcb/library \
+    ../libs/librepcb/common \
+    ../libs/sexpresso \
+    ../libs/clipper \
+
+PRE_TARGETDEPS += \
+    $${DESTDIR}/liblibrepcbproject.a \
+    $${DESTDIR}/liblibrepcblibrary.a \
+    $${DESTDIR}/liblibrepcbcommon.a \
+    $${DESTDIR}/libsexpresso.a \
+    $${DESTDIR}/libclipper.a \
+
+SOURCES += \
+    benchmarksuite.cpp \
+    main.cpp \
+    syntheticboardgenerator.cpp \
+
+HEADERS += \
+    benchmarksuite.h \
+    syntheticboardgenerator.h \
+
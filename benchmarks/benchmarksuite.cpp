@@ -0,0 +1,104 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <algorithm>
+#include <numeric>
+#include "benchmarksuite.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace benchmarks {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+BenchmarkSuite::BenchmarkSuite(int iterations) noexcept :
+    mIterations(qMax(1, iterations))
+{
+}
+
+BenchmarkSuite::~BenchmarkSuite() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+void BenchmarkSuite::setInfo(const QString& key, const QJsonValue& value) noexcept
+{
+    mInfo.insert(key, value);
+}
+
+void BenchmarkSuite::measure(const QString& name, const std::function<void()>& function,
+                             const std::function<void()>& cleanup)
+{
+    Result result;
+    result.name = name;
+    for (int i = 0; i < mIterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        function(); // can throw
+        result.durationsNs.append(timer.nsecsElapsed());
+        if (cleanup) {
+            cleanup(); // can throw
+        }
+    }
+    mResults.append(result);
+}
+
+QJsonObject BenchmarkSuite::toJson() const noexcept
+{
+    QJsonArray results;
+    foreach (const Result& result, mResults) {
+        QVector<qint64> sorted = result.durationsNs;
+        std::sort(sorted.begin(), sorted.end());
+        qint64 sum = std::accumulate(sorted.begin(), sorted.end(), qint64(0));
+        QJsonArray durations;
+        foreach (qint64 duration, result.durationsNs) {
+            durations.append(duration / 1e6);
+        }
+        QJsonObject obj;
+        obj.insert("name", result.name);
+        obj.insert("iterations", sorted.count());
+        obj.insert("min_ms", sorted.first() / 1e6);
+        obj.insert("median_ms", sorted.at(sorted.count() / 2) / 1e6);
+        obj.insert("mean_ms", (sum / sorted.count()) / 1e6);
+        obj.insert("durations_ms", durations);
+        results.append(obj);
+    }
+    QJsonObject root;
+    root.insert("info", mInfo);
+    root.insert("results", results);
+    return root;
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace benchmarks
+} // namespace librepcb
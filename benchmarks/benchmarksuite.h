@@ -0,0 +1,102 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_BENCHMARKS_BENCHMARKSUITE_H
+#define LIBREPCB_BENCHMARKS_BENCHMARKSUITE_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <functional>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+namespace benchmarks {
+
+/*****************************************************************************************
+ *  Class BenchmarkSuite
+ ****************************************************************************************/
+
+/**
+ * @brief The BenchmarkSuite class measures execution times and collects them as JSON
+ *
+ * Every benchmark is executed a fixed number of times. The JSON output contains the
+ * minimum, median and mean duration of each benchmark (in milliseconds) as well as all
+ * single durations, so it can be compared automatically between different versions.
+ */
+class BenchmarkSuite final
+{
+    public:
+
+        // Constructors / Destructor
+        BenchmarkSuite() = delete;
+        BenchmarkSuite(const BenchmarkSuite& other) = delete;
+        explicit BenchmarkSuite(int iterations) noexcept;
+        ~BenchmarkSuite() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Add some information to the JSON output (e.g. benchmark parameters)
+         */
+        void setInfo(const QString& key, const QJsonValue& value) noexcept;
+
+        /**
+         * @brief Execute and measure a benchmark
+         *
+         * @param name      Unique name of the benchmark
+         * @param function  The code to measure
+         * @param cleanup   Optional code executed after each (measured) execution,
+         *                  which is not included in the measured time
+         *
+         * @throw Exception (or any other exception) thrown by function or cleanup
+         */
+        void measure(const QString& name, const std::function<void()>& function,
+                     const std::function<void()>& cleanup = std::function<void()>());
+
+        QJsonObject toJson() const noexcept;
+
+        // Operator Overloadings
+        BenchmarkSuite& operator=(const BenchmarkSuite& rhs) = delete;
+
+
+    private: // Types
+        struct Result {
+            QString name;
+            QVector<qint64> durationsNs;
+        };
+
+
+    private: // Data
+        int mIterations;
+        QJsonObject mInfo;
+        QList<Result> mResults;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace benchmarks
+} // namespace librepcb
+
+#endif // LIBREPCB_BENCHMARKS_BENCHMARKSUITE_H
@@ -0,0 +1,247 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <librepcb/common/application.h>
+#include <librepcb/common/debug.h>
+#include <librepcb/common/exceptions.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/fileio/sexpression.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/circuit/netsignal.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardairwiresbuilder.h>
+#include <librepcb/project/boards/boarddesignrulecheck.h>
+#include <librepcb/project/boards/boardgerberexport.h>
+#include <librepcb/project/boards/boardplanefragmentsbuilder.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_footprint.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+#include "benchmarksuite.h"
+#include "syntheticboardgenerator.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+using namespace librepcb;
+using namespace librepcb::project;
+using namespace librepcb::benchmarks;
+
+/*****************************************************************************************
+ *  Benchmarks
+ ****************************************************************************************/
+
+static QJsonObject getBoardStatistics(const Board& board) noexcept
+{
+    int pads = 0, vias = 0, netpoints = 0, netlines = 0;
+    foreach (const BI_Device* device, board.getDeviceInstances()) {
+        pads += device->getFootprint().getPads().count();
+    }
+    foreach (const BI_NetSegment* netsegment, board.getNetSegments()) {
+        vias += netsegment->getVias().count();
+        netpoints += netsegment->getNetPoints().count();
+        netlines += netsegment->getNetLines().count();
+    }
+    QJsonObject obj;
+    obj.insert("devices", board.getDeviceInstances().count());
+    obj.insert("pads", pads);
+    obj.insert("vias", vias);
+    obj.insert("netpoints", netpoints);
+    obj.insert("netlines", netlines);
+    obj.insert("planes", board.getPlanes().count());
+    return obj;
+}
+
+static void runBenchmarks(BenchmarkSuite& suite, const FilePath& projectFile,
+                          const SyntheticBoardGenerator::Parameters& parameters)
+{
+    QScopedPointer<Project> project;
+    suite.measure("project.generate", [&]() {
+        SyntheticBoardGenerator generator(parameters);
+        project.reset(generator.generate(projectFile)); // can throw
+    }, [&]() {
+        project.reset();
+        QDir(projectFile.getParentDir().toStr()).removeRecursively();
+    });
+    SyntheticBoardGenerator generator(parameters);
+    project.reset(generator.generate(projectFile)); // can throw
+    Board& board = *project->getBoards().first();
+    suite.setInfo("board", getBoardStatistics(board));
+
+    // planes
+    suite.measure("planes.build_fragments", [&]() {
+        foreach (const BI_Plane* plane, board.getPlanes()) {
+            BoardPlaneFragmentsBuilder builder(*plane);
+            builder.buildFragments();
+        }
+    });
+    suite.measure("planes.rebuild_all", [&]() {
+        board.rebuildAllPlanes();
+    });
+
+    // airwires
+    QList<NetSignal*> netsignals = project->getCircuit().getNetSignals().values();
+    suite.measure("airwires.build", [&]() {
+        foreach (const NetSignal* netsignal, netsignals) {
+            BoardAirWiresBuilder builder(board, *netsignal);
+            builder.buildAirWires();
+        }
+    });
+    QList<QSharedPointer<BoardAirWiresBuilder>> builders;
+    foreach (const NetSignal* netsignal, netsignals) {
+        builders.append(QSharedPointer<BoardAirWiresBuilder>(
+            new BoardAirWiresBuilder(board, *netsignal)));
+        builders.last()->buildAirWires();
+    }
+    suite.measure("airwires.rebuild_unchanged", [&]() {
+        foreach (const QSharedPointer<BoardAirWiresBuilder>& builder, builders) {
+            builder->buildAirWires();
+        }
+    });
+    builders.clear();
+
+    // gerber export
+    suite.measure("gerber.export_all_layers", [&]() {
+        BoardGerberExport exporter(board);
+        exporter.exportAllLayers(); // can throw
+    });
+
+    // design rule check
+    suite.measure("drc.execute", [&]() {
+        BoardDesignRuleCheck drc(board, board.getDesignRules());
+        drc.execute();
+    });
+
+    // save & load
+    suite.measure("project.save", [&]() {
+        project->save(true); // can throw
+    });
+    FilePath boardFile = board.getFilePath();
+    QByteArray boardFileContent = FileUtils::readFile(boardFile); // can throw
+    suite.measure("sexpression.parse_board", [&]() {
+        SExpression::parse(boardFileContent, boardFile); // can throw
+    });
+    SExpression boardDom = SExpression::parse(boardFileContent, boardFile); // can throw
+    suite.measure("sexpression.serialize_board", [&]() {
+        boardDom.toByteArray(); // can throw
+    });
+    project.reset();
+    suite.measure("project.load", [&]() {
+        project.reset(new Project(projectFile, true)); // can throw
+    }, [&]() {
+        project.reset();
+    });
+}
+
+/*****************************************************************************************
+ *  main()
+ ****************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    // many classes rely on a QApplication instance, so we create it here
+    Application app(argc, argv);
+    Application::setOrganizationName("LibrePCB");
+    Application::setOrganizationDomain("librepcb.org");
+    Application::setApplicationName("LibrePCB-Benchmarks");
+
+    // disable the whole debug output (we want only the JSON output)
+    Debug::instance()->setDebugLevelLogFile(Debug::DebugLevel_t::Nothing);
+    Debug::instance()->setDebugLevelStderr(Debug::DebugLevel_t::Nothing);
+
+    // parse command line arguments
+    SyntheticBoardGenerator::Parameters parameters;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the performance of board operations on a "
+                                     "synthetic board and prints the results as JSON.");
+    parser.addHelpOption();
+    QCommandLineOption devicesOption("devices", "Number of devices.", "count",
+                                     QString::number(parameters.devices));
+    QCommandLineOption padsOption("pads-per-device", "Number of pads per device.", "count",
+                                  QString::number(parameters.padsPerDevice));
+    QCommandLineOption netsOption("nets", "Number of net signals.", "count",
+                                  QString::number(parameters.netSignals));
+    QCommandLineOption viasOption("vias-per-net", "Number of vias per net.", "count",
+                                  QString::number(parameters.viasPerNet));
+    QCommandLineOption netlinesOption("netlines-per-net", "Number of net lines per net.",
+                                      "count", QString::number(parameters.netLinesPerNet));
+    QCommandLineOption planesOption("planes", "Number of planes.", "count",
+                                    QString::number(parameters.planes));
+    QCommandLineOption seedOption("seed", "Seed of the random generator.", "seed",
+                                  QString::number(parameters.seed));
+    QCommandLineOption iterationsOption("iterations", "Number of runs per benchmark.",
+                                        "count", "5");
+    QCommandLineOption outputOption("output", "Write JSON to this file instead of stdout.",
+                                    "file");
+    parser.addOptions({devicesOption, padsOption, netsOption, viasOption, netlinesOption,
+                       planesOption, seedOption, iterationsOption, outputOption});
+    parser.process(app);
+    parameters.devices = parser.value(devicesOption).toInt();
+    parameters.padsPerDevice = parser.value(padsOption).toInt();
+    parameters.netSignals = parser.value(netsOption).toInt();
+    parameters.viasPerNet = parser.value(viasOption).toInt();
+    parameters.netLinesPerNet = parser.value(netlinesOption).toInt();
+    parameters.planes = parser.value(planesOption).toInt();
+    parameters.seed = parser.value(seedOption).toUInt();
+
+    BenchmarkSuite suite(parser.value(iterationsOption).toInt());
+    QJsonObject parametersObj;
+    parametersObj.insert("devices", parameters.devices);
+    parametersObj.insert("pads_per_device", parameters.padsPerDevice);
+    parametersObj.insert("nets", parameters.netSignals);
+    parametersObj.insert("vias_per_net", parameters.viasPerNet);
+    parametersObj.insert("netlines_per_net", parameters.netLinesPerNet);
+    parametersObj.insert("planes", parameters.planes);
+    parametersObj.insert("seed", static_cast<qint64>(parameters.seed));
+    suite.setInfo("parameters", parametersObj);
+    suite.setInfo("app_version", qApp->getAppVersion().toStr());
+    suite.setInfo("qt_version", QString(qVersion()));
+
+    // run benchmarks in a temporary directory
+    FilePath tmpDir = FilePath::getRandomTempPath();
+    int exitCode = 0;
+    try {
+        runBenchmarks(suite, tmpDir.getPathTo("benchmark/benchmark.lpp"), parameters);
+    } catch (const Exception& e) {
+        QTextStream(stderr) << "Benchmark failed: " << e.getMsg() << endl;
+        exitCode = 1;
+    }
+    QDir(tmpDir.toStr()).removeRecursively();
+    if (exitCode != 0) {
+        return exitCode;
+    }
+
+    // print results
+    QByteArray json = QJsonDocument(suite.toJson()).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if ((!file.open(QIODevice::WriteOnly)) || (file.write(json) != json.size())) {
+            QTextStream(stderr) << "Failed to write " << file.fileName() << endl;
+            return 1;
+        }
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "syntheticboardgenerator.h"
+#include <librepcb/common/graphics/graphicslayer.h>
+#include <librepcb/common/version.h>
+#include <librepcb/common/uuid.h>
+#include <librepcb/library/cmp/component.h>
+#include <librepcb/library/dev/device.h>
+#include <librepcb/library/pkg/package.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/library/projectlibrary.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/circuit/netclass.h>
+#include <librepcb/project/circuit/netsignal.h>
+#include <librepcb/project/circuit/componentinstance.h>
+#include <librepcb/project/circuit/componentsignalinstance.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardlayerstack.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_netpoint.h>
+#include <librepcb/project/boards/items/bi_netline.h>
+#include <librepcb/project/boards/items/bi_via.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace benchmarks {
+
+using namespace project;
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+SyntheticBoardGenerator::SyntheticBoardGenerator(const Parameters& parameters) noexcept :
+    mParameters(parameters), mRandomGenerator(parameters.seed),
+    // the default board outline of new boards is 160x100mm
+    mAreaTopLeft(Length::fromMm(5), Length::fromMm(95)),
+    mAreaBottomRight(Length::fromMm(155), Length::fromMm(5))
+{
+}
+
+SyntheticBoardGenerator::~SyntheticBoardGenerator() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+Project* SyntheticBoardGenerator::generate(const FilePath& projectFile)
+{
+    QScopedPointer<Project> project(Project::create(projectFile)); // can throw
+    Circuit& circuit = project->getCircuit();
+    Version version("0.1");
+    QString author("LibrePCB Benchmarks");
+
+    // package with a single footprint, pads in two rows
+    QScopedPointer<library::Package> package(new library::Package(Uuid::createRandom(),
+        version, author, "Synthetic Package", QString(), QString()));
+    std::shared_ptr<library::Footprint> footprint = std::make_shared<library::Footprint>(
+        Uuid::createRandom(), "default", QString());
+    QList<Uuid> padUuids;
+    int padsPerRow = (mParameters.padsPerDevice + 1) / 2;
+    for (int i = 0; i < mParameters.padsPerDevice; ++i) {
+        Uuid padUuid = Uuid::createRandom();
+        padUuids.append(padUuid);
+        package->getPads().append(std::make_shared<library::PackagePad>(
+            padUuid, QString::number(i + 1)));
+        Point position(Length::fromMm(1.27) * ((i % padsPerRow) * 2 - padsPerRow + 1) / 2,
+                       Length::fromMm((i < padsPerRow) ? -2 : 2));
+        footprint->getPads().append(std::make_shared<library::FootprintPad>(
+            padUuid, position, Angle::deg0(), library::FootprintPad::Shape::RECT,
+            Length::fromMm(0.7), Length::fromMm(1.5), Length(0),
+            library::FootprintPad::BoardSide::TOP));
+    }
+    package->getFootprints().append(footprint);
+
+    // component with one signal per pad
+    QScopedPointer<library::Component> component(new library::Component(Uuid::createRandom(),
+        version, author, "Synthetic Component", QString(), QString()));
+    QList<Uuid> signalUuids;
+    for (int i = 0; i < mParameters.padsPerDevice; ++i) {
+        Uuid signalUuid = Uuid::createRandom();
+        signalUuids.append(signalUuid);
+        component->getSignals().append(std::make_shared<library::ComponentSignal>(
+            signalUuid, QString("S%1").arg(i + 1)));
+    }
+    Uuid symbolVariantUuid = Uuid::createRandom();
+    component->getSymbolVariants().append(std::make_shared<library::ComponentSymbolVariant>(
+        symbolVariantUuid, QString(), "default", QString()));
+
+    // device connecting the pads with the signals
+    QScopedPointer<library::Device> device(new library::Device(Uuid::createRandom(),
+        version, author, "Synthetic Device", QString(), QString()));
+    device->setComponentUuid(component->getUuid());
+    device->setPackageUuid(package->getUuid());
+    for (int i = 0; i < mParameters.padsPerDevice; ++i) {
+        device->getPadSignalMap().append(std::make_shared<library::DevicePadSignalMapItem>(
+            padUuids.at(i), signalUuids.at(i)));
+    }
+
+    // add library elements to the project (the project library takes the ownership)
+    project->getLibrary().addPackage(*package); // can throw
+    package.take();
+    project->getLibrary().addComponent(*component); // can throw
+    library::Component* libComponent = component.take();
+    project->getLibrary().addDevice(*device); // can throw
+    library::Device* libDevice = device.take();
+
+    // net signals
+    NetClass* netclass = circuit.getNetClasses().first();
+    QList<NetSignal*> netsignals;
+    for (int i = 0; i < mParameters.netSignals; ++i) {
+        QScopedPointer<NetSignal> netsignal(
+            new NetSignal(circuit, *netclass, QString("N%1").arg(i + 1), false));
+        circuit.addNetSignal(*netsignal); // can throw
+        netsignals.append(netsignal.take());
+    }
+
+    // board
+    Board* board = project->createBoard("Benchmark"); // can throw
+    project->addBoard(*board); // can throw
+    GraphicsLayer* topCopper = board->getLayerStack().getLayer(GraphicsLayer::sTopCopper);
+    Q_ASSERT(topCopper);
+
+    // devices on a grid, randomly rotated
+    int columns = qMax(1, qCeil(qSqrt(mParameters.devices * 1.5)));
+    int rows = qMax(1, (mParameters.devices + columns - 1) / columns);
+    Length columnWidth = (mAreaBottomRight.getX() - mAreaTopLeft.getX()) / columns;
+    Length rowHeight = (mAreaTopLeft.getY() - mAreaBottomRight.getY()) / rows;
+    for (int i = 0; i < mParameters.devices; ++i) {
+        QScopedPointer<ComponentInstance> cmpInstance(new ComponentInstance(circuit,
+            *libComponent, symbolVariantUuid, QString("U%1").arg(i + 1),
+            libDevice->getUuid())); // can throw
+        circuit.addComponentInstance(*cmpInstance); // can throw
+        ComponentInstance* cmp = cmpInstance.take();
+        if (!netsignals.isEmpty()) {
+            foreach (const Uuid& signalUuid, signalUuids) {
+                NetSignal* netsignal = netsignals.at(getRandomInt(netsignals.count()));
+                cmp->getSignalInstance(signalUuid)->setNetSignal(netsignal); // can throw
+            }
+        }
+        Point position(mAreaTopLeft.getX() + columnWidth * (i % columns) + columnWidth / 2,
+                       mAreaTopLeft.getY() - rowHeight * (i / columns) - rowHeight / 2);
+        Angle rotation = Angle::deg90() * getRandomInt(4);
+        QScopedPointer<BI_Device> deviceInstance(new BI_Device(*board, *cmp,
+            libDevice->getUuid(), footprint->getUuid(), position, rotation, false)); // can throw
+        board->addDeviceInstance(*deviceInstance); // can throw
+        deviceInstance.take();
+    }
+
+    // net segments with vias and a random walk trace
+    foreach (NetSignal* netsignal, netsignals) {
+        QScopedPointer<BI_NetSegment> netsegment(new BI_NetSegment(*board, *netsignal));
+        board->addNetSegment(*netsegment); // can throw
+        BI_NetSegment* segment = netsegment.take();
+        QList<BI_Via*> vias;
+        QList<BI_NetPoint*> netpoints;
+        QList<BI_NetLine*> netlines;
+        for (int i = 0; i < mParameters.viasPerNet; ++i) {
+            vias.append(new BI_Via(*segment, getRandomPosition(), BI_Via::Shape::Round,
+                                   Length::fromMm(0.7), Length::fromMm(0.3))); // can throw
+        }
+        if (mParameters.netLinesPerNet > 0) {
+            if (!vias.isEmpty()) {
+                netpoints.append(new BI_NetPoint(*segment, *topCopper, *vias.first()));
+            } else {
+                netpoints.append(new BI_NetPoint(*segment, *topCopper, getRandomPosition()));
+            }
+            for (int i = 0; i < mParameters.netLinesPerNet; ++i) {
+                Point step(Length::fromMm(getRandomInt(21) - 10),
+                           Length::fromMm(getRandomInt(21) - 10));
+                Point position = netpoints.last()->getPosition() + step;
+                position.setX(qBound(mAreaTopLeft.getX(), position.getX(), mAreaBottomRight.getX()));
+                position.setY(qBound(mAreaBottomRight.getY(), position.getY(), mAreaTopLeft.getY()));
+                netpoints.append(new BI_NetPoint(*segment, *topCopper, position));
+                netlines.append(new BI_NetLine(*netpoints.at(i), *netpoints.at(i + 1),
+                                               Length::fromMm(0.25)));
+            }
+        }
+        segment->addElements(vias, netpoints, netlines); // can throw
+    }
+
+    // planes covering the whole board
+    for (int i = 0; (i < mParameters.planes) && (!netsignals.isEmpty()); ++i) {
+        QString layerName = (i % 2) ? GraphicsLayer::sTopCopper : GraphicsLayer::sBotCopper;
+        QScopedPointer<BI_Plane> plane(new BI_Plane(*board, Uuid::createRandom(), layerName,
+            *netsignals.at(i % netsignals.count()),
+            Path::rect(mAreaTopLeft, mAreaBottomRight))); // can throw
+        board->addPlane(*plane); // can throw
+        plane.take();
+    }
+
+    return project.take();
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+Point SyntheticBoardGenerator::getRandomPosition() noexcept
+{
+    // random position on a 0.1mm grid
+    int columns = (mAreaBottomRight.getX() - mAreaTopLeft.getX()).toNm() / 100000;
+    int rows = (mAreaTopLeft.getY() - mAreaBottomRight.getY()).toNm() / 100000;
+    return Point(mAreaTopLeft.getX() + Length(100000) * getRandomInt(columns + 1),
+                 mAreaBottomRight.getY() + Length(100000) * getRandomInt(rows + 1));
+}
+
+int SyntheticBoardGenerator::getRandomInt(int max) noexcept
+{
+    // Note: std::uniform_int_distribution is implementation defined, so don't use it
+    return static_cast<int>(mRandomGenerator() % static_cast<quint32>(max));
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace benchmarks
+} // namespace librepcb
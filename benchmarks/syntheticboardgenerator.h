@@ -0,0 +1,122 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_BENCHMARKS_SYNTHETICBOARDGENERATOR_H
+#define LIBREPCB_BENCHMARKS_SYNTHETICBOARDGENERATOR_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <random>
+#include <librepcb/common/fileio/filepath.h>
+#include <librepcb/common/units/all_length_units.h>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+namespace project {
+class Project;
+class Board;
+}
+
+namespace benchmarks {
+
+/*****************************************************************************************
+ *  Class SyntheticBoardGenerator
+ ****************************************************************************************/
+
+/**
+ * @brief The SyntheticBoardGenerator class creates a new project with a generated board
+ *
+ * The project contains one package/component/device (with #Parameters::padsPerDevice
+ * SMT pads) in its library, a number of net signals, and a board with:
+ *  - #Parameters::devices devices placed on a grid, every pad connected to a random net
+ *  - for every net one net segment with #Parameters::viasPerNet vias and a trace of
+ *    #Parameters::netLinesPerNet net lines (the first one starting at a via)
+ *  - #Parameters::planes planes covering the whole board, alternating between the top
+ *    and bottom copper layer
+ *
+ * All random decisions are made with a fixed-algorithm random generator initialized with
+ * #Parameters::seed, so the same parameters always lead to the same board geometry
+ * (only UUIDs are different), on every platform.
+ *
+ * Everything is created through the regular project/board API, i.e. the board is
+ * equivalent to a board created with the editor.
+ */
+class SyntheticBoardGenerator final
+{
+    public:
+
+        // Types
+        struct Parameters {
+            int devices = 100;
+            int padsPerDevice = 8;
+            int netSignals = 50;
+            int viasPerNet = 4;
+            int netLinesPerNet = 10;
+            int planes = 2;
+            quint32 seed = 42;
+        };
+
+        // Constructors / Destructor
+        SyntheticBoardGenerator() = delete;
+        SyntheticBoardGenerator(const SyntheticBoardGenerator& other) = delete;
+        explicit SyntheticBoardGenerator(const Parameters& parameters) noexcept;
+        ~SyntheticBoardGenerator() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Create a new project containing the generated board
+         *
+         * @param projectFile   The project file to create (the directory must not exist)
+         *
+         * @return The new project (not yet saved, the caller takes the ownership)
+         *
+         * @throw Exception on errors
+         */
+        project::Project* generate(const FilePath& projectFile);
+
+        // Operator Overloadings
+        SyntheticBoardGenerator& operator=(const SyntheticBoardGenerator& rhs) = delete;
+
+
+    private: // Methods
+        Point getRandomPosition() noexcept;
+        int getRandomInt(int max) noexcept;
+
+
+    private: // Data
+        Parameters mParameters;
+        std::mt19937 mRandomGenerator;
+        Point mAreaTopLeft;         ///< area where items are placed (inside board outline)
+        Point mAreaBottomRight;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace benchmarks
+} // namespace librepcb
+
+#endif // LIBREPCB_BENCHMARKS_SYNTHETICBOARDGENERATOR_H
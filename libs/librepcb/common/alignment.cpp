@@ -123,8 +123,8 @@ Alignment::Alignment(const SExpression& node)
         mH = node.getChildByIndex(0).getValue<HAlign>(true);
         mV = node.getChildByIndex(1).getValue<VAlign>(true);
     } catch (const Exception& e) {
-        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), -1, -1,
-                             QString(), e.getMsg());
+        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), node.getFileLine(),
+                             node.getFileColumn(), QString(), e.getMsg());
     }
 }
 
@@ -90,6 +90,19 @@ BoardDesignRules::BoardDesignRules(const SExpression& node) :
     if (const SExpression* e = node.tryGetChildByPath("restring_via_max")) {
         mRestringViaMax = e->getValueOfFirstChild<Length>(true);
     }
+    // design rule check
+    if (const SExpression* e = node.tryGetChildByPath("min_copper_clearance")) {
+        mMinCopperClearance = e->getValueOfFirstChild<Length>(true);
+    }
+    if (const SExpression* e = node.tryGetChildByPath("min_copper_width")) {
+        mMinCopperWidth = e->getValueOfFirstChild<Length>(true);
+    }
+    if (const SExpression* e = node.tryGetChildByPath("min_annular_ring")) {
+        mMinAnnularRing = e->getValueOfFirstChild<Length>(true);
+    }
+    if (const SExpression* e = node.tryGetChildByPath("min_drill_copper_clearance")) {
+        mMinDrillCopperClearance = e->getValueOfFirstChild<Length>(true);
+    }
 }
 
 BoardDesignRules::~BoardDesignRules() noexcept
@@ -121,6 +134,11 @@ void BoardDesignRules::restoreDefaults() noexcept
     mRestringViaRatio = Ratio(250000);              // 25%
     mRestringViaMin = Length(200000);               // 0.2mm
     mRestringViaMax = Length(2000000);              // 2.0mm
+    // design rule check
+    mMinCopperClearance = Length(200000);           // 0.2mm
+    mMinCopperWidth = Length(150000);               // 0.15mm
+    mMinAnnularRing = Length(150000);               // 0.15mm
+    mMinDrillCopperClearance = Length(250000);      // 0.25mm
 }
 
 void BoardDesignRules::serialize(SExpression& root) const
@@ -146,6 +164,11 @@ void BoardDesignRules::serialize(SExpression& root) const
     root.appendTokenChild("restring_via_ratio",                  mRestringViaRatio, true);
     root.appendTokenChild("restring_via_min",                    mRestringViaMin, true);
     root.appendTokenChild("restring_via_max",                    mRestringViaMax, true);
+    // design rule check
+    root.appendTokenChild("min_copper_clearance",                mMinCopperClearance, true);
+    root.appendTokenChild("min_copper_width",                    mMinCopperWidth, true);
+    root.appendTokenChild("min_annular_ring",                    mMinAnnularRing, true);
+    root.appendTokenChild("min_drill_copper_clearance",          mMinDrillCopperClearance, true);
 }
 
 /*****************************************************************************************
@@ -210,6 +233,11 @@ BoardDesignRules& BoardDesignRules::operator=(const BoardDesignRules& rhs) noexc
     mRestringViaRatio               = rhs.mRestringViaRatio;
     mRestringViaMin                 = rhs.mRestringViaMin;
     mRestringViaMax                 = rhs.mRestringViaMax;
+    // design rule check
+    mMinCopperClearance             = rhs.mMinCopperClearance;
+    mMinCopperWidth                 = rhs.mMinCopperWidth;
+    mMinAnnularRing                 = rhs.mMinAnnularRing;
+    mMinDrillCopperClearance        = rhs.mMinDrillCopperClearance;
     return *this;
 }
 
@@ -237,6 +265,11 @@ bool BoardDesignRules::checkAttributesValidity() const noexcept
     if (mRestringViaRatio < 0)                              return false;
     if (mRestringViaMin < 0)                                return false;
     if (mRestringViaMax < mRestringViaMin)                  return false;
+    // design rule check
+    if (mMinCopperClearance < 0)                            return false;
+    if (mMinCopperWidth < 0)                                return false;
+    if (mMinAnnularRing < 0)                                return false;
+    if (mMinDrillCopperClearance < 0)                       return false;
     return true;
 }
 
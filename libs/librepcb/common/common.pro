@@ -56,10 +56,13 @@ SOURCES += \
     dialogs/stroketextpropertiesdialog.cpp \
     dialogs/textpropertiesdialog.cpp \
     exceptions.cpp \
+    fileio/asyncfilewriter.cpp \
     fileio/directorylock.cpp \
     fileio/filepath.cpp \
     fileio/fileutils.cpp \
     fileio/sexpression.cpp \
+    fileio/sexpressioncache.cpp \
+    fileio/sexpressionparser.cpp \
     fileio/smartfile.cpp \
     fileio/smartsexprfile.cpp \
     fileio/smarttextfile.cpp \
@@ -74,6 +77,7 @@ SOURCES += \
     geometry/ellipse.cpp \
     geometry/hole.cpp \
     geometry/path.cpp \
+    geometry/pointinpolygonindex.cpp \
     geometry/polygon.cpp \
     geometry/stroketext.cpp \
     geometry/text.cpp \
@@ -102,6 +106,7 @@ SOURCES += \
     sqlitedatabase.cpp \
     systeminfo.cpp \
     toolbox.cpp \
+    tracer.cpp \
     undocommand.cpp \
     undocommandgroup.cpp \
     undostack.cpp \
@@ -154,6 +159,7 @@ HEADERS += \
     dialogs/stroketextpropertiesdialog.h \
     dialogs/textpropertiesdialog.h \
     exceptions.h \
+    fileio/asyncfilewriter.h \
     fileio/cmd/cmdlistelementinsert.h \
     fileio/cmd/cmdlistelementremove.h \
     fileio/cmd/cmdlistelementsswap.h \
@@ -164,6 +170,8 @@ HEADERS += \
     fileio/serializableobject.h \
     fileio/serializableobjectlist.h \
     fileio/sexpression.h \
+    fileio/sexpressioncache.h \
+    fileio/sexpressionparser.h \
     fileio/smartfile.h \
     fileio/smartsexprfile.h \
     fileio/smarttextfile.h \
@@ -178,6 +186,7 @@ HEADERS += \
     geometry/ellipse.h \
     geometry/hole.h \
     geometry/path.h \
+    geometry/pointinpolygonindex.h \
     geometry/polygon.h \
     geometry/stroketext.h \
     geometry/text.h \
@@ -209,6 +218,7 @@ HEADERS += \
     sqlitedatabase.h \
     systeminfo.h \
     toolbox.h \
+    tracer.h \
     undocommand.h \
     undocommandgroup.h \
     undostack.h \
@@ -221,6 +231,7 @@ HEADERS += \
     utils/clipperhelpers.h \
     utils/exclusiveactiongroup.h \
     utils/graphicslayerstackappearancesettings.h \
+    utils/rtree.h \
     utils/toolbarproxy.h \
     utils/undostackactiongroup.h \
     uuid.h \
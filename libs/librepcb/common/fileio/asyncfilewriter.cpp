@@ -0,0 +1,116 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtConcurrent/QtConcurrent>
+#include "asyncfilewriter.h"
+#include "fileutils.h"
+#include "smartsexprfile.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+AsyncFileWriter::AsyncFileWriter(QObject* parent) noexcept :
+    QObject(parent), mIsFinishedPending(false)
+{
+    connect(&mFutureWatcher, &QFutureWatcher<QStringList>::finished,
+            this, &AsyncFileWriter::emitFinished);
+}
+
+AsyncFileWriter::~AsyncFileWriter() noexcept
+{
+    waitForFinished();
+    if (mIsFinishedPending) {
+        foreach (const QString& error, mFuture.result()) {
+            qWarning() << "Failed to write file:" << error;
+        }
+    }
+    if (!mPendingFiles.isEmpty()) {
+        qWarning() << "Files added to AsyncFileWriter but never written:"
+                   << mPendingFiles.count();
+    }
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+void AsyncFileWriter::addFile(const FilePath& filepath,
+                              const SExpression& domDocument) noexcept
+{
+    mPendingFiles.append(File{filepath, domDocument});
+}
+
+void AsyncFileWriter::start() noexcept
+{
+    waitForFinished();
+    emitFinished(); // the watcher would not report it anymore after setting a new future
+    QList<File> files = mPendingFiles;
+    mPendingFiles.clear();
+    mFuture = QtConcurrent::run([files]() {return writeFiles(files);});
+    mIsFinishedPending = true;
+    mFutureWatcher.setFuture(mFuture);
+}
+
+void AsyncFileWriter::waitForFinished() noexcept
+{
+    mFuture.waitForFinished();
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+void AsyncFileWriter::emitFinished() noexcept
+{
+    if (mIsFinishedPending) {
+        mIsFinishedPending = false;
+        emit finished(mFuture.result());
+    }
+}
+
+QStringList AsyncFileWriter::writeFiles(const QList<File>& files) noexcept
+{
+    QStringList errors;
+    foreach (const File& file, files) {
+        try {
+            FileUtils::writeFileIfModified(file.filepath,
+                SmartSExprFile::serialize(file.domDocument)); // can throw
+        } catch (const Exception& e) {
+            errors.append(e.getMsg());
+        }
+    }
+    return errors;
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
@@ -0,0 +1,125 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBREPCB_ASYNCFILEWRITER_H
+#define LIBREPCB_ASYNCFILEWRITER_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "filepath.h"
+#include "sexpression.h"
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class AsyncFileWriter
+ ****************************************************************************************/
+
+/**
+ * @brief The AsyncFileWriter class writes S-Expression files in a worker thread
+ *
+ * Used to save files without blocking the GUI thread: the DOM trees are created (i.e.
+ * snapshotted) in the GUI thread and added with #addFile(). As librepcb::SExpression is
+ * implicitly shared, this is cheap and the objects can be modified immediately
+ * afterwards. #start() then formats and writes all added files in the order they were
+ * added in a worker thread (with librepcb::FileUtils::writeFile(), i.e. synced to disk
+ * and atomically replaced). Files whose content did not change are not touched. When
+ * done, #finished() is emitted in the thread of this object with all errors which
+ * occurred.
+ *
+ * Only one batch of files is written at the same time. The destructor waits until all
+ * files are written.
+ */
+class AsyncFileWriter final : public QObject
+{
+        Q_OBJECT
+
+    public:
+
+        // Constructors / Destructor
+        AsyncFileWriter(const AsyncFileWriter& other) = delete;
+        explicit AsyncFileWriter(QObject* parent = nullptr) noexcept;
+        ~AsyncFileWriter() noexcept;
+
+        // Getters
+        bool isBusy() const noexcept {return mFuture.isRunning();}
+
+        // General Methods
+        void addFile(const FilePath& filepath, const SExpression& domDocument) noexcept;
+
+        /**
+         * @brief Start writing all added files in a worker thread
+         *
+         * If the previous batch is not finished yet, this method blocks until it is.
+         * The #finished() signal of the previous batch is emitted before the new batch
+         * is started (if it was not emitted yet).
+         */
+        void start() noexcept;
+
+        /**
+         * @brief Block until all files of the current batch are written
+         */
+        void waitForFinished() noexcept;
+
+        // Operator Overloadings
+        AsyncFileWriter& operator=(const AsyncFileWriter& rhs) = delete;
+
+
+    signals:
+
+        /**
+         * @brief A batch of files was written
+         *
+         * @param errors    The messages of all errors (empty on success)
+         */
+        void finished(const QStringList& errors);
+
+
+    private: // Types
+        struct File {
+            FilePath filepath;
+            SExpression domDocument;
+        };
+
+
+    private: // Methods
+        void emitFinished() noexcept;
+        static QStringList writeFiles(const QList<File>& files) noexcept;
+
+
+    private: // Data
+        QList<File> mPendingFiles; ///< added, but not yet started
+        QFuture<QStringList> mFuture;
+        QFutureWatcher<QStringList> mFutureWatcher;
+        bool mIsFinishedPending; ///< whether #finished() was not yet emitted for #mFuture
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_ASYNCFILEWRITER_H
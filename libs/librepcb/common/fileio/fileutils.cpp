@@ -70,6 +70,22 @@ void FileUtils::writeFile(const FilePath& filepath, const QByteArray& content)
     }
 }
 
+bool FileUtils::writeFileIfModified(const FilePath& filepath, const QByteArray& content)
+{
+    QFileInfo info(filepath.toStr());
+    if (info.isFile() && (info.size() == content.size())) {
+        try {
+            if (readFile(filepath) == content) {
+                return false; // file is already up to date, do not touch it
+            }
+        } catch (const Exception& e) {
+            qWarning() << "Could not read file to check for modifications:" << e.getMsg();
+        }
+    }
+    writeFile(filepath, content); // can throw
+    return true;
+}
+
 void FileUtils::copyFile(const FilePath& source, const FilePath& dest)
 {
     if (!source.isExistingFile()) {
@@ -79,6 +79,26 @@ class FileUtils final
          */
         static void writeFile(const FilePath& filepath, const QByteArray& content);
 
+        /**
+         * @brief Write the content of a QByteArray into a file, but only if it differs
+         *        from the current content of the file
+         *
+         * The existing file is compared with the new content byte by byte (only if the
+         * size is equal), so modifications by other applications are always detected,
+         * independent of the resolution of file modification times. Files whose content
+         * did not change are not touched at all, which avoids needless I/O and keeps
+         * their modification time stable (e.g. for version control systems).
+         *
+         * @param filepath      The file to (over)write
+         * @param content       The content to write
+         *
+         * @retval true         If the file was written
+         * @retval false        If the file was already up to date
+         *
+         * @throws Exception    If an error occurs.
+         */
+        static bool writeFileIfModified(const FilePath& filepath, const QByteArray& content);
+
         /**
          * @brief Copy a single file
          *
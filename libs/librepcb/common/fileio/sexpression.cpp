@@ -21,7 +21,10 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <algorithm>
 #include "sexpression.h"
+#include "sexpressionparser.h"
+#include "../tracer.h"
 #include <sexpresso/sexpresso.hpp>
 
 /*****************************************************************************************
@@ -34,54 +37,55 @@ namespace librepcb {
  ****************************************************************************************/
 
 SExpression::SExpression() noexcept :
-    mType(Type::String)
+    mType(Type::String), mFileOffset(-1)
 {
 }
 
 SExpression::SExpression(Type type, const QString& value) :
-    mType(type), mValue(value)
+    mType(type), mFileOffset(-1), mValue(value)
 {
 }
 
 SExpression::SExpression(const SExpression& other) noexcept :
-    mType(other.mType), mValue(other.mValue), mChildren(other.mChildren),
-    mFilePath(other.mFilePath)
+    mType(other.mType), mFileOffset(other.mFileOffset), mValue(other.mValue),
+    mChildren(other.mChildren), mSource(other.mSource)
 {
 }
 
-SExpression::SExpression(sexpresso::Sexp& sexp, const FilePath& filePath) :
-    mType(Type::List), mValue(), mFilePath(filePath)
+SExpression::~SExpression() noexcept
 {
-    if (sexp.childCount() < 1) {
-        throw RuntimeError(__FILE__, __LINE__);
-    }
+}
 
-    if (sexp.isSexp()) {
-        sexpresso::Sexp& first = sexp.getChild(0);
-        if (!first.isString()) {
-            throw RuntimeError(__FILE__, __LINE__);
-        }
-        mValue = QString::fromStdString(first.getString());
-        for(auto&& arg : sexp.arguments()) {
-            mChildren.append(SExpression(arg, filePath));
-        }
-    } else if (sexp.isString()) {
-        mValue = QString::fromStdString(sexp.getString());
-        mType = Type::String;
+/*****************************************************************************************
+ *  Getters
+ ****************************************************************************************/
+
+const FilePath& SExpression::getFilePath() const noexcept
+{
+    static const FilePath invalidFilePath;
+    return mSource ? mSource->filePath : invalidFilePath;
+}
+
+int SExpression::getFileLine() const noexcept
+{
+    if (mSource && (mFileOffset >= 0)) {
+        const QVector<int>& offsets = mSource->lineOffsets;
+        return std::upper_bound(offsets.begin(), offsets.end(), mFileOffset) - offsets.begin();
     } else {
-        throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
-                             tr("Unknown node type."));
+        return -1;
     }
 }
 
-SExpression::~SExpression() noexcept
+int SExpression::getFileColumn() const noexcept
 {
+    int line = getFileLine();
+    if (line > 0) {
+        return mFileOffset - mSource->lineOffsets.at(line - 1) + 1;
+    } else {
+        return -1;
+    }
 }
 
-/*****************************************************************************************
- *  Getters
- ****************************************************************************************/
-
 bool SExpression::isMultiLineList() const noexcept
 {
     foreach (const SExpression& child, mChildren) {
@@ -97,7 +101,8 @@ const QString& SExpression::getName() const
     if (isList()) {
         return mValue;
     } else {
-        throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+        throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                             getFileColumn(), QString(),
                              tr("Node is not a list."));
     }
 }
@@ -116,7 +121,8 @@ QList<SExpression> SExpression::getChildren(const QString& name) const noexcept
 const SExpression& SExpression::getChildByIndex(int index) const
 {
     if ((index < 0) || index >= mChildren.count()) {
-        throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+        throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                             getFileColumn(), QString(),
                              QString(tr("Child not found: %1")).arg(index));
     }
     return mChildren.at(index);
@@ -125,19 +131,30 @@ const SExpression& SExpression::getChildByIndex(int index) const
 const SExpression* SExpression::tryGetChildByPath(const QString& path) const noexcept
 {
     const SExpression* child = this;
-    foreach (const QString& name, path.split('/')) {
-        bool found = false;
-        foreach (const SExpression& childchild, child->mChildren) {
-            if (childchild.isList() && (childchild.mValue == name)) {
-                child = &childchild;
-                found = true;
-            }
+    int begin = 0;
+    while (child) {
+        int end = path.indexOf('/', begin);
+        if (end < 0) {
+            return child->tryGetLastChild(path.midRef(begin));
         }
-        if (!found) {
-            return nullptr;
+        child = child->tryGetLastChild(path.midRef(begin, end - begin));
+        begin = end + 1;
+    }
+    return nullptr;
+}
+
+const SExpression* SExpression::tryGetChildByPath(const char* path) const noexcept
+{
+    const SExpression* child = this;
+    while (child) {
+        const char* end = strchr(path, '/');
+        if (!end) {
+            return child->tryGetLastChild(QLatin1String(path));
         }
+        child = child->tryGetLastChild(QLatin1String(path, end - path));
+        path = end + 1;
     }
-    return child;
+    return nullptr;
 }
 
 const SExpression& SExpression::getChildByPath(const QString& path) const
@@ -146,11 +163,24 @@ const SExpression& SExpression::getChildByPath(const QString& path) const
     if (child) {
         return *child;
     } else {
-        throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+        throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                             getFileColumn(), QString(),
                              QString(tr("Child not found: %1")).arg(path));
     }
 }
 
+const SExpression& SExpression::getChildByPath(const char* path) const
+{
+    const SExpression* child = tryGetChildByPath(path);
+    if (child) {
+        return *child;
+    } else {
+        throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                             getFileColumn(), QString(),
+                             QString(tr("Child not found: %1")).arg(QLatin1String(path)));
+    }
+}
+
 /*****************************************************************************************
  *  General Methods
  ****************************************************************************************/
@@ -187,80 +217,179 @@ void SExpression::removeLineBreaks() noexcept
 }
 
 QString SExpression::toString(int indent) const
+{
+    QByteArray output;
+    serialize(output, indent); // can throw
+    return QString::fromUtf8(output);
+}
+
+QByteArray SExpression::toByteArray() const
+{
+    QByteArray output;
+    output.reserve(4096);
+    serialize(output, 0); // can throw
+    return output;
+}
+
+/*****************************************************************************************
+ *  Operator Overloadings
+ ****************************************************************************************/
+
+SExpression& SExpression::operator=(const SExpression& rhs) noexcept
+{
+    mType = rhs.mType;
+    mFileOffset = rhs.mFileOffset;
+    mValue = rhs.mValue;
+    mChildren = rhs.mChildren;
+    mSource = rhs.mSource;
+    return *this;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+template <typename NameType>
+const SExpression* SExpression::tryGetLastChild(const NameType& name) const noexcept
+{
+    // search backwards since the last list with the given name has to be returned
+    for (int i = mChildren.count() - 1; i >= 0; --i) {
+        const SExpression& child = mChildren.at(i);
+        if ((child.mType == Type::List) && (child.mValue == name)) {
+            return &child;
+        }
+    }
+    return nullptr;
+}
+
+bool SExpression::serialize(QByteArray& output, int indent) const
 {
     if (mType == Type::List) {
         if (!isValidListName(mValue)) {
             throw LogicError(__FILE__, __LINE__,
                 QString(tr("Invalid S-Expression list name: %1")).arg(mValue));
         }
-        QString str = '(' + mValue;
+        bool isMultiLine = false;
+        output.append('(');
+        appendAscii(output, mValue);
         for (int i = 0; i < mChildren.count(); ++i) {
             const SExpression& child = mChildren.at(i);
-            if ((!str.at(str.length()-1).isSpace()) && (!child.isLineBreak())) {
-                str += ' ';
+            if ((!isSpace(output.at(output.length() - 1))) && (!child.isLineBreak())) {
+                output.append(' ');
             }
             bool nextChildIsLineBreak = (i < mChildren.count() - 1)
                                         ? mChildren.at(i + 1).isLineBreak()
                                         : true;
             if (child.isLineBreak() && nextChildIsLineBreak) {
-                if (child.isLineBreak() && (i > 0) && mChildren.at(i - 1).isLineBreak()) {
+                if ((i > 0) && mChildren.at(i - 1).isLineBreak()) {
                     // too many line breaks ;)
                 } else {
-                    str += '\n';
+                    output.append('\n');
                 }
-            } else {
-                str += child.toString(indent + 1);
+                isMultiLine = true;
+            } else if (child.serialize(output, indent + 1)) { // can throw
+                isMultiLine = true;
             }
         }
-        if (isMultiLineList()) {
-            str += '\n' + QString(' ').repeated(indent);
+        if (isMultiLine) {
+            output.append('\n');
+            appendIndent(output, indent);
         }
-        return str + ')';
+        output.append(')');
+        return isMultiLine;
     } else if (mType == Type::Token) {
         if (!isValidToken(mValue)) {
             throw LogicError(__FILE__, __LINE__,
                 QString(tr("Invalid S-Expression token: %1")).arg(mValue));
         }
-        return mValue;
+        appendAscii(output, mValue);
+        return false;
     } else if (mType == Type::String) {
-        return '"' + escapeString(mValue) + '"';
+        output.append('"');
+        appendEscapedString(output, mValue);
+        output.append('"');
+        return false;
     } else if (mType == Type::LineBreak) {
-        return '\n' + QString(' ').repeated(indent);
+        output.append('\n');
+        appendIndent(output, indent);
+        return true;
     } else {
         throw LogicError(__FILE__, __LINE__);
     }
 }
 
-/*****************************************************************************************
- *  Operator Overloadings
- ****************************************************************************************/
+bool SExpression::isValidListName(const QString& name) noexcept
+{
+    // equivalent to the regex "[a-z][a-z0-9_]*", but much faster
+    if (name.isEmpty()) {
+        return false;
+    }
+    for (int i = 0; i < name.length(); ++i) {
+        ushort c = name.at(i).unicode();
+        bool valid = ((c >= 'a') && (c <= 'z'))
+                  || ((i > 0) && (((c >= '0') && (c <= '9')) || (c == '_')));
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
 
-SExpression& SExpression::operator=(const SExpression& rhs) noexcept
+bool SExpression::isValidToken(const QString& token) noexcept
 {
-    mType = rhs.mType;
-    mValue = rhs.mValue;
-    mChildren = rhs.mChildren;
-    mFilePath = rhs.mFilePath;
-    return *this;
+    // equivalent to the regex "[a-zA-Z0-9\\.:_-]+", but much faster
+    if (token.isEmpty()) {
+        return false;
+    }
+    foreach (const QChar& qc, token) {
+        ushort c = qc.unicode();
+        bool valid = ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'))
+                  || ((c >= '0') && (c <= '9')) || (c == '.') || (c == ':') || (c == '_')
+                  || (c == '-');
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
 }
 
-/*****************************************************************************************
- *  Private Methods
- ****************************************************************************************/
+bool SExpression::isSpace(char c) noexcept
+{
+    // list names and tokens are ASCII and strings end with a quote, so only ASCII
+    // whitespace from line breaks can appear at the end of the output
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f')
+        || (c == '\v');
+}
 
-QString SExpression::escapeString(const QString& string) const noexcept
+void SExpression::appendAscii(QByteArray& output, const QString& str) noexcept
 {
-    return QString::fromStdString(sexpresso::escape(string.toStdString()));
+    // only used for validated list names and tokens, which contain only ASCII characters
+    foreach (const QChar& c, str) {
+        output.append(static_cast<char>(c.unicode()));
+    }
 }
 
-bool SExpression::isValidListName(const QString& name) const noexcept
+void SExpression::appendIndent(QByteArray& output, int indent) noexcept
 {
-    return QRegExp("[a-z][a-z0-9_]*").exactMatch(name);
+    for (int i = 0; i < indent; ++i) {
+        output.append(' ');
+    }
 }
 
-bool SExpression::isValidToken(const QString& token) const noexcept
+void SExpression::appendEscapedString(QByteArray& output, const QString& str) noexcept
 {
-    return QRegExp("[a-zA-Z0-9\\.:_-]+").exactMatch(token);
+    // Fast path for the most common case: printable ASCII characters which are never
+    // escaped. Everything else is escaped by sexpresso to keep the output unchanged.
+    foreach (const QChar& qc, str) {
+        ushort c = qc.unicode();
+        if ((c < 0x20) || (c > 0x7E) || (c == '"') || (c == '\\') || (c == '\'')
+            || (c == '?')) {
+            std::string escaped = sexpresso::escape(str.toStdString());
+            output.append(escaped.data(), static_cast<int>(escaped.size()));
+            return;
+        }
+    }
+    appendAscii(output, str);
 }
 
 /*****************************************************************************************
@@ -289,19 +418,24 @@ SExpression SExpression::createLineBreak()
 
 SExpression SExpression::parse(const QString& str, const FilePath& filePath)
 {
-    std::string error;
-    sexpresso::Sexp tree = sexpresso::parse(str.toStdString(), error);
-    if (error.empty()) {
-        if (tree.childCount() == 1) {
-            return SExpression(tree.getChild(0), filePath);
-        } else {
-            throw FileParseError(__FILE__, __LINE__, filePath, -1, -1, QString(),
-                                 tr("File does not have exactly one root node."));
-        }
-    } else {
-        throw FileParseError(__FILE__, __LINE__, filePath, -1, -1, QString(),
-                             QString::fromStdString(error));
-    }
+    return parse(str.toUtf8(), filePath);
+}
+
+SExpression SExpression::parse(const QByteArray& content, const FilePath& filePath)
+{
+    TraceSpan span("SExpression::parse", filePath);
+    SExpressionParser parser(content, filePath);
+    return parser.parse(); // can throw
+}
+
+SExpression SExpression::parsePartially(const QByteArray& content,
+                                        const FilePath& filePath,
+                                        const QSet<QString>& rootChildNames)
+{
+    TraceSpan span("SExpression::parsePartially", filePath);
+    SExpressionParser parser(content, filePath);
+    parser.setRootChildrenFilter(rootChildNames);
+    return parser.parse(); // can throw
 }
 
 /*****************************************************************************************
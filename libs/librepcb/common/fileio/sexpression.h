@@ -31,10 +31,6 @@
 /*****************************************************************************************
  *  Namespace / Forward Declarations
  ****************************************************************************************/
-namespace sexpresso {
-struct Sexp;
-}
-
 namespace librepcb {
 
 /*****************************************************************************************
@@ -67,7 +63,9 @@ class SExpression final
         ~SExpression() noexcept;
 
         // Getters
-        const FilePath& getFilePath() const noexcept {return mFilePath;}
+        const FilePath& getFilePath() const noexcept;
+        int getFileLine() const noexcept;
+        int getFileColumn() const noexcept;
         Type getType() const noexcept {return mType;}
         bool isList() const noexcept {return mType == Type::List;}
         bool isToken() const noexcept {return mType == Type::Token;}
@@ -78,8 +76,23 @@ class SExpression final
         const QList<SExpression>& getChildren() const {return mChildren;}
         QList<SExpression> getChildren(const QString& name) const noexcept;
         const SExpression& getChildByIndex(int index) const;
+
+        /**
+         * @brief Get a child list by its path (e.g. "pos" or "design_rules/stopmask")
+         *
+         * If there are multiple lists with the same name, the last one is returned. The
+         * lookup does not allocate any memory. The `const char*` overloads are used for
+         * string literals and avoid creating a temporary QString of the path (only ASCII
+         * paths are supported).
+         *
+         * @param path  The names of the lists, separated by '/'
+         *
+         * @return The child or nullptr if not found
+         */
         const SExpression* tryGetChildByPath(const QString& path) const noexcept;
+        const SExpression* tryGetChildByPath(const char* path) const noexcept;
         const SExpression& getChildByPath(const QString& path) const;
+        const SExpression& getChildByPath(const char* path) const;
 
         template <typename T>
         T getValue(bool throwIfEmpty, const T& defaultValue = T()) const
@@ -90,12 +103,14 @@ class SExpression final
                 }
                 return stringToObject<T>(mValue, throwIfEmpty, defaultValue);
             } catch (const Exception& e) {
-                throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, mValue, e.getMsg());
+                throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                                     getFileColumn(), mValue, e.getMsg());
             }
         }
 
-        template <typename T>
-        T getValueByPath(const QString& path, bool throwIfEmpty, const T& defaultValue = T()) const
+        template <typename T, typename PathType>
+        T getValueByPath(const PathType& path, bool throwIfEmpty,
+                         const T& defaultValue = T()) const
         {
             const SExpression& child = getChildByPath(path);
             return child.getValueOfFirstChild<T>(throwIfEmpty, defaultValue);
@@ -105,7 +120,8 @@ class SExpression final
         T getValueOfFirstChild(bool throwIfEmpty, const T& defaultValue = T()) const
         {
             if (mChildren.count() < 1) {
-                throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+                throw FileParseError(__FILE__, __LINE__, getFilePath(), getFileLine(),
+                                     getFileColumn(), QString(),
                                      tr("Node does not have children."));
             }
             return mChildren.at(0).getValue<T>(throwIfEmpty, defaultValue);
@@ -137,6 +153,18 @@ class SExpression final
         void removeLineBreaks() noexcept;
         QString toString(int indent) const;
 
+        /**
+         * @brief Serialize the whole tree into a UTF-8 encoded byte array
+         *
+         * Creates the same output as `toString(0).toUtf8()`, but writes directly into a
+         * single buffer without creating temporary strings for every node.
+         *
+         * @return The serialized S-Expression
+         *
+         * @throws LogicError if a list name or token is invalid
+         */
+        QByteArray toByteArray() const;
+
         // Operator Overloadings
         SExpression& operator=(const SExpression& rhs) noexcept;
 
@@ -147,14 +175,64 @@ class SExpression final
         static SExpression createLineBreak();
         static SExpression parse(const QString& str, const FilePath& filePath);
 
+        /**
+         * @brief Parse an S-Expression from the (UTF-8 encoded) raw content of a file
+         *
+         * This is faster than the QString overload since the content does not have to be
+         * converted. See librepcb::SExpressionParser for details.
+         *
+         * @param content   The content to parse
+         * @param filePath  The file the content was read from (for error messages)
+         *
+         * @return The root node
+         *
+         * @throws FileParseError if the content is not a valid S-Expression
+         */
+        static SExpression parse(const QByteArray& content, const FilePath& filePath);
+
+        /**
+         * @brief Parse only some child lists of the root node
+         *
+         * Same as #parse(const QByteArray&, const FilePath&), but all child lists of the
+         * root node whose name is not contained in rootChildNames are skipped. This is
+         * much faster if only a few small children of a large file are needed (e.g. the
+         * metadata of a library element).
+         *
+         * @param content         The content to parse
+         * @param filePath        The file the content was read from (for error messages)
+         * @param rootChildNames  Names of the root child lists to parse
+         *
+         * @return The root node, containing only the requested child lists
+         *
+         * @throws FileParseError if the content is not a valid S-Expression
+         */
+        static SExpression parsePartially(const QByteArray& content,
+                                          const FilePath& filePath,
+                                          const QSet<QString>& rootChildNames);
+
+
+    private: // Types
+        /**
+         * @brief Information about a parsed file, shared by all nodes of the document
+         */
+        struct Source : public QSharedData {
+            FilePath filePath;
+            QVector<int> lineOffsets;   ///< character offsets of the beginning of all lines
+        };
+
 
     private: // Methods
         SExpression(Type type, const QString& value);
-        SExpression(sexpresso::Sexp& sexp, const FilePath& filePath);
 
-        QString escapeString(const QString& string) const noexcept;
-        bool isValidListName(const QString& name) const noexcept;
-        bool isValidToken(const QString& token) const noexcept;
+        template <typename NameType>
+        const SExpression* tryGetLastChild(const NameType& name) const noexcept;
+        bool serialize(QByteArray& output, int indent) const;
+        static bool isValidListName(const QString& name) noexcept;
+        static bool isValidToken(const QString& token) noexcept;
+        static bool isSpace(char c) noexcept;
+        static void appendAscii(QByteArray& output, const QString& str) noexcept;
+        static void appendIndent(QByteArray& output, int indent) noexcept;
+        static void appendEscapedString(QByteArray& output, const QString& str) noexcept;
 
         /**
          * @brief Serialization template method
@@ -189,9 +267,13 @@ class SExpression final
 
     private: // Data
         Type mType;
+        int mFileOffset; ///< position in the parsed file in characters (-1 if not parsed)
         QString mValue; ///< either a list name, a token or a string
         QList<SExpression> mChildren;
-        FilePath mFilePath;
+        QExplicitlySharedDataPointer<Source> mSource; ///< nullptr if not parsed
+
+        friend class SExpressionParser;
+        friend class SExpressionCache;
 };
 
 /*****************************************************************************************
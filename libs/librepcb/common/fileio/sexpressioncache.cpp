@@ -0,0 +1,303 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "sexpressioncache.h"
+#include "fileutils.h"
+#include "../tracer.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Static Variables
+ ****************************************************************************************/
+
+const char SExpressionCache::sMagic[8] = {'L', 'P', 'S', 'X', 'C', 'A', 'C', 'H'};
+const quint32 SExpressionCache::sFormatVersion = 2; // 2: offsets in characters
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+SExpressionCache::SExpressionCache(const SExpressionCache& other) noexcept :
+    mDirectory(other.mDirectory), mSourceRoot(other.mSourceRoot)
+{
+}
+
+SExpressionCache::SExpressionCache(const FilePath& directory,
+                                   const FilePath& sourceRoot) noexcept :
+    mDirectory(directory), mSourceRoot(sourceRoot)
+{
+}
+
+SExpressionCache::~SExpressionCache() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+SExpression SExpressionCache::parse(const QByteArray& content,
+                                    const FilePath& filePath) const
+{
+    TraceSpan span("SExpressionCache::parse", filePath);
+
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    return SExpression::parse(content, filePath); // can throw
+#endif
+
+    QByteArray contentHash = QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+    FilePath cacheFilePath = getCacheFilePath(filePath);
+
+    // try to load the cache file
+    QFile cacheFile(cacheFilePath.toStr());
+    if (cacheFile.open(QIODevice::ReadOnly)) {
+        qint64 size = cacheFile.size();
+        uchar* data = cacheFile.map(0, size);
+        if (data) {
+            try {
+                SExpression root = deserialize(data, size, contentHash, filePath); // can throw
+                cacheFile.unmap(data);
+                return root;
+            } catch (const Exception& e) {
+                // outdated or invalid --> overwrite it
+                qDebug() << "Not using cache file:" << e.getMsg();
+            }
+            cacheFile.unmap(data);
+        }
+        cacheFile.close();
+    }
+
+    // parse the file and update the cache file
+    SExpression root = SExpression::parse(content, filePath); // can throw
+    try {
+        FileUtils::writeFile(cacheFilePath, serialize(root, contentHash)); // can throw
+    } catch (const Exception& e) {
+        qWarning() << "Could not write cache file:" << e.getMsg();
+    }
+    return root;
+}
+
+/*****************************************************************************************
+ *  Operator Overloadings
+ ****************************************************************************************/
+
+SExpressionCache& SExpressionCache::operator=(const SExpressionCache& rhs) noexcept
+{
+    mDirectory = rhs.mDirectory;
+    mSourceRoot = rhs.mSourceRoot;
+    return *this;
+}
+
+/*****************************************************************************************
+ *  Static Methods
+ ****************************************************************************************/
+
+QByteArray SExpressionCache::serialize(const SExpression& root,
+                                       const QByteArray& contentHash) noexcept
+{
+    static_assert(sizeof(Header) == 64, "unexpected padding in header");
+    static_assert(sizeof(Node) == 16, "unexpected padding in node");
+    Q_ASSERT(contentHash.size() == sizeof(Header::contentHash));
+
+    // build the node array and the string table
+    QVector<Node> nodes;
+    QHash<QString, quint32> stringIndices;
+    serializeNode(root, nodes, stringIndices);
+    QVector<QString> strings(stringIndices.count());
+    for (auto it = stringIndices.constBegin(); it != stringIndices.constEnd(); ++it) {
+        strings[it.value()] = it.key();
+    }
+    QVector<quint32> stringOffsets;
+    stringOffsets.reserve(strings.count() + 1);
+    quint32 stringDataSize = 0;
+    foreach (const QString& str, strings) {
+        stringOffsets.append(stringDataSize);
+        stringDataSize += str.size();
+    }
+    stringOffsets.append(stringDataSize);
+    QVector<int> lineOffsets = root.mSource ? root.mSource->lineOffsets : QVector<int>{0};
+
+    Header header;
+    memcpy(header.magic, sMagic, sizeof(header.magic));
+    header.formatVersion = sFormatVersion;
+    header.nodeCount = nodes.count();
+    header.lineCount = lineOffsets.count();
+    header.stringCount = strings.count();
+    header.stringDataSize = stringDataSize;
+    header.reserved = 0;
+    memcpy(header.contentHash, contentHash.constData(), sizeof(header.contentHash));
+
+    QByteArray data;
+    data.reserve(sizeof(Header) + nodes.count() * sizeof(Node) +
+                 lineOffsets.count() * sizeof(qint32) +
+                 stringOffsets.count() * sizeof(quint32) + stringDataSize * sizeof(ushort));
+    data.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    data.append(reinterpret_cast<const char*>(nodes.constData()),
+                nodes.count() * sizeof(Node));
+    data.append(reinterpret_cast<const char*>(lineOffsets.constData()),
+                lineOffsets.count() * sizeof(qint32));
+    data.append(reinterpret_cast<const char*>(stringOffsets.constData()),
+                stringOffsets.count() * sizeof(quint32));
+    foreach (const QString& str, strings) {
+        data.append(reinterpret_cast<const char*>(str.utf16()), str.size() * sizeof(ushort));
+    }
+    return data;
+}
+
+SExpression SExpressionCache::deserialize(const uchar* data, qint64 size,
+                                          const QByteArray& contentHash,
+                                          const FilePath& filePath)
+{
+    // check header
+    if (size < static_cast<qint64>(sizeof(Header))) {
+        throwInvalidData(filePath, tr("File is too small."));
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (memcmp(header->magic, sMagic, sizeof(sMagic)) != 0) {
+        throwInvalidData(filePath, tr("Invalid file type."));
+    }
+    if (header->formatVersion != sFormatVersion) {
+        throwInvalidData(filePath, tr("Unsupported format version."));
+    }
+    if ((contentHash.size() != sizeof(header->contentHash)) ||
+        (memcmp(header->contentHash, contentHash.constData(), contentHash.size()) != 0)) {
+        throwInvalidData(filePath, tr("Source file has been modified."));
+    }
+    quint64 expectedSize = sizeof(Header) + quint64(header->nodeCount) * sizeof(Node) +
+                           quint64(header->lineCount) * sizeof(qint32) +
+                           (quint64(header->stringCount) + 1) * sizeof(quint32) +
+                           quint64(header->stringDataSize) * sizeof(ushort);
+    if ((header->nodeCount < 1) || (header->lineCount < 1) ||
+        (expectedSize != static_cast<quint64>(size))) {
+        throwInvalidData(filePath, tr("Invalid array sizes."));
+    }
+
+    // get arrays
+    const Node* nodes = reinterpret_cast<const Node*>(data + sizeof(Header));
+    const qint32* lineOffsets = reinterpret_cast<const qint32*>(nodes + header->nodeCount);
+    const quint32* stringOffsets = reinterpret_cast<const quint32*>(
+        lineOffsets + header->lineCount);
+    const ushort* stringData = reinterpret_cast<const ushort*>(
+        stringOffsets + header->stringCount + 1);
+
+    // load line offsets
+    Reader reader;
+    reader.source = new SExpression::Source();
+    reader.source->filePath = filePath;
+    reader.source->lineOffsets.resize(header->lineCount);
+    for (quint32 i = 0; i < header->lineCount; ++i) {
+        if ((i == 0) ? (lineOffsets[i] != 0) : (lineOffsets[i] <= lineOffsets[i - 1])) {
+            throwInvalidData(filePath, tr("Invalid line offsets."));
+        }
+        reader.source->lineOffsets[i] = lineOffsets[i];
+    }
+
+    // load string table
+    if ((stringOffsets[0] != 0) ||
+        (stringOffsets[header->stringCount] != header->stringDataSize)) {
+        throwInvalidData(filePath, tr("Invalid string table."));
+    }
+    reader.strings.resize(header->stringCount);
+    for (quint32 i = 0; i < header->stringCount; ++i) {
+        quint32 begin = stringOffsets[i];
+        quint32 end = stringOffsets[i + 1];
+        if (end < begin) {
+            throwInvalidData(filePath, tr("Invalid string table."));
+        }
+        reader.strings[i] = QString(reinterpret_cast<const QChar*>(stringData + begin),
+                                    end - begin);
+    }
+
+    // build tree
+    reader.nodes = nodes;
+    reader.nodeCount = header->nodeCount;
+    reader.nextNode = 0;
+    SExpression root = deserializeNode(reader); // can throw
+    if (reader.nextNode != reader.nodeCount) {
+        throwInvalidData(filePath, tr("Unused nodes."));
+    }
+    return root;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+FilePath SExpressionCache::getCacheFilePath(const FilePath& filePath) const noexcept
+{
+    QByteArray pathHash = QCryptographicHash::hash(filePath.toRelative(mSourceRoot).toUtf8(),
+                                                   QCryptographicHash::Sha1);
+    return mDirectory.getPathTo(QString(pathHash.toHex()) % ".lpcache");
+}
+
+void SExpressionCache::serializeNode(const SExpression& node, QVector<Node>& nodes,
+                                     QHash<QString, quint32>& strings) noexcept
+{
+    auto it = strings.constFind(node.mValue);
+    if (it == strings.constEnd()) {
+        it = strings.insert(node.mValue, strings.count());
+    }
+    nodes.append(Node{static_cast<quint32>(node.mType), node.mFileOffset, it.value(),
+                      static_cast<quint32>(node.mChildren.count())});
+    foreach (const SExpression& child, node.mChildren) {
+        serializeNode(child, nodes, strings);
+    }
+}
+
+SExpression SExpressionCache::deserializeNode(Reader& reader)
+{
+    const FilePath& filePath = reader.source->filePath;
+    const Node& node = reader.nodes[reader.nextNode++];
+    if ((node.type > static_cast<quint32>(SExpression::Type::LineBreak)) ||
+        (node.value >= static_cast<quint32>(reader.strings.count())) ||
+        (node.childCount > reader.nodeCount - reader.nextNode)) {
+        throwInvalidData(filePath, tr("Invalid node."));
+    }
+
+    SExpression sexpr(static_cast<SExpression::Type>(node.type),
+                      reader.strings.at(node.value));
+    sexpr.mFileOffset = node.fileOffset;
+    sexpr.mSource = reader.source;
+    sexpr.mChildren.reserve(node.childCount);
+    for (quint32 i = 0; i < node.childCount; ++i) {
+        sexpr.mChildren.append(deserializeNode(reader)); // can throw
+    }
+    return sexpr;
+}
+
+void SExpressionCache::throwInvalidData(const FilePath& filePath, const QString& reason)
+{
+    throw RuntimeError(__FILE__, __LINE__,
+        QString(tr("Invalid cache for \"%1\": %2")).arg(filePath.toNative(), reason));
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
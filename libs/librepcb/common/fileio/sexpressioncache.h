@@ -0,0 +1,192 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBREPCB_SEXPRESSIONCACHE_H
+#define LIBREPCB_SEXPRESSIONCACHE_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "sexpression.h"
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class SExpressionCache
+ ****************************************************************************************/
+
+/**
+ * @brief The SExpressionCache class stores parsed S-Expression files in a binary format
+ *
+ * Parsing large text files (e.g. boards) takes a significant amount of time when opening
+ * a project. This class keeps a binary snapshot of the parsed DOM tree of each file in a
+ * cache directory, which can be loaded much faster than the text file can be parsed.
+ * The text files always stay the source of truth: each cache file contains the SHA-256
+ * hash of the text content it was created from and is only used if it matches exactly.
+ * Otherwise (or if the cache file is invalid for any reason) the text is parsed and the
+ * cache file is rewritten.
+ *
+ * There is one cache file per source file (named by the hash of the path relative to
+ * the source root directory), so the cache does not grow when files are modified.
+ *
+ * The binary format is versioned, little endian and designed to be read directly from a
+ * memory mapped file (on big endian systems, the cache is not used at all):
+ *
+ * @code
+ * Header          magic "LPSXCACH", format version, content hash, array sizes
+ * Node[]          all nodes in pre-order: type, file offset, string index, child count
+ * qint32[]        character offsets of all lines in the source file
+ * quint32[]       offsets of all strings (+ end offset of the last one)
+ * ushort[]        UTF-16 data of all (deduplicated) strings
+ * @endcode
+ *
+ * Objects of this class are cheap to copy and thread-safe (no mutable state), so
+ * multiple files can be loaded in parallel.
+ */
+class SExpressionCache final
+{
+        Q_DECLARE_TR_FUNCTIONS(SExpressionCache)
+
+    public:
+
+        // Constructors / Destructor
+        SExpressionCache() = delete;
+        SExpressionCache(const SExpressionCache& other) noexcept;
+
+        /**
+         * @brief Constructor
+         *
+         * @param directory     The directory to store the cache files in (created on
+         *                      demand)
+         * @param sourceRoot    The directory which contains all source files
+         */
+        SExpressionCache(const FilePath& directory, const FilePath& sourceRoot) noexcept;
+        ~SExpressionCache() noexcept;
+
+        // Getters
+        const FilePath& getDirectory() const noexcept {return mDirectory;}
+
+        // General Methods
+
+        /**
+         * @brief Parse the content of a file, using the cache if it is valid
+         *
+         * @param content   The (UTF-8 encoded) raw content of the file
+         * @param filePath  The file the content was read from
+         *
+         * @return The root node (equal to SExpression::parse())
+         *
+         * @throws FileParseError if the content is not a valid S-Expression
+         */
+        SExpression parse(const QByteArray& content, const FilePath& filePath) const;
+
+        // Operator Overloadings
+        SExpressionCache& operator=(const SExpressionCache& rhs) noexcept;
+
+        // Static Methods
+
+        /**
+         * @brief Serialize a DOM tree into the binary cache format
+         *
+         * @param root          The root node
+         * @param contentHash   SHA-256 hash of the source file content
+         *
+         * @return The binary data
+         */
+        static QByteArray serialize(const SExpression& root,
+                                    const QByteArray& contentHash) noexcept;
+
+        /**
+         * @brief Deserialize a DOM tree from the binary cache format
+         *
+         * @param data          The binary data
+         * @param size          Size of the binary data in bytes
+         * @param contentHash   SHA-256 hash of the source file content (the data is
+         *                      rejected if it was created from a different content)
+         * @param filePath      The source file path (for error messages)
+         *
+         * @return The root node
+         *
+         * @throws RuntimeError if the data is invalid or outdated
+         */
+        static SExpression deserialize(const uchar* data, qint64 size,
+                                       const QByteArray& contentHash,
+                                       const FilePath& filePath);
+
+
+    private: // Types
+        struct Header {
+            char magic[8];
+            quint32 formatVersion;
+            quint32 nodeCount;
+            quint32 lineCount;
+            quint32 stringCount;
+            quint32 stringDataSize;     ///< number of UTF-16 code units
+            quint32 reserved;
+            char contentHash[32];
+        };
+
+        struct Node {
+            quint32 type;               ///< SExpression::Type
+            qint32 fileOffset;
+            quint32 value;              ///< index in the string table
+            quint32 childCount;
+        };
+
+        /**
+         * @brief Helper to read the arrays of a binary cache
+         */
+        struct Reader {
+            const Node* nodes;
+            quint32 nodeCount;
+            quint32 nextNode;
+            QVector<QString> strings;
+            QExplicitlySharedDataPointer<SExpression::Source> source;
+        };
+
+
+    private: // Methods
+        FilePath getCacheFilePath(const FilePath& filePath) const noexcept;
+        static void serializeNode(const SExpression& node, QVector<Node>& nodes,
+                                  QHash<QString, quint32>& strings) noexcept;
+        static SExpression deserializeNode(Reader& reader);
+        static Q_NORETURN void throwInvalidData(const FilePath& filePath,
+                                                const QString& reason);
+
+
+    private: // Data
+        FilePath mDirectory;
+        FilePath mSourceRoot;
+
+        static const char sMagic[8];
+        static const quint32 sFormatVersion;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_SEXPRESSIONCACHE_H
@@ -0,0 +1,364 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "sexpressionparser.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Helper Functions
+ ****************************************************************************************/
+
+static inline bool isWhiteSpace(char c) noexcept
+{
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f')
+        || (c == '\v');
+}
+
+static inline bool isTokenDelimiter(char c) noexcept
+{
+    return isWhiteSpace(c) || (c == '(') || (c == ')') || (c == '"');
+}
+
+/// Number of characters (Unicode code points) in UTF-8 encoded data
+static int countCharacters(const char* data, int size) noexcept
+{
+    int count = 0;
+    for (int i = 0; i < size; ++i) {
+        if ((static_cast<uchar>(data[i]) & 0xC0) != 0x80) { // skip continuation bytes
+            ++count;
+        }
+    }
+    return count;
+}
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+SExpressionParser::SExpressionParser(const QByteArray& content,
+                                     const FilePath& filePath) noexcept :
+    mContent(content), mFilePath(filePath), mFilterRootChildren(false)
+{
+}
+
+SExpressionParser::~SExpressionParser() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  Setters
+ ****************************************************************************************/
+
+void SExpressionParser::setRootChildrenFilter(const QSet<QString>& names) noexcept
+{
+    mFilterRootChildren = true;
+    mRootChildren.clear();
+    foreach (const QString& name, names) {
+        mRootChildren.insert(name.toUtf8());
+    }
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+SExpression SExpressionParser::parse()
+{
+    mNodes.clear();
+    mInternedStrings.clear();
+    tokenize(); // can throw
+    buildSource();
+    SExpression root = buildTree(0); // can throw
+    mSource.reset();
+    mNodes.clear();
+    mInternedStrings.clear();
+    return root;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+void SExpressionParser::tokenize()
+{
+    const char* data = mContent.constData();
+    const int size = mContent.size();
+    // rough estimation: one node per 8 bytes, avoids most reallocations of the arena
+    mNodes.reserve(size / 8 + 1);
+
+    QVector<int> openLists;     // arena indices of all currently open lists
+    QVector<int> lastChildren;  // arena index of the last child of each open list
+    int pos = 0;
+
+    // skip UTF-8 byte order mark
+    if (mContent.startsWith("\xEF\xBB\xBF")) {
+        pos = 3;
+    }
+
+    while (pos < size) {
+        const char c = data[pos];
+        if (isWhiteSpace(c)) {
+            ++pos;
+        } else if (c == '(') {
+            int listBegin = pos++;
+            while ((pos < size) && isWhiteSpace(data[pos])) ++pos;
+            int nameBegin = pos;
+            while ((pos < size) && (!isTokenDelimiter(data[pos]))) ++pos;
+            if (pos == nameBegin) {
+                throwParseError(listBegin, tr("List without name."));
+            }
+            if (openLists.isEmpty() && (!mNodes.isEmpty())) {
+                throwParseError(listBegin, tr("File does not have exactly one root node."));
+            }
+            if (mFilterRootChildren && (openLists.count() == 1) && (!mRootChildren.contains(
+                    QByteArray::fromRawData(data + nameBegin, pos - nameBegin)))) {
+                pos = skipList(listBegin, pos); // can throw
+                continue;
+            }
+            int parent = openLists.isEmpty() ? -1 : openLists.last();
+            int lastChild = lastChildren.isEmpty() ? -1 : lastChildren.last();
+            int index = addNode(parent, lastChild, true, listBegin, nameBegin,
+                                pos - nameBegin, false, false);
+            if (!lastChildren.isEmpty()) lastChildren.last() = index;
+            openLists.append(index);
+            lastChildren.append(-1);
+        } else if (c == ')') {
+            if (openLists.isEmpty()) {
+                throwParseError(pos, tr("Unexpected ')'."));
+            }
+            openLists.removeLast();
+            lastChildren.removeLast();
+            ++pos;
+        } else {
+            int atomBegin = pos;
+            int valueBegin, valueLength;
+            bool quoted = (c == '"');
+            bool hasEscapes = false;
+            if (quoted) {
+                valueBegin = ++pos;
+                while ((pos < size) && (data[pos] != '"')) {
+                    if (data[pos] == '\\') {
+                        hasEscapes = true;
+                        ++pos;
+                    }
+                    ++pos;
+                }
+                if (pos >= size) {
+                    throwParseError(atomBegin, tr("Unterminated string."));
+                }
+                valueLength = pos - valueBegin;
+                ++pos; // skip closing quote
+            } else {
+                valueBegin = pos;
+                while ((pos < size) && (!isTokenDelimiter(data[pos]))) ++pos;
+                valueLength = pos - valueBegin;
+            }
+            if (openLists.isEmpty()) {
+                throwParseError(atomBegin, tr("Value outside of a list."));
+            }
+            int index = addNode(openLists.last(), lastChildren.last(), false, atomBegin,
+                                valueBegin, valueLength, quoted, hasEscapes);
+            lastChildren.last() = index;
+        }
+    }
+
+    if (!openLists.isEmpty()) {
+        throwParseError(mNodes.at(openLists.last()).offset, tr("Missing ')'."));
+    }
+    if (mNodes.isEmpty()) {
+        throwParseError(pos, tr("File does not have exactly one root node."));
+    }
+}
+
+int SExpressionParser::skipList(int listBegin, int pos) const
+{
+    const char* data = mContent.constData();
+    const int size = mContent.size();
+    int depth = 1;
+    while (pos < size) {
+        const char c = data[pos++];
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            if (--depth == 0) {
+                return pos;
+            }
+        } else if (c == '"') {
+            int stringBegin = pos - 1;
+            while ((pos < size) && (data[pos] != '"')) {
+                if (data[pos] == '\\') ++pos;
+                ++pos;
+            }
+            if (pos >= size) {
+                throwParseError(stringBegin, tr("Unterminated string."));
+            }
+            ++pos; // skip closing quote
+        }
+    }
+    throwParseError(listBegin, tr("Missing ')'."));
+}
+
+int SExpressionParser::addNode(int parent, int lastChild, bool isList, int offset,
+                               int begin, int length, bool isQuoted,
+                               bool hasEscapes) noexcept
+{
+    int index = mNodes.count();
+    mNodes.append(Node{offset, begin, length, -1, -1, 0, isList, isQuoted, hasEscapes});
+    if (parent >= 0) {
+        Node& parentNode = mNodes[parent];
+        if (lastChild >= 0) {
+            mNodes[lastChild].nextSibling = index;
+        } else {
+            parentNode.firstChild = index;
+        }
+        ++parentNode.childCount;
+    }
+    return index;
+}
+
+void SExpressionParser::buildSource() noexcept
+{
+    // Offsets are converted from bytes to characters to get correct column numbers for
+    // lines containing non-ASCII characters. Since both the line beginnings and the
+    // nodes are sorted by offset, the characters are counted only once for each of them.
+    const char* data = mContent.constData();
+    int bytePos = 0;
+    int charPos = 0;
+    auto toCharOffset = [&](int byteOffset) {
+        charPos += countCharacters(data + bytePos, byteOffset - bytePos);
+        bytePos = byteOffset;
+        return charPos;
+    };
+
+    mSource = new SExpression::Source();
+    mSource->filePath = mFilePath;
+    mSource->lineOffsets.append(0);
+    for (int i = mContent.indexOf('\n'); i >= 0; i = mContent.indexOf('\n', i + 1)) {
+        mSource->lineOffsets.append(toCharOffset(i + 1));
+    }
+    mSource->lineOffsets.squeeze();
+
+    bytePos = 0;
+    charPos = 0;
+    for (Node& node : mNodes) {
+        node.offset = toCharOffset(node.offset);
+    }
+}
+
+SExpression SExpressionParser::buildTree(int index)
+{
+    const Node& node = mNodes.at(index);
+    if (node.isList) {
+        SExpression list(SExpression::Type::List,
+                         getInternedString(node.begin, node.length));
+        list.mFileOffset = node.offset;
+        list.mSource = mSource;
+        list.mChildren.reserve(node.childCount);
+        for (int child = node.firstChild; child >= 0; child = mNodes.at(child).nextSibling) {
+            list.mChildren.append(buildTree(child)); // can throw
+        }
+        return list;
+    } else {
+        QString value;
+        if (node.hasEscapes) {
+            value = unescape(node.begin, node.length); // can throw
+        } else if (node.isQuoted) {
+            // strings (names, descriptions, ...) are rarely equal, so don't intern them
+            value = QString::fromUtf8(mContent.constData() + node.begin, node.length);
+        } else {
+            value = getInternedString(node.begin, node.length);
+        }
+        SExpression atom(SExpression::Type::String, value);
+        atom.mFileOffset = node.offset;
+        atom.mSource = mSource;
+        return atom;
+    }
+}
+
+QString SExpressionParser::getInternedString(int begin, int length) noexcept
+{
+    // the key references the content without copying it, which is fine since the hash
+    // is cleared before the content is released
+    QByteArray key = QByteArray::fromRawData(mContent.constData() + begin, length);
+    auto it = mInternedStrings.constFind(key);
+    if (it != mInternedStrings.constEnd()) {
+        return it.value();
+    } else {
+        QString str = QString::fromUtf8(key.constData(), length);
+        mInternedStrings.insert(key, str);
+        return str;
+    }
+}
+
+QString SExpressionParser::unescape(int begin, int length) const
+{
+    const char* data = mContent.constData();
+    QByteArray str;
+    str.reserve(length);
+    for (int i = begin; i < begin + length; ++i) {
+        if (data[i] != '\\') {
+            str.append(data[i]);
+            continue;
+        }
+        ++i; // the tokenizer guarantees that a backslash is never the last character
+        switch (data[i]) {
+            case '"':  str.append('"');  break;
+            case '\\': str.append('\\'); break;
+            case '\'': str.append('\''); break;
+            case '?':  str.append('?');  break;
+            case 'n':  str.append('\n'); break;
+            case 'r':  str.append('\r'); break;
+            case 't':  str.append('\t'); break;
+            case 'f':  str.append('\f'); break;
+            case 'v':  str.append('\v'); break;
+            case 'b':  str.append('\b'); break;
+            case 'a':  str.append('\a'); break;
+            default:
+                throwParseError(i - 1, QString(tr("Unknown escape sequence: '\\%1'"))
+                                .arg(QString::fromUtf8(data + i, 1)));
+        }
+    }
+    return QString::fromUtf8(str);
+}
+
+void SExpressionParser::throwParseError(int offset, const QString& msg) const
+{
+    // line and column are only calculated in the error case to keep tokenizing fast
+    int lineStart = (offset > 0) ? (mContent.lastIndexOf('\n', offset - 1) + 1) : 0;
+    int line = mContent.left(lineStart).count('\n') + 1;
+    int column = countCharacters(mContent.constData() + lineStart, offset - lineStart) + 1;
+    throw FileParseError(__FILE__, __LINE__, mFilePath, line, column,
+                         QString::fromUtf8(mContent.mid(lineStart, 80).split('\n').first()),
+                         msg);
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
@@ -0,0 +1,137 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBREPCB_SEXPRESSIONPARSER_H
+#define LIBREPCB_SEXPRESSIONPARSER_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "sexpression.h"
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class SExpressionParser
+ ****************************************************************************************/
+
+/**
+ * @brief The SExpressionParser class parses UTF-8 encoded S-Expressions
+ *
+ * Used by librepcb::SExpression::parse(). The parser works in two passes directly on the
+ * raw file content (no conversion to QString or std::string of the whole file):
+ *
+ *  1. The content is tokenized into a compact node tree stored in a single array (the
+ *     arena). Nodes only reference their name/value by offset and length in the buffer,
+ *     so no strings are allocated in this pass and syntax errors are detected before any
+ *     SExpression object is created.
+ *  2. The SExpression tree is created from the arena. As the number of children of each
+ *     list is known, all child lists are allocated only once. List names and unquoted
+ *     tokens are interned, i.e. all equal names/tokens share the same QString data.
+ *
+ * All nodes of the created tree share a single librepcb::SExpression::Source object
+ * which contains the file path and the offsets of all lines. Each node only stores its
+ * own offset, which allows to report line and column numbers in parse errors. All these
+ * offsets are in characters (not bytes), so columns are also correct for lines which
+ * contain non-ASCII characters.
+ *
+ * Like the previous parser, all tokens and strings are returned as
+ * librepcb::SExpression::Type::String and no line breaks are created.
+ */
+class SExpressionParser final
+{
+        Q_DECLARE_TR_FUNCTIONS(SExpressionParser)
+
+    public:
+
+        // Constructors / Destructor
+        SExpressionParser() = delete;
+        SExpressionParser(const SExpressionParser& other) = delete;
+        SExpressionParser(const QByteArray& content, const FilePath& filePath) noexcept;
+        ~SExpressionParser() noexcept;
+
+        // Setters
+
+        /**
+         * @brief Only parse children of the root node which are lists with given names
+         *
+         * All other child lists of the root node are skipped without creating any nodes.
+         * Their content is only checked for balanced parentheses and terminated strings.
+         * Tokens and strings directly in the root node are always parsed.
+         *
+         * @param names     Names of the root child lists to parse
+         */
+        void setRootChildrenFilter(const QSet<QString>& names) noexcept;
+
+        // General Methods
+        SExpression parse();
+
+        // Operator Overloadings
+        SExpressionParser& operator=(const SExpressionParser& rhs) = delete;
+
+
+    private: // Types
+        struct Node {
+            int offset;         ///< position of the opening parenthesis, quote or token
+                                ///< (in bytes, converted to characters by #buildSource())
+            int begin;          ///< offset of the name/value in the content
+            int length;         ///< size of the name/value in bytes (without quotes)
+            int firstChild;     ///< arena index of the first child (-1 if none)
+            int nextSibling;    ///< arena index of the next sibling (-1 if none)
+            int childCount;     ///< number of children (list name not included)
+            bool isList;        ///< list or atom (token or string)
+            bool isQuoted;      ///< string with double quotes
+            bool hasEscapes;    ///< quoted string containing escape sequences
+        };
+
+
+    private: // Methods
+        void tokenize();
+        int skipList(int listBegin, int pos) const;
+        int addNode(int parent, int lastChild, bool isList, int offset, int begin,
+                    int length, bool isQuoted, bool hasEscapes) noexcept;
+        void buildSource() noexcept;
+        SExpression buildTree(int index);
+        QString getInternedString(int begin, int length) noexcept;
+        QString unescape(int begin, int length) const;
+        Q_NORETURN void throwParseError(int offset, const QString& msg) const;
+
+
+    private: // Data
+        QByteArray mContent;
+        FilePath mFilePath;
+        QExplicitlySharedDataPointer<SExpression::Source> mSource;
+        QVector<Node> mNodes;           ///< the arena, the root node is at index 0
+        QHash<QByteArray, QString> mInternedStrings; ///< keys reference mContent
+        bool mFilterRootChildren;       ///< see #setRootChildrenFilter()
+        QSet<QByteArray> mRootChildren; ///< see #setRootChildrenFilter()
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_SEXPRESSIONPARSER_H
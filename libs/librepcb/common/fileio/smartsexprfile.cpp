@@ -22,8 +22,10 @@
  ****************************************************************************************/
 #include <QtCore>
 #include "smartsexprfile.h"
+#include "asyncfilewriter.h"
 #include "fileutils.h"
 #include "sexpression.h"
+#include "sexpressioncache.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -47,19 +49,28 @@ SmartSExprFile::~SmartSExprFile() noexcept
  *  General Methods
  ****************************************************************************************/
 
-SExpression SmartSExprFile::parseFileAndBuildDomTree() const
+SExpression SmartSExprFile::parseFileAndBuildDomTree(const SExpressionCache* cache) const
 {
-    return SExpression::parse(FileUtils::readFile(mOpenedFilePath), mOpenedFilePath);
+    QByteArray content = FileUtils::readFile(mOpenedFilePath); // can throw
+    if (cache) {
+        return cache->parse(content, mOpenedFilePath); // can throw
+    } else {
+        return SExpression::parse(content, mOpenedFilePath); // can throw
+    }
 }
 
 void SmartSExprFile::save(const SExpression& domDocument, bool toOriginal)
 {
     FilePath filepath = prepareSaveAndReturnFilePath(toOriginal); // can throw
-    QString content = domDocument.toString(0); // can throw
-    if (!content.endsWith('\n')) {
-        content.append('\n');
-    }
-    FileUtils::writeFile(filepath, content.toUtf8()); // can throw
+    FileUtils::writeFileIfModified(filepath, serialize(domDocument)); // can throw
+    updateMembersAfterSaving(toOriginal);
+}
+
+void SmartSExprFile::save(const SExpression& domDocument, bool toOriginal,
+                          AsyncFileWriter& writer)
+{
+    FilePath filepath = prepareSaveAndReturnFilePath(toOriginal); // can throw
+    writer.addFile(filepath, domDocument);
     updateMembersAfterSaving(toOriginal);
 }
 
@@ -72,6 +83,15 @@ SmartSExprFile* SmartSExprFile::create(const FilePath &filepath)
     return new SmartSExprFile(filepath, false, false, true);
 }
 
+QByteArray SmartSExprFile::serialize(const SExpression& domDocument)
+{
+    QByteArray content = domDocument.toByteArray(); // can throw
+    if (!content.endsWith('\n')) {
+        content.append('\n');
+    }
+    return content;
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
@@ -33,6 +33,8 @@
 namespace librepcb {
 
 class SExpression;
+class SExpressionCache;
+class AsyncFileWriter;
 
 /*****************************************************************************************
  *  Class SmartSExprFile
@@ -87,14 +89,20 @@ class SmartSExprFile final : public SmartFile
         /**
          * @brief Open and parse the S-Expressions file and build the whole DOM tree
          *
+         * @param cache     If not nullptr, the DOM tree is loaded from this cache if it
+         *                  is up to date (and the cache is updated otherwise)
+         *
          * @return  A pointer to the created DOM tree. The caller takes the ownership of
          *          the DOM document.
          */
-        SExpression parseFileAndBuildDomTree() const;
+        SExpression parseFileAndBuildDomTree(const SExpressionCache* cache = nullptr) const;
 
         /**
          * @brief Write the S-Expressions DOM tree to the file system
          *
+         * The file is only written if its content has changed (see
+         * librepcb::FileUtils::writeFileIfModified()).
+         *
          * @param domDocument   The DOM document to save
          * @param toOriginal    Specifies whether the original or the backup file should
          *                      be overwritten/created.
@@ -103,6 +111,22 @@ class SmartSExprFile final : public SmartFile
          */
         void save(const SExpression& domDocument, bool toOriginal);
 
+        /**
+         * @brief Write the S-Expressions DOM tree to the file system in a worker thread
+         *
+         * Same as #save(), but the file is only added to the passed writer, i.e. it is
+         * formatted and written later when librepcb::AsyncFileWriter::start() is called.
+         * Errors while writing the file are reported by the writer.
+         *
+         * @param domDocument   The DOM document to save
+         * @param toOriginal    Specifies whether the original or the backup file should
+         *                      be overwritten/created.
+         * @param writer        The writer which will write the file
+         *
+         * @throw Exception If an error occurs
+         */
+        void save(const SExpression& domDocument, bool toOriginal, AsyncFileWriter& writer);
+
 
         // Operator Overloadings
         SmartSExprFile& operator=(const SmartSExprFile& rhs) = delete;
@@ -125,6 +149,17 @@ class SmartSExprFile final : public SmartFile
          */
         static SmartSExprFile* create(const FilePath &filepath);
 
+        /**
+         * @brief Serialize a DOM tree to the content of a S-Expressions file
+         *
+         * @param domDocument   The DOM document to serialize
+         *
+         * @return The UTF-8 encoded file content (always ends with a newline)
+         *
+         * @throw Exception If an error occurs
+         */
+        static QByteArray serialize(const SExpression& domDocument);
+
 
     private: // Methods
 
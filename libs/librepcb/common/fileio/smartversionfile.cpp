@@ -65,7 +65,8 @@ void SmartVersionFile::save(bool toOriginal)
 {
     if (mVersion.isValid()) {
         const FilePath& filepath = prepareSaveAndReturnFilePath(toOriginal);
-        FileUtils::writeFile(filepath, QString("%1\n").arg(mVersion.toStr()).toUtf8());
+        FileUtils::writeFileIfModified(filepath,
+                                       QString("%1\n").arg(mVersion.toStr()).toUtf8());
         updateMembersAfterSaving(toOriginal);
     } else {
         qDebug() << mVersion.toStr();
@@ -0,0 +1,143 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "pointinpolygonindex.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+PointInPolygonIndex::PointInPolygonIndex(const Path& path) noexcept :
+    mPath(path), mHasArcs(false), mLeft(0), mBottom(0), mRight(0), mTop(0)
+{
+    const QVector<Vertex>& vertices = mPath.getVertices();
+    for (int i = 0; i < vertices.count(); ++i) {
+        // the angle of the last vertex is not used since the path is closed with a line
+        if ((i < vertices.count() - 1) && (vertices.at(i).getAngle() != 0)) {
+            mHasArcs = true;
+        }
+        qint64 x = vertices.at(i).getPos().getX().toNm();
+        qint64 y = vertices.at(i).getPos().getY().toNm();
+        mLeft = (i == 0) ? x : qMin(mLeft, x);
+        mRight = (i == 0) ? x : qMax(mRight, x);
+        mBottom = (i == 0) ? y : qMin(mBottom, y);
+        mTop = (i == 0) ? y : qMax(mTop, y);
+    }
+    if (mHasArcs) {
+        return;
+    }
+
+    // collect all non-horizontal edges (including the implicit closing edge)
+    for (int i = 0; i < vertices.count(); ++i) {
+        const Point& p1 = vertices.at(i).getPos();
+        const Point& p2 = vertices.at((i + 1) % vertices.count()).getPos();
+        if (p1.getY() < p2.getY()) {
+            mEdges.append(Edge{p1.getX().toNm(), p1.getY().toNm(),
+                               p2.getX().toNm(), p2.getY().toNm()});
+        } else if (p1.getY() > p2.getY()) {
+            mEdges.append(Edge{p2.getX().toNm(), p2.getY().toNm(),
+                               p1.getX().toNm(), p1.getY().toNm()});
+        }
+    }
+
+    // sort the edges into horizontal stripes
+    mBuckets.resize(qBound(1, mEdges.count(), 1024));
+    for (int i = 0; i < mEdges.count(); ++i) {
+        int last = getBucket(mEdges.at(i).y2);
+        for (int k = getBucket(mEdges.at(i).y1); k <= last; ++k) {
+            mBuckets[k].append(i);
+        }
+    }
+}
+
+PointInPolygonIndex::~PointInPolygonIndex() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+bool PointInPolygonIndex::contains(const Point& point) const noexcept
+{
+    if (mHasArcs) {
+        return mPath.toQPainterPathPx().contains(point.toPxQPointF());
+    }
+    qint64 x = point.getX().toNm();
+    qint64 y = point.getY().toNm();
+    // same as QRectF::contains() used by QPainterPath::contains(): the border of the
+    // bounding box is included, but an empty bounding box doesn't contain anything
+    if ((mLeft == mRight) || (mBottom == mTop)) return false;
+    if ((x < mLeft) || (x > mRight) || (y < mBottom) || (y > mTop)) return false;
+    return containsIndexed(x, y);
+}
+
+QVector<int> PointInPolygonIndex::getContainedPoints(const QVector<Point>& points) const noexcept
+{
+    QVector<int> indices;
+    for (int i = 0; i < points.count(); ++i) {
+        if (contains(points.at(i))) {
+            indices.append(i);
+        }
+    }
+    return indices;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+bool PointInPolygonIndex::containsIndexed(qint64 x, qint64 y) const noexcept
+{
+    // Count the edges crossing the horizontal ray from the point to the left. This is
+    // the scanline rule of QPainterPath::contains(), translated to nanometers (where the
+    // Y axis is inverted): an edge is crossed if y1 < y <= y2 and the intersection is
+    // not right of the point.
+    bool inside = false;
+    foreach (int index, mBuckets.at(getBucket(y))) {
+        const Edge& e = mEdges.at(index);
+        if ((y > e.y1) && (y <= e.y2)) {
+            if ((e.x1 - x) * (e.y2 - e.y1) + (e.x2 - e.x1) * (y - e.y1) <= 0) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+int PointInPolygonIndex::getBucket(qint64 y) const noexcept
+{
+    Q_ASSERT((y >= mBottom) && (y <= mTop));
+    return ((y - mBottom) * mBuckets.count()) / (mTop - mBottom + 1);
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
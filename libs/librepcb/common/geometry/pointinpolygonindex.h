@@ -0,0 +1,111 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_POINTINPOLYGONINDEX_H
+#define LIBREPCB_POINTINPOLYGONINDEX_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtGui>
+#include "path.h"
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class PointInPolygonIndex
+ ****************************************************************************************/
+
+/**
+ * @brief The PointInPolygonIndex class allows fast point-in-polygon tests for a path
+ *
+ * The result is the same as with `path.toQPainterPathPx().contains(point.toPxQPointF())`
+ * (odd-even fill rule, the path is implicitly closed), but the calculation is done with
+ * exact integer arithmetic in nanometers. The edges of the path are sorted into
+ * horizontal stripes, so a single test only needs to look at the few edges which
+ * intersect the stripe of the tested point.
+ *
+ * The only difference to QPainterPath::contains() are points which lie exactly on a
+ * sloped edge: QPainterPath returns a more or less random result (depending on floating
+ * point rounding) while this class always returns a well defined result.
+ *
+ * Paths containing arc segments are not indexed, they fall back to QPainterPath.
+ *
+ * @note Coordinate differences must not exceed about 2 meters to avoid integer overflows.
+ */
+class PointInPolygonIndex final
+{
+    public:
+
+        // Constructors / Destructor
+        PointInPolygonIndex() = delete;
+        PointInPolygonIndex(const PointInPolygonIndex& other) = delete;
+        explicit PointInPolygonIndex(const Path& path) noexcept;
+        ~PointInPolygonIndex() noexcept;
+
+        // Getters
+        const Path& getPath() const noexcept {return mPath;}
+
+        // General Methods
+        bool contains(const Point& point) const noexcept;
+
+        /**
+         * @brief Test many points at once
+         *
+         * @param points    The points to test
+         *
+         * @return Indices (in ascending order) of all points contained in the path
+         */
+        QVector<int> getContainedPoints(const QVector<Point>& points) const noexcept;
+
+        // Operator Overloadings
+        PointInPolygonIndex& operator=(const PointInPolygonIndex& rhs) = delete;
+
+
+    private: // Types
+        struct Edge {
+            qint64 x1, y1;  ///< the lower end point (y1 < y2)
+            qint64 x2, y2;  ///< the upper end point
+        };
+
+
+    private: // Methods
+        bool containsIndexed(qint64 x, qint64 y) const noexcept;
+        int getBucket(qint64 y) const noexcept;
+
+
+    private: // Data
+        Path mPath;
+        bool mHasArcs;          ///< if true, QPainterPath is used instead of the index
+        qint64 mLeft, mBottom, mRight, mTop; ///< bounding box (inclusive)
+        QVector<Edge> mEdges;   ///< all non-horizontal edges
+        QVector<QVector<int>> mBuckets; ///< indices of the edges crossing each stripe
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_POINTINPOLYGONINDEX_H
@@ -38,8 +38,8 @@ Vertex::Vertex(const SExpression& node)
         mPos = Point(node.getChildByPath("pos"));
         mAngle = node.getValueByPath<Angle>("angle", true);
     } catch (const Exception& e) {
-        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), -1, -1,
-                             QString(), e.getMsg());
+        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), node.getFileLine(),
+                             node.getFileColumn(), QString(), e.getMsg());
     }
 }
 
@@ -95,6 +95,15 @@ SQLiteDatabase::~SQLiteDatabase() noexcept
     mDb.close();
 }
 
+/*****************************************************************************************
+ *  Getters
+ ****************************************************************************************/
+
+bool SQLiteDatabase::isFullTextSearchAvailable()
+{
+    return getSqliteCompileOptions().contains("ENABLE_FTS5"); // can throw
+}
+
 /*****************************************************************************************
  *  SQL Commands
  ****************************************************************************************/
@@ -72,6 +72,16 @@ class SQLiteDatabase final : public QObject
         ~SQLiteDatabase() noexcept;
 
 
+        // Getters
+
+        /**
+         * @brief Check whether the SQLite library supports FTS5 full text search tables
+         *
+         * @see https://sqlite.org/fts5.html
+         */
+        bool isFullTextSearchAvailable();
+
+
         // SQL Commands
         void beginTransaction();
         void commitTransaction();
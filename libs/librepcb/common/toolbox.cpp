@@ -21,6 +21,7 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <limits>
 #include "toolbox.h"
 
 /*****************************************************************************************
@@ -129,6 +130,52 @@ QVariant Toolbox::stringOrNumberToQVariant(const QString& string) noexcept
     return QVariant(string);
 }
 
+bool Toolbox::decimalStringToFixedPoint(const QString& string, int decimals,
+                                        qint32& value) noexcept
+{
+    const qint64 max = std::numeric_limits<qint32>::max();
+    const QChar* pos = string.constData();
+    const QChar* end = pos + string.size();
+    bool negative = false;
+    if ((pos < end) && ((*pos == '-') || (*pos == '+'))) {
+        negative = (*pos == '-');
+        ++pos;
+    }
+    qint64 result = 0;
+    int digits = 0;
+    int fractionalDigits = -1; // -1 means there was no decimal point (yet)
+    for (; pos < end; ++pos) {
+        ushort c = pos->unicode();
+        if ((c >= '0') && (c <= '9')) {
+            if (fractionalDigits == decimals) {
+                return false; // too many decimals, would need rounding
+            } else if (fractionalDigits >= 0) {
+                ++fractionalDigits;
+            }
+            result = result * 10 + (c - '0');
+            if (result > max) {
+                return false;
+            }
+            ++digits;
+        } else if ((c == '.') && (fractionalDigits < 0)) {
+            fractionalDigits = 0;
+        } else {
+            return false;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+    for (int i = qMax(fractionalDigits, 0); i < decimals; ++i) {
+        result *= 10;
+        if (result > max) {
+            return false;
+        }
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
@@ -114,6 +114,24 @@ class Toolbox final
          * @return A QVariant with either a QVariant::Int or a QVariant::String
          */
         static QVariant stringOrNumberToQVariant(const QString& string) noexcept;
+
+        /**
+         * @brief Fast conversion of a decimal number string to a fixed point integer
+         *
+         * For example "-1.25" with 6 decimals is converted to -1250000. Only the simple
+         * format `[+-]digits[.digits]` is supported (as written to files by LibrePCB),
+         * without any allocation or locale handling. For everything else (e.g. exponents,
+         * whitespace, more decimals than requested or values out of range), false is
+         * returned and the caller has to use a generic (slower) conversion instead.
+         *
+         * @param string    The string to convert
+         * @param decimals  The number of decimals of the fixed point value
+         * @param value     The converted value is written to this parameter
+         *
+         * @return True if the conversion was successful, false otherwise
+         */
+        static bool decimalStringToFixedPoint(const QString& string, int decimals,
+                                              qint32& value) noexcept;
 };
 
 /*****************************************************************************************
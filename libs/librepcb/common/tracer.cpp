@@ -0,0 +1,132 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "tracer.h"
+#include "exceptions.h"
+#include "fileio/fileutils.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Static Variables
+ ****************************************************************************************/
+
+QAtomicInt Tracer::sEnabled(0);
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+Tracer::Tracer() noexcept
+{
+}
+
+Tracer::~Tracer() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+void Tracer::enable(const FilePath& outputFile) noexcept
+{
+    QMutexLocker locker(&mMutex);
+    if (!isEnabled()) {
+        mOutputFile = outputFile;
+        mSpans.clear();
+        mThreadIds.clear();
+        mTimer.start();
+        sEnabled.storeRelease(1);
+        qInfo() << "Tracing enabled, output file:" << outputFile.toNative();
+    }
+}
+
+void Tracer::disable() noexcept
+{
+    QMutexLocker locker(&mMutex);
+    if (!isEnabled()) {
+        return;
+    }
+    sEnabled.storeRelease(0);
+
+    // spans which are still open are not written (their end is not known)
+    QJsonArray events;
+    QJsonObject processName;
+    processName["name"] = "process_name";
+    processName["ph"] = "M";
+    processName["pid"] = 1;
+    processName["args"] = QJsonObject{{"name", QCoreApplication::applicationName()}};
+    events.append(processName);
+    foreach (const Span& span, mSpans) {
+        QJsonObject event;
+        event["name"] = QString(span.name);
+        event["cat"] = "librepcb";
+        event["ph"] = "X";
+        event["ts"] = span.begin;
+        event["dur"] = span.duration;
+        event["pid"] = 1;
+        event["tid"] = span.threadId;
+        if (!span.file.isEmpty()) {
+            event["args"] = QJsonObject{{"file", span.file}};
+        }
+        events.append(event);
+    }
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+
+    try {
+        FileUtils::writeFile(mOutputFile, QJsonDocument(root).toJson()); // can throw
+        qInfo() << "Trace with" << mSpans.count() << "spans written to"
+                << mOutputFile.toNative();
+    } catch (const Exception& e) {
+        qCritical() << "Could not write trace file:" << e.getMsg();
+    }
+    mSpans.clear();
+    mThreadIds.clear();
+}
+
+void Tracer::addSpan(const char* name, const QString& file, qint64 beginUs,
+                     qint64 endUs) noexcept
+{
+    QMutexLocker locker(&mMutex);
+    if (isEnabled()) { // might have been disabled in the meantime
+        Qt::HANDLE thread = QThread::currentThreadId();
+        auto it = mThreadIds.find(thread);
+        if (it == mThreadIds.end()) {
+            it = mThreadIds.insert(thread, mThreadIds.count());
+        }
+        mSpans.append(Span{name, file, beginUs, endUs - beginUs, it.value()});
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
@@ -0,0 +1,201 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBREPCB_TRACER_H
+#define LIBREPCB_TRACER_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "fileio/filepath.h"
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class Tracer
+ ****************************************************************************************/
+
+/**
+ * @brief The Tracer class records timing spans to analyze the performance
+ *
+ * Tracing is always compiled in, but disabled by default. When enabled with #enable(),
+ * all spans recorded with librepcb::TraceSpan (from any thread) are collected in memory
+ * and written to a file in the Chrome trace event format by #disable(). The file can be
+ * viewed with `chrome://tracing` or https://ui.perfetto.dev/.
+ *
+ * While disabled, a librepcb::TraceSpan costs almost nothing (a single atomic load).
+ *
+ * The application `librepcb` enables tracing if the environment variable
+ * `LIBREPCB_TRACE_FILE` or the command line argument `--trace-file=<path>` is set.
+ *
+ * @note This class is thread-safe.
+ */
+class Tracer final
+{
+    public:
+
+        // Constructors / Destructor
+        Tracer(const Tracer& other) = delete;
+
+        // Getters
+        qint64 getTimestampUs() const noexcept {return mTimer.nsecsElapsed() / 1000;}
+
+        // General Methods
+
+        /**
+         * @brief Start recording spans
+         *
+         * @param outputFile    The file to write the recorded spans to (see #disable())
+         */
+        void enable(const FilePath& outputFile) noexcept;
+
+        /**
+         * @brief Stop recording spans and write all recorded spans to the output file
+         */
+        void disable() noexcept;
+
+        /**
+         * @brief Add a recorded span (used by librepcb::TraceSpan)
+         *
+         * @param name      Name of the span (must be a string literal)
+         * @param file      The file which was processed within the span (may be empty)
+         * @param beginUs   Start timestamp (see #getTimestampUs())
+         * @param endUs     End timestamp (see #getTimestampUs())
+         */
+        void addSpan(const char* name, const QString& file, qint64 beginUs,
+                     qint64 endUs) noexcept;
+
+        // Operator Overloadings
+        Tracer& operator=(const Tracer& rhs) = delete;
+
+        // Static Methods
+        static bool isEnabled() noexcept {return sEnabled.loadAcquire() != 0;}
+        static Tracer& instance() noexcept {static Tracer tracer; return tracer;}
+
+
+    private: // Types
+        struct Span {
+            const char* name;
+            QString file;
+            qint64 begin;
+            qint64 duration;
+            int threadId;
+        };
+
+
+    private: // Methods
+        Tracer() noexcept;
+        ~Tracer() noexcept;
+
+
+    private: // Data
+        QMutex mMutex;                      ///< protects all members except #mTimer
+        QElapsedTimer mTimer;               ///< only modified while disabled
+        FilePath mOutputFile;
+        QVector<Span> mSpans;
+        QHash<Qt::HANDLE, int> mThreadIds;  ///< small numbers are easier to read
+
+        static QAtomicInt sEnabled;
+};
+
+/*****************************************************************************************
+ *  Class TraceSpan
+ ****************************************************************************************/
+
+/**
+ * @brief The TraceSpan class records the lifetime of a scope with librepcb::Tracer
+ *
+ * Example:
+ * @code
+ * void Board::rebuildAllPlanes() noexcept
+ * {
+ *     TraceSpan span("Board::rebuildAllPlanes");
+ *     ...
+ * }
+ * @endcode
+ */
+class TraceSpan final
+{
+    public:
+
+        // Constructors / Destructor
+        TraceSpan() = delete;
+        TraceSpan(const TraceSpan& other) = delete;
+
+        /**
+         * @brief Constructor
+         *
+         * @param name  Name of the span (must be a string literal)
+         */
+        explicit TraceSpan(const char* name) noexcept :
+            mName(nullptr), mBegin(0)
+        {
+            if (Q_UNLIKELY(Tracer::isEnabled())) {
+                mName = name;
+                mBegin = Tracer::instance().getTimestampUs();
+            }
+        }
+
+        /**
+         * @brief Constructor
+         *
+         * @param name  Name of the span (must be a string literal)
+         * @param file  The file which is processed within the span (only copied if
+         *              tracing is enabled)
+         */
+        TraceSpan(const char* name, const FilePath& file) noexcept :
+            mName(nullptr), mBegin(0)
+        {
+            if (Q_UNLIKELY(Tracer::isEnabled())) {
+                mName = name;
+                mFile = file.toNative();
+                mBegin = Tracer::instance().getTimestampUs();
+            }
+        }
+
+        ~TraceSpan() noexcept
+        {
+            if (Q_UNLIKELY(mName)) {
+                Tracer& tracer = Tracer::instance();
+                tracer.addSpan(mName, mFile, mBegin, tracer.getTimestampUs());
+            }
+        }
+
+        // Operator Overloadings
+        TraceSpan& operator=(const TraceSpan& rhs) = delete;
+
+
+    private: // Data
+        const char* mName; ///< nullptr if tracing is disabled
+        QString mFile;
+        qint64 mBegin;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_TRACER_H
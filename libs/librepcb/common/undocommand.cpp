@@ -28,6 +28,12 @@
  ****************************************************************************************/
 namespace librepcb {
 
+/*****************************************************************************************
+ *  Static Variables
+ ****************************************************************************************/
+
+quint64 UndoCommand::sModificationCounter = 1;
+
 /*****************************************************************************************
  *  Constructors / Destructor
  ****************************************************************************************/
@@ -53,6 +59,7 @@ bool UndoCommand::execute()
     }
 
     mIsExecuted = true; // set this flag BEFORE performing the execution!
+    sModificationCounter++; // also if nothing was done or an exception is thrown
     bool retval = performExecute(); // can throw
     mRedoCount++;
 
@@ -65,6 +72,7 @@ void UndoCommand::undo()
         throw LogicError(__FILE__, __LINE__);
     }
 
+    sModificationCounter++;
     performUndo(); // can throw
     mUndoCount++;
 }
@@ -75,6 +83,7 @@ void UndoCommand::redo()
         throw LogicError(__FILE__, __LINE__);
     }
 
+    sModificationCounter++;
     performRedo(); // can throw
     mRedoCount++;
 }
@@ -82,6 +82,22 @@ class UndoCommand
         bool isCurrentlyExecuted() const noexcept {return mRedoCount > mUndoCount;}
 
 
+        // Static Methods
+
+        /**
+         * @brief Get a counter which is incremented whenever any command is executed,
+         *        undone or redone
+         *
+         * Allows to detect cheaply whether an object might have been modified by a
+         * command since a given point in time (e.g. to avoid serializing unchanged
+         * documents again when saving a project). The counter is never zero.
+         *
+         * @note Commands are only executed in the GUI thread, so this must only be
+         *       called from the GUI thread as well.
+         */
+        static quint64 getModificationCounter() noexcept {return sModificationCounter;}
+
+
         // General Methods
 
         /**
@@ -141,6 +157,8 @@ class UndoCommand
         bool mIsExecuted;   ///< @brief Shows whether #execute() was called or not
         int mRedoCount;     ///< @brief Counter of how often #redo() was called
         int mUndoCount;     ///< @brief Counter of how often #undo() was called
+
+        static quint64 sModificationCounter; ///< see #getModificationCounter()
 };
 
 /*****************************************************************************************
@@ -22,6 +22,7 @@
  ****************************************************************************************/
 #include <QtCore>
 #include "angle.h"
+#include "../toolbox.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -113,6 +114,11 @@ Angle Angle::fromRad(qreal radians) noexcept
 
 qint32 Angle::degStringToMicrodeg(const QString& degrees)
 {
+    qint32 value;
+    if (Toolbox::decimalStringToFixedPoint(degrees, 6, value)) {
+        return value; // fast path without locale aware conversion
+    }
+
     bool ok;
     qreal angle = qRound(QLocale::c().toDouble(degrees, &ok) * 1e6);
     if (!ok)
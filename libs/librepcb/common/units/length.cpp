@@ -23,6 +23,7 @@
 #include <QtCore>
 #include <limits>
 #include "length.h"
+#include "../toolbox.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -152,6 +153,11 @@ LengthBase_t Length::mapNmToGrid(LengthBase_t nanometers, const Length& gridInte
 
 LengthBase_t Length::mmStringToNm(const QString& millimeters)
 {
+    qint32 value;
+    if (Toolbox::decimalStringToFixedPoint(millimeters, 6, value)) {
+        return value; // fast path without locale aware conversion
+    }
+
     bool ok;
     qreal nm = qRound(QLocale::c().toDouble(millimeters, &ok) * 1e6);
     if (!ok)
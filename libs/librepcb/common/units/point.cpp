@@ -39,8 +39,8 @@ Point::Point(const SExpression& node)
         mX = node.getChildByIndex(0).getValue<Length>(true);
         mY = node.getChildByIndex(1).getValue<Length>(true);
     } catch (const Exception& e) {
-        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), -1, -1,
-                             QString(), e.getMsg());
+        throw FileParseError(__FILE__, __LINE__, node.getFilePath(), node.getFileLine(),
+                             node.getFileColumn(), QString(), e.getMsg());
     }
 }
 
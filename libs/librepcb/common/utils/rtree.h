@@ -0,0 +1,379 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_RTREE_H
+#define LIBREPCB_RTREE_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+
+/*****************************************************************************************
+ *  Class RTree
+ ****************************************************************************************/
+
+/**
+ * @brief The RTree class is a simple spatial index for rectangles (Guttman R-Tree with
+ *        quadratic split)
+ *
+ * Each entry consists of a bounding rectangle and an arbitrary value. The same value
+ * may be inserted multiple times (with the same or different rectangles), so to remove
+ * an entry, both the rectangle and the value must be passed to #remove().
+ *
+ * In contrast to QRectF::intersects(), rectangles are treated as closed areas, i.e.
+ * rectangles with zero width or height (e.g. a single point) are allowed both as
+ * entries and as query areas.
+ *
+ * @tparam T    Type of the values (must be copyable and comparable)
+ */
+template <typename T>
+class RTree final
+{
+    public:
+
+        // Constructors / Destructor
+        RTree() noexcept : mRoot(new Node(nullptr, true)), mSize(0) {}
+        RTree(const RTree& other) = delete;
+        ~RTree() noexcept {deleteNode(mRoot);}
+
+        // Getters
+        int size() const noexcept {return mSize;}
+        bool isEmpty() const noexcept {return mSize == 0;}
+
+        // General Methods
+        void insert(const QRectF& rect, const T& value) noexcept {
+            insertEntry(Entry(rect.normalized(), value));
+            ++mSize;
+        }
+        bool remove(const QRectF& rect, const T& value) noexcept {
+            Node* leaf = nullptr;
+            int index = -1;
+            if (!findEntry(mRoot, rect.normalized(), value, leaf, index)) return false;
+            leaf->entries.remove(index);
+            --mSize;
+            condenseTree(leaf);
+            return true;
+        }
+        void clear() noexcept {
+            deleteNode(mRoot);
+            mRoot = new Node(nullptr, true);
+            mSize = 0;
+        }
+        QList<T> find(const QRectF& rect) const noexcept {
+            QList<T> values;
+            findValues(mRoot, rect.normalized(), values);
+            return values;
+        }
+
+        // Operator Overloadings
+        RTree& operator=(const RTree& rhs) = delete;
+
+
+    private: // Types
+
+        struct Node;
+
+        struct Entry {
+            QRectF rect;
+            Node* child;    ///< only used in non-leaf nodes
+            T value;        ///< only used in leaf nodes
+            Entry() noexcept : rect(), child(nullptr), value() {}
+            Entry(const QRectF& r, const T& v) noexcept : rect(r), child(nullptr), value(v) {}
+            Entry(const QRectF& r, Node* c) noexcept : rect(r), child(c), value() {}
+        };
+
+        struct Node {
+            Node* parent;
+            bool leaf;
+            QVector<Entry> entries;
+            Node(Node* p, bool l) noexcept : parent(p), leaf(l) {}
+            QRectF boundingRect() const noexcept {
+                QRectF rect = entries.first().rect;
+                for (int i = 1; i < entries.count(); ++i) {
+                    rect = unite(rect, entries.at(i).rect);
+                }
+                return rect;
+            }
+        };
+
+        static const int sMaxEntries = 8;
+        static const int sMinEntries = 3;
+
+
+    private: // Methods
+
+        void insertEntry(const Entry& entry) noexcept {
+            Node* leaf = chooseLeaf(entry.rect);
+            leaf->entries.append(entry);
+            adjustTree(leaf);
+        }
+
+        Node* chooseLeaf(const QRectF& rect) const noexcept {
+            Node* node = mRoot;
+            while (!node->leaf) {
+                int best = 0;
+                qreal bestEnlargement = 0;
+                qreal bestArea = 0;
+                for (int i = 0; i < node->entries.count(); ++i) {
+                    const QRectF& r = node->entries.at(i).rect;
+                    qreal a = area(r);
+                    qreal enlargement = area(unite(r, rect)) - a;
+                    if ((i == 0) || (enlargement < bestEnlargement) ||
+                        ((enlargement == bestEnlargement) && (a < bestArea))) {
+                        best = i;
+                        bestEnlargement = enlargement;
+                        bestArea = a;
+                    }
+                }
+                node = node->entries.at(best).child;
+            }
+            return node;
+        }
+
+        void adjustTree(Node* node) noexcept {
+            while (node) {
+                Node* sibling = (node->entries.count() > sMaxEntries) ? splitNode(node) : nullptr;
+                Node* parent = node->parent;
+                if (!parent) {
+                    if (sibling) {
+                        // the root was split -> the tree grows by one level
+                        Node* root = new Node(nullptr, false);
+                        addEntry(root, Entry(node->boundingRect(), node));
+                        addEntry(root, Entry(sibling->boundingRect(), sibling));
+                        mRoot = root;
+                    }
+                    return;
+                }
+                updateEntryRect(parent, node);
+                if (sibling) {
+                    addEntry(parent, Entry(sibling->boundingRect(), sibling));
+                }
+                node = parent;
+            }
+        }
+
+        Node* splitNode(Node* node) noexcept {
+            QVector<Entry> entries = node->entries;
+            node->entries.clear();
+            Node* sibling = new Node(node->parent, node->leaf);
+
+            // pick the two entries which would waste the most area if put together
+            int seed1 = 0, seed2 = 1;
+            qreal worstWaste = 0;
+            for (int i = 0; i < entries.count(); ++i) {
+                for (int k = i + 1; k < entries.count(); ++k) {
+                    const QRectF& r1 = entries.at(i).rect;
+                    const QRectF& r2 = entries.at(k).rect;
+                    qreal waste = area(unite(r1, r2)) - area(r1) - area(r2);
+                    if (((i == 0) && (k == 1)) || (waste > worstWaste)) {
+                        seed1 = i;
+                        seed2 = k;
+                        worstWaste = waste;
+                    }
+                }
+            }
+            QRectF rect1 = entries.at(seed1).rect;
+            QRectF rect2 = entries.at(seed2).rect;
+            addEntry(node, entries.at(seed1));
+            addEntry(sibling, entries.at(seed2));
+            entries.remove(seed2); // seed2 > seed1, so remove it first
+            entries.remove(seed1);
+
+            // distribute the remaining entries
+            while (!entries.isEmpty()) {
+                if (node->entries.count() + entries.count() <= sMinEntries) {
+                    foreach (const Entry& entry, entries) addEntry(node, entry);
+                    break;
+                }
+                if (sibling->entries.count() + entries.count() <= sMinEntries) {
+                    foreach (const Entry& entry, entries) addEntry(sibling, entry);
+                    break;
+                }
+                // pick the entry with the greatest preference for one of the groups
+                int next = 0;
+                qreal nextD1 = 0, nextD2 = 0;
+                for (int i = 0; i < entries.count(); ++i) {
+                    qreal d1 = area(unite(rect1, entries.at(i).rect)) - area(rect1);
+                    qreal d2 = area(unite(rect2, entries.at(i).rect)) - area(rect2);
+                    if ((i == 0) || (qAbs(d1 - d2) > qAbs(nextD1 - nextD2))) {
+                        next = i;
+                        nextD1 = d1;
+                        nextD2 = d2;
+                    }
+                }
+                bool toFirst;
+                if (nextD1 != nextD2) {
+                    toFirst = (nextD1 < nextD2);
+                } else if (area(rect1) != area(rect2)) {
+                    toFirst = (area(rect1) < area(rect2));
+                } else {
+                    toFirst = (node->entries.count() <= sibling->entries.count());
+                }
+                if (toFirst) {
+                    rect1 = unite(rect1, entries.at(next).rect);
+                    addEntry(node, entries.at(next));
+                } else {
+                    rect2 = unite(rect2, entries.at(next).rect);
+                    addEntry(sibling, entries.at(next));
+                }
+                entries.remove(next);
+            }
+            return sibling;
+        }
+
+        bool findEntry(Node* node, const QRectF& rect, const T& value, Node*& leaf,
+                       int& index) const noexcept {
+            for (int i = 0; i < node->entries.count(); ++i) {
+                const Entry& entry = node->entries.at(i);
+                if (node->leaf) {
+                    if ((entry.value == value) && (entry.rect == rect)) {
+                        leaf = node;
+                        index = i;
+                        return true;
+                    }
+                } else if (contains(entry.rect, rect)) {
+                    if (findEntry(entry.child, rect, value, leaf, index)) return true;
+                }
+            }
+            return false;
+        }
+
+        void condenseTree(Node* node) noexcept {
+            // remove underfull nodes and remember their entries for reinsertion
+            QVector<Entry> orphans;
+            while (node != mRoot) {
+                Node* parent = node->parent;
+                if (node->entries.count() < sMinEntries) {
+                    for (int i = 0; i < parent->entries.count(); ++i) {
+                        if (parent->entries.at(i).child == node) {
+                            parent->entries.remove(i);
+                            break;
+                        }
+                    }
+                    collectLeafEntries(node, orphans);
+                    deleteNode(node);
+                } else {
+                    updateEntryRect(parent, node);
+                }
+                node = parent;
+            }
+
+            // shorten the tree if the root has only one child left
+            while ((!mRoot->leaf) && (mRoot->entries.count() == 1)) {
+                Node* child = mRoot->entries.first().child;
+                mRoot->entries.clear();
+                delete mRoot;
+                mRoot = child;
+                mRoot->parent = nullptr;
+            }
+            if (mRoot->entries.isEmpty()) {
+                mRoot->leaf = true;
+            }
+
+            // reinsert the orphaned entries
+            foreach (const Entry& entry, orphans) {
+                insertEntry(entry);
+            }
+        }
+
+        void findValues(const Node* node, const QRectF& rect, QList<T>& values) const noexcept {
+            foreach (const Entry& entry, node->entries) {
+                if (intersects(entry.rect, rect)) {
+                    if (node->leaf) {
+                        values.append(entry.value);
+                    } else {
+                        findValues(entry.child, rect, values);
+                    }
+                }
+            }
+        }
+
+        static void addEntry(Node* node, const Entry& entry) noexcept {
+            node->entries.append(entry);
+            if (entry.child) entry.child->parent = node;
+        }
+
+        static void updateEntryRect(Node* parent, const Node* child) noexcept {
+            for (int i = 0; i < parent->entries.count(); ++i) {
+                if (parent->entries.at(i).child == child) {
+                    parent->entries[i].rect = child->boundingRect();
+                    return;
+                }
+            }
+        }
+
+        static void collectLeafEntries(const Node* node, QVector<Entry>& entries) noexcept {
+            if (node->leaf) {
+                entries += node->entries;
+            } else {
+                foreach (const Entry& entry, node->entries) {
+                    collectLeafEntries(entry.child, entries);
+                }
+            }
+        }
+
+        static void deleteNode(Node* node) noexcept {
+            if (!node->leaf) {
+                foreach (const Entry& entry, node->entries) {
+                    deleteNode(entry.child);
+                }
+            }
+            delete node;
+        }
+
+        static QRectF unite(const QRectF& a, const QRectF& b) noexcept {
+            // Note: QRectF::united() ignores rects with zero size, so we can't use it
+            QPointF topLeft(qMin(a.left(), b.left()), qMin(a.top(), b.top()));
+            QPointF bottomRight(qMax(a.right(), b.right()), qMax(a.bottom(), b.bottom()));
+            return QRectF(topLeft, bottomRight);
+        }
+
+        static bool intersects(const QRectF& a, const QRectF& b) noexcept {
+            return (a.left() <= b.right()) && (b.left() <= a.right()) &&
+                   (a.top() <= b.bottom()) && (b.top() <= a.bottom());
+        }
+
+        static bool contains(const QRectF& outer, const QRectF& inner) noexcept {
+            return (outer.left() <= inner.left()) && (outer.right() >= inner.right()) &&
+                   (outer.top() <= inner.top()) && (outer.bottom() >= inner.bottom());
+        }
+
+        static qreal area(const QRectF& rect) noexcept {
+            return rect.width() * rect.height();
+        }
+
+
+    private: // Data
+        Node* mRoot;
+        int mSize;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace librepcb
+
+#endif // LIBREPCB_RTREE_H
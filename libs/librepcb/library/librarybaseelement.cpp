@@ -66,33 +66,9 @@ LibraryBaseElement::LibraryBaseElement(const FilePath& elementDirectory,
     mOpenedReadOnly(readOnly), mDirectoryNameMustBeUuid(dirnameMustBeUuid),
     mShortElementName(shortElementName), mLongElementName(longElementName)
 {
-    // determine the filepath to the version file
-    FilePath versionFilePath = mDirectory.getPathTo(".librepcb-" % mShortElementName);
-
-    // check if the directory is a library element
-    if (!versionFilePath.isExistingFile()) {
-        throw RuntimeError(__FILE__, __LINE__,
-            QString(tr("Directory is not a library element of type %1: \"%2\""))
-            .arg(mLongElementName, mDirectory.toNative()));
-    }
-
-    // check directory name
-    Uuid dirUuid(mDirectory.getFilename());
-    if (mDirectoryNameMustBeUuid && dirUuid.isNull()) {
-        throw RuntimeError(__FILE__, __LINE__,
-            QString(tr("Directory name is not a valid UUID: \"%1\""))
-            .arg(mDirectory.toNative()));
-    }
-
-    // read version number from version file
-    SmartVersionFile versionFile(versionFilePath, false, true);
-    mLoadingElementFileVersion = versionFile.getVersion();
-    if (mLoadingElementFileVersion != qApp->getAppVersion()) {
-        throw RuntimeError(__FILE__, __LINE__,
-            QString(tr("The library element %1 was created with a newer application "
-                       "version. You need at least LibrePCB version %2 to open it."))
-            .arg(mDirectory.toNative()).arg(mLoadingElementFileVersion.toPrettyStr(3)));
-    }
+    // check the directory and read the version file
+    mLoadingElementFileVersion = checkElementDirectory(mDirectory, mDirectoryNameMustBeUuid,
+        mShortElementName, mLongElementName); // can throw
 
     // open main file
     FilePath sexprFilePath = mDirectory.getPathTo(mLongElementName % ".lp");
@@ -100,12 +76,7 @@ LibraryBaseElement::LibraryBaseElement(const FilePath& elementDirectory,
     mLoadingFileDocument = sexprFile.parseFileAndBuildDomTree();
 
     // read attributes
-    if (mLoadingFileDocument.getChildByIndex(0).isString()) {
-        mUuid = mLoadingFileDocument.getChildByIndex(0).getValue<Uuid>(true);
-    } else {
-        // backward compatibility, remove this some time!
-        mUuid = mLoadingFileDocument.getValueByPath<Uuid>("uuid", true);
-    }
+    mUuid = readUuid(mLoadingFileDocument); // can throw
     mVersion = mLoadingFileDocument.getValueByPath<Version>("version", true);
     mAuthor = mLoadingFileDocument.getValueByPath<QString>("author", false);
     mCreated = mLoadingFileDocument.getValueByPath<QDateTime>("created", true);
@@ -117,12 +88,7 @@ LibraryBaseElement::LibraryBaseElement(const FilePath& elementDirectory,
     mKeywords.loadFromDomElement(mLoadingFileDocument);
 
     // check if the UUID equals to the directory basename
-    if (mDirectoryNameMustBeUuid && (mUuid != dirUuid)) {
-        qDebug() << mUuid << "!=" << dirUuid;
-        throw RuntimeError(__FILE__, __LINE__,
-            QString(tr("UUID mismatch between element directory and main file: \"%1\""))
-            .arg(sexprFilePath.toNative()));
-    }
+    checkUuid(mDirectory, mDirectoryNameMustBeUuid, mUuid, sexprFilePath); // can throw
 }
 
 LibraryBaseElement::~LibraryBaseElement() noexcept
@@ -149,6 +115,17 @@ QStringList LibraryBaseElement::getAllAvailableLocales() const noexcept
     return list;
 }
 
+QStringList LibraryBaseElement::Metadata::getAllAvailableLocales() const noexcept
+{
+    QStringList list;
+    list.append(names.keys());
+    list.append(descriptions.keys());
+    list.append(keywords.keys());
+    list.removeDuplicates();
+    list.sort(Qt::CaseSensitive);
+    return list;
+}
+
 /*****************************************************************************************
  *  General Methods
  ****************************************************************************************/
@@ -161,16 +138,30 @@ void LibraryBaseElement::save()
             .arg(mDirectory.toNative()));
     }
 
-    // save S-Expressions file
+    // save S-Expressions file (existing files are only overwritten if modified)
     FilePath sexprFilePath = mDirectory.getPathTo(mLongElementName % ".lp");
     SExpression root(serializeToDomElement("librepcb_" % mLongElementName));
-    QScopedPointer<SmartSExprFile> sexprFile(SmartSExprFile::create(sexprFilePath));
+    QScopedPointer<SmartSExprFile> sexprFile(sexprFilePath.isExistingFile()
+        ? new SmartSExprFile(sexprFilePath, false, false)
+        : SmartSExprFile::create(sexprFilePath));
     sexprFile->save(root, true);
 
     // save version number file
-    QScopedPointer<SmartVersionFile> versionFile(SmartVersionFile::create(
-        mDirectory.getPathTo(".librepcb-" % mShortElementName),
-        qApp->getFileFormatVersion()));
+    FilePath versionFilePath = mDirectory.getPathTo(".librepcb-" % mShortElementName);
+    QScopedPointer<SmartVersionFile> versionFile;
+    if (versionFilePath.isExistingFile()) {
+        try {
+            versionFile.reset(new SmartVersionFile(versionFilePath, false, false));
+        } catch (const Exception& e) {
+            // the file is invalid, so it will be overwritten below
+            qWarning() << "Could not open version file:" << e.getMsg();
+        }
+    }
+    if (!versionFile) {
+        versionFile.reset(SmartVersionFile::create(versionFilePath,
+                                                   qApp->getFileFormatVersion()));
+    }
+    versionFile->setVersion(qApp->getFileFormatVersion());
     versionFile->save(true);
 }
 
@@ -198,6 +189,53 @@ void LibraryBaseElement::moveIntoParentDirectory(const FilePath& parentDir)
     moveTo(elemDir);
 }
 
+/*****************************************************************************************
+ *  Static Methods
+ ****************************************************************************************/
+
+LibraryBaseElement::Metadata LibraryBaseElement::readMetadata(
+    const FilePath& elementDirectory, bool dirnameMustBeUuid,
+    const QString& shortElementName, const QString& longElementName)
+{
+    checkElementDirectory(elementDirectory, dirnameMustBeUuid, shortElementName,
+                          longElementName); // can throw
+
+    // parse only the metadata of the main file, skip geometry etc.
+    static const QSet<QString> metadataChildren = {
+        "uuid", "name", "description", "keywords", "author", "version", "created",
+        "deprecated", "category", "parent", "component", "package"
+    };
+    FilePath sexprFilePath = elementDirectory.getPathTo(longElementName % ".lp");
+    SExpression root = SExpression::parsePartially(FileUtils::readFile(sexprFilePath),
+        sexprFilePath, metadataChildren); // can throw
+
+    // read attributes
+    Metadata metadata;
+    metadata.uuid = readUuid(root); // can throw
+    metadata.version = root.getValueByPath<Version>("version", true);
+    metadata.deprecated = root.getValueByPath<bool>("deprecated", true);
+    metadata.names.loadFromDomElement(root);
+    metadata.descriptions.loadFromDomElement(root);
+    metadata.keywords.loadFromDomElement(root);
+    foreach (const SExpression& node, root.getChildren("category")) {
+        metadata.categories.insert(node.getValueOfFirstChild<Uuid>(true));
+    }
+    if (const SExpression* node = root.tryGetChildByPath("parent")) {
+        metadata.parentUuid = node->getValueOfFirstChild<Uuid>(false);
+    }
+    if (const SExpression* node = root.tryGetChildByPath("component")) {
+        metadata.componentUuid = node->getValueOfFirstChild<Uuid>(true);
+    }
+    if (const SExpression* node = root.tryGetChildByPath("package")) {
+        metadata.packageUuid = node->getValueOfFirstChild<Uuid>(true);
+    }
+
+    // check if the UUID equals to the directory basename
+    checkUuid(elementDirectory, dirnameMustBeUuid, metadata.uuid,
+              sexprFilePath); // can throw
+    return metadata;
+}
+
 /*****************************************************************************************
  *  Protected Methods
  ****************************************************************************************/
@@ -271,6 +309,67 @@ bool LibraryBaseElement::checkAttributesValidity() const noexcept
     return true;
 }
 
+/*****************************************************************************************
+ *  Static Helper Methods
+ ****************************************************************************************/
+
+Version LibraryBaseElement::checkElementDirectory(const FilePath& elementDirectory,
+                                                  bool dirnameMustBeUuid,
+                                                  const QString& shortElementName,
+                                                  const QString& longElementName)
+{
+    // determine the filepath to the version file
+    FilePath versionFilePath = elementDirectory.getPathTo(".librepcb-" % shortElementName);
+
+    // check if the directory is a library element
+    if (!versionFilePath.isExistingFile()) {
+        throw RuntimeError(__FILE__, __LINE__,
+            QString(tr("Directory is not a library element of type %1: \"%2\""))
+            .arg(longElementName, elementDirectory.toNative()));
+    }
+
+    // check directory name
+    if (dirnameMustBeUuid && Uuid(elementDirectory.getFilename()).isNull()) {
+        throw RuntimeError(__FILE__, __LINE__,
+            QString(tr("Directory name is not a valid UUID: \"%1\""))
+            .arg(elementDirectory.toNative()));
+    }
+
+    // read version number from version file
+    SmartVersionFile versionFile(versionFilePath, false, true);
+    Version fileVersion = versionFile.getVersion();
+    if (fileVersion != qApp->getAppVersion()) {
+        throw RuntimeError(__FILE__, __LINE__,
+            QString(tr("The library element %1 was created with a newer application "
+                       "version. You need at least LibrePCB version %2 to open it."))
+            .arg(elementDirectory.toNative()).arg(fileVersion.toPrettyStr(3)));
+    }
+    return fileVersion;
+}
+
+Uuid LibraryBaseElement::readUuid(const SExpression& root)
+{
+    if (root.getChildByIndex(0).isString()) {
+        return root.getChildByIndex(0).getValue<Uuid>(true);
+    } else {
+        // backward compatibility, remove this some time!
+        return root.getValueByPath<Uuid>("uuid", true);
+    }
+}
+
+void LibraryBaseElement::checkUuid(const FilePath& elementDirectory,
+                                   bool dirnameMustBeUuid, const Uuid& uuid,
+                                   const FilePath& sexprFilePath)
+{
+    Uuid dirUuid(elementDirectory.getFilename());
+    if (dirnameMustBeUuid && (uuid != dirUuid)) {
+        qDebug() << uuid << "!=" << dirUuid;
+        throw RuntimeError(__FILE__, __LINE__,
+            QString(tr("UUID mismatch between element directory and main file: \"%1\""))
+            .arg(sexprFilePath.toNative()));
+    }
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
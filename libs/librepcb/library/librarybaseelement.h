@@ -51,6 +51,29 @@ class LibraryBaseElement : public QObject, public SerializableObject
 
     public:
 
+        // Types
+
+        /**
+         * @brief Metadata of a library element, see #readMetadata()
+         *
+         * Attributes which do not exist for a specific element type (e.g. the parent
+         * UUID for devices) are left empty.
+         */
+        struct Metadata {
+            Uuid uuid;
+            Version version;
+            bool deprecated;
+            LocalizedNameMap names;
+            LocalizedDescriptionMap descriptions;
+            LocalizedKeywordsMap keywords;
+            QSet<Uuid> categories;  ///< only for librepcb::library::LibraryElement
+            Uuid parentUuid;        ///< only for librepcb::library::LibraryCategory
+            Uuid componentUuid;     ///< only for librepcb::library::Device
+            Uuid packageUuid;       ///< only for librepcb::library::Device
+
+            QStringList getAllAvailableLocales() const noexcept;
+        };
+
         // Constructors / Destructor
         LibraryBaseElement() = delete;
         LibraryBaseElement(const LibraryBaseElement& other) = delete;
@@ -102,6 +125,33 @@ class LibraryBaseElement : public QObject, public SerializableObject
         static bool isValidElementDirectory(const FilePath& dir) noexcept
         {return dir.getPathTo(".librepcb-" % ElementType::getShortElementName()).isExistingFile();}
 
+        /**
+         * @brief Read only the metadata of a library element from its directory
+         *
+         * This performs the same checks as opening the element, but the geometry and all
+         * other content of the main file is skipped while parsing and no element object
+         * is created. This is much faster than opening the element and can safely be
+         * called from any thread, e.g. to scan libraries.
+         *
+         * @tparam ElementType  The type of the element (must not be
+         *                      librepcb::library::Library)
+         *
+         * @param dir           The directory of the element
+         *
+         * @return The metadata of the element
+         *
+         * @throws Exception if the directory is not a valid element of the given type
+         */
+        template <typename ElementType>
+        static Metadata readMetadata(const FilePath& dir) {
+            return readMetadata(dir, true, ElementType::getShortElementName(),
+                                ElementType::getLongElementName()); // can throw
+        }
+        static Metadata readMetadata(const FilePath& elementDirectory,
+                                     bool dirnameMustBeUuid,
+                                     const QString& shortElementName,
+                                     const QString& longElementName);
+
 
     protected:
 
@@ -113,6 +163,15 @@ class LibraryBaseElement : public QObject, public SerializableObject
         virtual void serialize(SExpression& root) const override;
         virtual bool checkAttributesValidity() const noexcept;
 
+        // Static Helper Methods
+        static Version checkElementDirectory(const FilePath& elementDirectory,
+                                             bool dirnameMustBeUuid,
+                                             const QString& shortElementName,
+                                             const QString& longElementName);
+        static Uuid readUuid(const SExpression& root);
+        static void checkUuid(const FilePath& elementDirectory, bool dirnameMustBeUuid,
+                              const Uuid& uuid, const FilePath& sexprFilePath);
+
 
         // General Attributes
         mutable FilePath mDirectory;
@@ -22,12 +22,15 @@
  ****************************************************************************************/
 #include <QtCore>
 #include <QtWidgets>
+#include <QtConcurrent/QtConcurrent>
 #include "board.h"
 #include <librepcb/common/application.h>
 #include <librepcb/common/fileio/smartsexprfile.h>
 #include <librepcb/common/fileio/sexpression.h>
+#include <librepcb/common/undocommand.h>
 #include <librepcb/common/scopeguardlist.h>
 #include <librepcb/common/boarddesignrules.h>
+#include <librepcb/common/tracer.h>
 #include "../project.h"
 #include <librepcb/common/geometry/polygon.h>
 #include <librepcb/common/graphics/graphicsview.h>
@@ -57,6 +60,10 @@
 #include "boardusersettings.h"
 #include "boardselectionquery.h"
 #include "boardairwiresbuilder.h"
+#include "boarddesignrulecheck.h"
+#include "boardplanefragmentsbuilder.h"
+#include "boardspatialindex.h"
+#include "boardgeometrycache.h"
 #include "../circuit/netsignal.h"
 
 /*****************************************************************************************
@@ -65,17 +72,71 @@
 namespace librepcb {
 namespace project {
 
+/**
+ * @brief Sort items of net segments in the order of the net segments and their elements
+ *
+ * The spatial index returns items in arbitrary order, but the order of the board's item
+ * lists defines which item has priority if several items are at the same position.
+ */
+template <typename T>
+static void sortByNetSegmentOrder(QList<T*>& items, const QList<BI_NetSegment*>& segments,
+    const QList<T*>& (BI_NetSegment::*getElements)() const) noexcept
+{
+    QHash<T*, QPair<int, int>> keys;
+    foreach (T* item, items) {
+        BI_NetSegment& segment = item->getNetSegment();
+        keys.insert(item, qMakePair(segments.indexOf(&segment),
+                                    (segment.*getElements)().indexOf(item)));
+    }
+    std::sort(items.begin(), items.end(), [&keys](T* a, T* b) {
+        return keys.value(a) < keys.value(b);
+    });
+}
+
+/**
+ * @brief The planes of one layer to rebuild, see Board::startPlanesRebuild()
+ */
+struct PlanesRebuildChain {
+    QList<QSharedPointer<BoardPlaneFragmentsBuilder>> builders; ///< ordered by priority
+    QSharedPointer<QAtomicInt> abort;
+};
+
+static BoardPlaneFragmentsBuilder::PlaneFragments buildPlanesRebuildChain(
+    const PlanesRebuildChain& chain) noexcept
+{
+    TraceSpan span("Board::buildPlaneFragments");
+    BoardPlaneFragmentsBuilder::PlaneFragments fragments;
+    foreach (const QSharedPointer<BoardPlaneFragmentsBuilder>& builder, chain.builders) {
+        if (chain.abort->load()) break;
+        fragments.insert(&builder->getPlane(),
+                         builder->buildFragments(fragments, chain.abort.data()));
+    }
+    return fragments;
+}
+
+static void unitePlaneFragments(BoardPlaneFragmentsBuilder::PlaneFragments& result,
+    const BoardPlaneFragmentsBuilder::PlaneFragments& fragments) noexcept
+{
+    result.unite(fragments);
+}
+
 /*****************************************************************************************
  *  Constructors / Destructor
  ****************************************************************************************/
 
 Board::Board(const Board& other, const FilePath& filepath, const QString& name) :
     QObject(&other.getProject()), mProject(other.getProject()), mFilePath(filepath),
-    mIsAddedToProject(false)
+    mSavedDocumentRevision(0), mIsAddedToProject(false), mIsActivated(false),
+    mInactiveGraphicsItemsCounter(0), mPlanesRebuildDirtyAreas(0),
+    mPlanesRebuildPending(false)
 {
     try
     {
         mGraphicsScene.reset(new GraphicsScene());
+        mSpatialIndex.reset(new BoardSpatialIndex());
+        mGeometryCache.reset(new BoardGeometryCache());
+        connect(&mPlanesRebuildWatcher, &QFutureWatcher<QHash<const BI_Plane*, QVector<Path>>>::finished,
+                this, &Board::planesRebuildFinished);
 
         // copy the other board
         mFile.reset(SmartSExprFile::create(mFilePath));
@@ -143,13 +204,13 @@ Board::Board(const Board& other, const FilePath& filepath, const QString& name)
 
         // rebuildAllPlanes(); --> fragments are copied too, so no need to rebuild them
         updateErcMessages();
-        updateIcon();
 
         // emit the "attributesChanged" signal when the project has emited it
         connect(&mProject, &Project::attributesChanged, this, &Board::attributesChanged);
 
         connect(&mProject.getCircuit(), &Circuit::componentAdded, this, &Board::updateErcMessages);
         connect(&mProject.getCircuit(), &Circuit::componentRemoved, this, &Board::updateErcMessages);
+        connect(&mProject.getCircuit(), &Circuit::netSignalRemoved, this, &Board::netSignalRemoved);
 
         if (!checkAttributesValidity()) throw LogicError(__FILE__, __LINE__);
     }
@@ -157,6 +218,7 @@ Board::Board(const Board& other, const FilePath& filepath, const QString& name)
     {
         // free the allocated memory in the reverse order of their allocation...
         qDeleteAll(mErcMsgListUnplacedComponentInstances);    mErcMsgListUnplacedComponentInstances.clear();
+        qDeleteAll(mErcMsgListDesignRuleViolations);    mErcMsgListDesignRuleViolations.clear();
         qDeleteAll(mAirWires);          mAirWires.clear();
         qDeleteAll(mHoles);             mHoles.clear();
         qDeleteAll(mStrokeTexts);       mStrokeTexts.clear();
@@ -170,18 +232,28 @@ Board::Board(const Board& other, const FilePath& filepath, const QString& name)
         mGridProperties.reset();
         mLayerStack.reset();
         mFile.reset();
+        mGeometryCache.reset();
+        mSpatialIndex.reset();
         mGraphicsScene.reset();
         throw; // ...and rethrow the exception
     }
 }
 
 Board::Board(Project& project, const FilePath& filepath, bool restore,
-             bool readOnly, bool create, const QString& newName) :
-    QObject(&project), mProject(project), mFilePath(filepath), mIsAddedToProject(false)
+             bool readOnly, bool create, const QString& newName,
+             const SExpression* preparsedRoot) :
+    QObject(&project), mProject(project), mFilePath(filepath), mSavedDocumentRevision(0),
+    mIsAddedToProject(false), mIsActivated(false), mInactiveGraphicsItemsCounter(0),
+    mPlanesRebuildDirtyAreas(0), mPlanesRebuildPending(false)
 {
+    TraceSpan span("Board::Board", filepath);
     try
     {
         mGraphicsScene.reset(new GraphicsScene());
+        mSpatialIndex.reset(new BoardSpatialIndex());
+        mGeometryCache.reset(new BoardGeometryCache());
+        connect(&mPlanesRebuildWatcher, &QFutureWatcher<QHash<const BI_Plane*, QVector<Path>>>::finished,
+                this, &Board::planesRebuildFinished);
 
         // try to open/create the board file
         if (create)
@@ -216,7 +288,8 @@ Board::Board(Project& project, const FilePath& filepath, bool restore,
         else
         {
             mFile.reset(new SmartSExprFile(mFilePath, restore, readOnly));
-            SExpression root = mFile->parseFileAndBuildDomTree();
+            SExpression root = preparsedRoot ? *preparsedRoot
+                                             : mFile->parseFileAndBuildDomTree();
 
             // the board seems to be ready to open, so we will create all needed objects
 
@@ -316,15 +389,15 @@ Board::Board(Project& project, const FilePath& filepath, bool restore,
             //////////////////////////////////////////////////////////////////////////////
         }
 
-        rebuildAllPlanes();
+        // planes, airwires and the icon are built on activation (see activate())
         updateErcMessages();
-        updateIcon();
 
         // emit the "attributesChanged" signal when the project has emited it
         connect(&mProject, &Project::attributesChanged, this, &Board::attributesChanged);
 
         connect(&mProject.getCircuit(), &Circuit::componentAdded, this, &Board::updateErcMessages);
         connect(&mProject.getCircuit(), &Circuit::componentRemoved, this, &Board::updateErcMessages);
+        connect(&mProject.getCircuit(), &Circuit::netSignalRemoved, this, &Board::netSignalRemoved);
 
         if (!checkAttributesValidity()) throw LogicError(__FILE__, __LINE__);
     }
@@ -332,6 +405,7 @@ Board::Board(Project& project, const FilePath& filepath, bool restore,
     {
         // free the allocated memory in the reverse order of their allocation...
         qDeleteAll(mErcMsgListUnplacedComponentInstances);    mErcMsgListUnplacedComponentInstances.clear();
+        qDeleteAll(mErcMsgListDesignRuleViolations);    mErcMsgListDesignRuleViolations.clear();
         qDeleteAll(mAirWires);          mAirWires.clear();
         qDeleteAll(mHoles);             mHoles.clear();
         qDeleteAll(mStrokeTexts);       mStrokeTexts.clear();
@@ -345,6 +419,8 @@ Board::Board(Project& project, const FilePath& filepath, bool restore,
         mGridProperties.reset();
         mLayerStack.reset();
         mFile.reset();
+        mGeometryCache.reset();
+        mSpatialIndex.reset();
         mGraphicsScene.reset();
         throw; // ...and rethrow the exception
     }
@@ -354,7 +430,12 @@ Board::~Board() noexcept
 {
     Q_ASSERT(!mIsAddedToProject);
 
+    // abort a running plane rebuild
+    cancelPlanesRebuild();
+    mPlanesRebuildFuture.waitForFinished();
+
     qDeleteAll(mErcMsgListUnplacedComponentInstances);    mErcMsgListUnplacedComponentInstances.clear();
+    qDeleteAll(mErcMsgListDesignRuleViolations);    mErcMsgListDesignRuleViolations.clear();
 
     // delete all items
     qDeleteAll(mAirWires);          mAirWires.clear();
@@ -371,6 +452,8 @@ Board::~Board() noexcept
     mGridProperties.reset();
     mLayerStack.reset();
     mFile.reset();
+    mGeometryCache.reset();
+    mSpatialIndex.reset();
     mGraphicsScene.reset();
 }
 
@@ -391,6 +474,32 @@ bool Board::isEmpty() const noexcept
 QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
 {
     QPointF scenePosPx = pos.toPxQPointF();
+    QSet<BI_Base*> candidates;
+    QMap<Uuid, BI_Device*> devices;
+    QList<BI_StrokeText*> texts;
+    foreach (BI_Base* item, mSpatialIndex->getItems(QRectF(scenePosPx, QSizeF()))) {
+        candidates.insert(item);
+        if (item->getType() == BI_Base::Type_t::Footprint) {
+            BI_Device& device = static_cast<BI_Footprint*>(item)->getDeviceInstance();
+            devices.insert(device.getComponentInstanceUuid(), &device);
+        } else if (item->getType() == BI_Base::Type_t::FootprintPad) {
+            BI_Device& device = static_cast<BI_FootprintPad*>(item)->getFootprint().getDeviceInstance();
+            devices.insert(device.getComponentInstanceUuid(), &device);
+        } else if (item->getType() == BI_Base::Type_t::StrokeText) {
+            BI_StrokeText* text = static_cast<BI_StrokeText*>(item);
+            if (text->getFootprint()) {
+                BI_Device& device = text->getFootprint()->getDeviceInstance();
+                devices.insert(device.getComponentInstanceUuid(), &device);
+            } else {
+                texts.append(text);
+            }
+        }
+    }
+    // restore the order of the board's item lists (see sortByNetSegmentOrder())
+    std::sort(texts.begin(), texts.end(), [this](BI_StrokeText* a, BI_StrokeText* b) {
+        return mStrokeTexts.indexOf(a) < mStrokeTexts.indexOf(b);
+    });
+
     QList<BI_Base*> list;   // Note: The order of adding the items is very important (the
                             // top most item must appear as the first item in the list)!
     // vias
@@ -406,9 +515,10 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
         list.append(netline);
     }
     // footprints & pads
-    foreach (BI_Device* device, mDeviceInstances) {
+    foreach (BI_Device* device, devices) {
         BI_Footprint& footprint = device->getFootprint();
-        if (footprint.isSelectable() && footprint.getGrabAreaScenePx().contains(scenePosPx)) {
+        if (candidates.contains(&footprint) && footprint.isSelectable()
+            && footprint.getGrabAreaScenePx().contains(scenePosPx)) {
             if (footprint.getIsMirrored()) {
                 list.append(&footprint);
             } else {
@@ -416,7 +526,8 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
             }
         }
         foreach (BI_FootprintPad* pad, footprint.getPads()) {
-            if (pad->isSelectable() && pad->getGrabAreaScenePx().contains(scenePosPx)) {
+            if (candidates.contains(pad) && pad->isSelectable()
+                && pad->getGrabAreaScenePx().contains(scenePosPx)) {
                 if (pad->getIsMirrored()) {
                     list.append(pad);
                 } else {
@@ -424,8 +535,9 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
                 }
             }
         }
-        foreach (BI_StrokeText* text, device->getFootprint().getStrokeTexts()) {
-            if (text->isSelectable() && text->getGrabAreaScenePx().contains(scenePosPx)) {
+        foreach (BI_StrokeText* text, footprint.getStrokeTexts()) {
+            if (candidates.contains(text) && text->isSelectable()
+                && text->getGrabAreaScenePx().contains(scenePosPx)) {
                 if (GraphicsLayer::isTopLayer(text->getText().getLayerName())) {
                     list.prepend(text);
                 } else {
@@ -447,7 +559,7 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
         }
     }
     // texts
-    foreach (BI_StrokeText* text, mStrokeTexts) {
+    foreach (BI_StrokeText* text, texts) {
         if (text->isSelectable() && text->getGrabAreaScenePx().contains(scenePosPx)) {
             list.append(text);
         }
@@ -463,55 +575,86 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept
 
 QList<BI_Via*> Board::getViasAtScenePos(const Point& pos, const NetSignal* netsignal) const noexcept
 {
+    QPointF scenePosPx = pos.toPxQPointF();
     QList<BI_Via*> list;
-    foreach (BI_NetSegment* segment, mNetSegments) {
-        if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-            segment->getViasAtScenePos(pos, list);
+    foreach (BI_Base* item, mSpatialIndex->getItems(QRectF(scenePosPx, QSizeF()))) {
+        if (item->getType() != BI_Base::Type_t::Via) continue;
+        BI_Via* via = static_cast<BI_Via*>(item);
+        if (via->isSelectable() && via->getGrabAreaScenePx().contains(scenePosPx)
+            && ((!netsignal) || (&via->getNetSignalOfNetSegment() == netsignal)))
+        {
+            list.append(via);
         }
     }
+    sortByNetSegmentOrder(list, mNetSegments, &BI_NetSegment::getVias);
     return list;
 }
 
 QList<BI_NetPoint*> Board::getNetPointsAtScenePos(const Point& pos, const GraphicsLayer* layer,
                                                   const NetSignal* netsignal) const noexcept
 {
+    QPointF scenePosPx = pos.toPxQPointF();
+    QString layerName = layer ? layer->getName() : QString();
     QList<BI_NetPoint*> list;
-    foreach (BI_NetSegment* segment, mNetSegments) {
-        if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-            segment->getNetPointsAtScenePos(pos, layer, list);
+    foreach (BI_Base* item, mSpatialIndex->getItems(QRectF(scenePosPx, QSizeF()), layerName)) {
+        if (item->getType() != BI_Base::Type_t::NetPoint) continue;
+        BI_NetPoint* netpoint = static_cast<BI_NetPoint*>(item);
+        if (netpoint->isSelectable() && netpoint->getGrabAreaScenePx().contains(scenePosPx)
+            && ((!layer) || (&netpoint->getLayer() == layer))
+            && ((!netsignal) || (&netpoint->getNetSignalOfNetSegment() == netsignal)))
+        {
+            list.append(netpoint);
         }
     }
+    sortByNetSegmentOrder(list, mNetSegments, &BI_NetSegment::getNetPoints);
     return list;
 }
 
 QList<BI_NetLine*> Board::getNetLinesAtScenePos(const Point& pos, const GraphicsLayer* layer,
                                                 const NetSignal* netsignal) const noexcept
 {
+    QPointF scenePosPx = pos.toPxQPointF();
+    QString layerName = layer ? layer->getName() : QString();
     QList<BI_NetLine*> list;
-    foreach (BI_NetSegment* segment, mNetSegments) {
-        if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-            segment->getNetLinesAtScenePos(pos, layer, list);
+    foreach (BI_Base* item, mSpatialIndex->getItems(QRectF(scenePosPx, QSizeF()), layerName)) {
+        if (item->getType() != BI_Base::Type_t::NetLine) continue;
+        BI_NetLine* netline = static_cast<BI_NetLine*>(item);
+        if (netline->isSelectable() && netline->getGrabAreaScenePx().contains(scenePosPx)
+            && ((!layer) || (&netline->getLayer() == layer))
+            && ((!netsignal) || (&netline->getNetSignalOfNetSegment() == netsignal)))
+        {
+            list.append(netline);
         }
     }
+    sortByNetSegmentOrder(list, mNetSegments, &BI_NetSegment::getNetLines);
     return list;
 }
 
 QList<BI_FootprintPad*> Board::getPadsAtScenePos(const Point& pos, const GraphicsLayer* layer,
                                                  const NetSignal* netsignal) const noexcept
 {
+    QPointF scenePosPx = pos.toPxQPointF();
+    QString layerName = layer ? layer->getName() : QString();
     QList<BI_FootprintPad*> list;
-    foreach (BI_Device* device, mDeviceInstances)
-    {
-        foreach (BI_FootprintPad* pad, device->getFootprint().getPads())
+    foreach (BI_Base* item, mSpatialIndex->getItems(QRectF(scenePosPx, QSizeF()), layerName)) {
+        if (item->getType() != BI_Base::Type_t::FootprintPad) continue;
+        BI_FootprintPad* pad = static_cast<BI_FootprintPad*>(item);
+        if (pad->isSelectable() && pad->getGrabAreaScenePx().contains(scenePosPx)
+            && ((!layer) || (pad->isOnLayer(layer->getName())))
+            && ((!netsignal) || (pad->getCompSigInstNetSignal() == netsignal)))
         {
-            if (pad->isSelectable() && pad->getGrabAreaScenePx().contains(pos.toPxQPointF())
-                && ((!layer) || (pad->isOnLayer(layer->getName())))
-                && ((!netsignal) || (pad->getCompSigInstNetSignal() == netsignal)))
-            {
-                list.append(pad);
-            }
+            list.append(pad);
         }
     }
+    // same order as iterating over all devices and their pads
+    std::sort(list.begin(), list.end(), [](BI_FootprintPad* a, BI_FootprintPad* b) {
+        const Uuid& deviceA = a->getFootprint().getDeviceInstance().getComponentInstanceUuid();
+        const Uuid& deviceB = b->getFootprint().getDeviceInstance().getComponentInstanceUuid();
+        if (deviceA != deviceB) {
+            return deviceA < deviceB;
+        }
+        return a->getLibPadUuid() < b->getLibPadUuid();
+    });
     return list;
 }
 
@@ -542,6 +685,13 @@ QList<BI_Base*> Board::getAllItems() const noexcept
 void Board::setGridProperties(const GridProperties& grid) noexcept
 {
     *mGridProperties = grid;
+    mSavedDocumentRevision = 0; // not modified by an undo command
+}
+
+void Board::setFabricationOutputSettings(const BoardFabricationOutputSettings& s) noexcept
+{
+    *mFabricationOutputSettings = s;
+    mSavedDocumentRevision = 0; // not modified by an undo command
 }
 
 /*****************************************************************************************
@@ -650,12 +800,57 @@ void Board::removePlane(BI_Plane& plane)
 
 void Board::rebuildAllPlanes() noexcept
 {
-    QList<BI_Plane*> planes = mPlanes;
-    qSort(planes.begin(), planes.end(),
-          [](const BI_Plane* p1, const BI_Plane* p2)
-          {return !(*p1 < *p2);}); // sort by priority (highest priority first)
-    foreach (BI_Plane* plane, planes) {
-        plane->rebuild();
+    TraceSpan span("Board::rebuildAllPlanes");
+    startPlanesRebuild(getPlanesSortedByPriority(), mDirtyPlaneAreasPx.count());
+    waitForPlanesRebuild();
+}
+
+void Board::invalidatePlanes(const QRectF& areaPx) noexcept
+{
+    if (!areaPx.isNull()) {
+        mDirtyPlaneAreasPx.append(areaPx);
+    }
+}
+
+void Board::rebuildDirtyPlanes() noexcept
+{
+    if (mDirtyPlaneAreasPx.isEmpty()) {
+        return;
+    }
+
+    // outlines of planes to rebuild, they contain all old and new fragments of these
+    // planes and thus may affect all planes with lower priority on the same layer
+    QHash<QString, QVector<QRectF>> rebuiltPlaneAreasPx;
+    auto intersects = [](const QVector<QRectF>& areas, const QRectF& rect) {
+        foreach (const QRectF& area, areas) {
+            if (area.intersects(rect)) return true;
+        }
+        return false;
+    };
+
+    QList<BI_Plane*> planes;
+    foreach (BI_Plane* plane, getPlanesSortedByPriority()) {
+        qreal clearance = plane->getMinClearance().toPx();
+        QRectF outline = plane->getOutline().toQPainterPathPx().boundingRect();
+        QRectF planeArea = outline.adjusted(-clearance, -clearance, clearance, clearance);
+        QVector<QRectF>& layerAreas = rebuiltPlaneAreasPx[plane->getLayerName()];
+        if (intersects(mDirtyPlaneAreasPx, planeArea) || intersects(layerAreas, planeArea)) {
+            planes.append(plane);
+            layerAreas.append(outline);
+        }
+    }
+    if (!planes.isEmpty()) {
+        startPlanesRebuild(planes, mDirtyPlaneAreasPx.count());
+    } else if (!mPlanesRebuildPending) {
+        mDirtyPlaneAreasPx.clear(); // no plane affected at all
+    }
+}
+
+void Board::waitForPlanesRebuild() noexcept
+{
+    if (mPlanesRebuildPending) {
+        mPlanesRebuildFuture.waitForFinished();
+        applyPlanesRebuildResult();
     }
 }
 
@@ -740,24 +935,50 @@ void Board::triggerAirWiresRebuild() noexcept
     if (!mIsAddedToProject) {
         return;
     }
+    if (!mIsActivated) {
+        // all airwires will be built on activation anyway
+        mScheduledNetSignalsForAirWireRebuild.clear();
+        return;
+    }
 
     try {
         foreach (NetSignal* netsignal, mScheduledNetSignalsForAirWireRebuild) {
-            // remove old airwires
-            while (BI_AirWire* airWire = mAirWires.take(netsignal)) {
-                airWire->removeFromBoard(); // can throw
-                delete airWire;
+            // calculate new airwires (the builder of each net is kept to allow
+            // incremental updates)
+            QHash<QPair<Point, Point>, int> newAirWires;
+            if (netsignal && netsignal->isAddedToCircuit()) {
+                QSharedPointer<BoardAirWiresBuilder> builder = mAirWiresBuilders.value(netsignal);
+                if (!builder) {
+                    builder.reset(new BoardAirWiresBuilder(*this, *netsignal));
+                    mAirWiresBuilders.insert(netsignal, builder);
+                }
+                foreach (const auto& points, builder->buildAirWires()) {
+                    newAirWires[points] += 1;
+                }
+            } else {
+                mAirWiresBuilders.remove(netsignal);
             }
 
-            if (netsignal && netsignal->isAddedToCircuit()) {
-                // calculate new airwires
-                BoardAirWiresBuilder builder(*this, *netsignal);
-                QVector<QPair<Point, Point>> airwires = builder.buildAirWires();
+            // remove old airwires which are no longer needed, keep all others
+            foreach (BI_AirWire* airWire, mAirWires.values(netsignal)) {
+                QPair<Point, Point> points(airWire->getP1(), airWire->getP2());
+                QPair<Point, Point> reversed(airWire->getP2(), airWire->getP1());
+                if (newAirWires.value(points) > 0) {
+                    newAirWires[points] -= 1;
+                } else if (newAirWires.value(reversed) > 0) {
+                    newAirWires[reversed] -= 1;
+                } else {
+                    mAirWires.remove(netsignal, airWire);
+                    airWire->removeFromBoard(); // can throw
+                    delete airWire;
+                }
+            }
 
-                // add new airwires
-                foreach (const auto& points, airwires) {
+            // add new airwires
+            for (auto it = newAirWires.constBegin(); it != newAirWires.constEnd(); ++it) {
+                for (int i = 0; i < it.value(); ++i) {
                     QScopedPointer<BI_AirWire> airWire(
-                        new BI_AirWire(*this, *netsignal, points.first, points.second));
+                        new BI_AirWire(*this, *netsignal, it.key().first, it.key().second));
                     airWire->addToBoard(); // can throw
                     mAirWires.insertMulti(netsignal, airWire.take());
                 }
@@ -771,17 +992,102 @@ void Board::triggerAirWiresRebuild() noexcept
 
 void Board::forceAirWiresRebuild() noexcept
 {
+    TraceSpan span("Board::forceAirWiresRebuild");
     mScheduledNetSignalsForAirWireRebuild.unite(mProject.getCircuit().getNetSignals().values().toSet());
     mScheduledNetSignalsForAirWireRebuild.unite(mAirWires.keys().toSet());
     triggerAirWiresRebuild();
 }
 
+/*****************************************************************************************
+ *  Graphics Methods
+ ****************************************************************************************/
+
+void Board::addGraphicsItem(QGraphicsItem& item) noexcept
+{
+    if (mIsActivated) {
+        mGraphicsScene->addItem(item);
+    } else {
+        Q_ASSERT(!mInactiveGraphicsItems.contains(&item));
+        mInactiveGraphicsItems.insert(&item, mInactiveGraphicsItemsCounter++);
+    }
+}
+
+void Board::removeGraphicsItem(QGraphicsItem& item) noexcept
+{
+    if (mIsActivated) {
+        mGraphicsScene->removeItem(item);
+    } else {
+        bool removed = mInactiveGraphicsItems.remove(&item);
+        Q_ASSERT(removed); Q_UNUSED(removed);
+    }
+}
+
 /*****************************************************************************************
  *  General Methods
  ****************************************************************************************/
 
+void Board::activate() noexcept
+{
+    if (mIsActivated) {
+        return;
+    }
+    TraceSpan span("Board::activate");
+    mIsActivated = true;
+
+    // populate the graphics scene in the original order to keep the stacking order of
+    // items with the same Z value
+    QVector<QPair<int, QGraphicsItem*>> items;
+    items.reserve(mInactiveGraphicsItems.count());
+    for (auto it = mInactiveGraphicsItems.constBegin();
+         it != mInactiveGraphicsItems.constEnd(); ++it) {
+        items.append(qMakePair(it.value(), it.key()));
+    }
+    std::sort(items.begin(), items.end());
+    foreach (const auto& item, items) {
+        mGraphicsScene->addItem(*item.second);
+    }
+    mInactiveGraphicsItems.clear();
+
+    // airwires depend on the plane fragments, thus build planes first
+    rebuildAllPlanes();
+    forceAirWiresRebuild();
+    updateIcon();
+}
+
+int Board::runDesignRuleCheck() noexcept
+{
+    // make sure the current plane fragments are checked
+    waitForPlanesRebuild();
+
+    BoardDesignRuleCheck drc(*this, *mDesignRules);
+    QList<BoardDesignRuleCheck::Violation> violations = drc.execute();
+
+    // keep messages of still existing violations to preserve their ignore state
+    QHash<QString, ErcMsg*> oldMessages = mErcMsgListDesignRuleViolations;
+    mErcMsgListDesignRuleViolations.clear();
+    if (mIsAddedToProject) {
+        foreach (const BoardDesignRuleCheck::Violation& violation, violations) {
+            QString key = QString("%1/%2").arg(violation.ownerKey, violation.msgKey);
+            QString msg = QString("%1 (Board: %2)").arg(violation.message, mName);
+            ErcMsg* ercMsg = oldMessages.take(key);
+            if (ercMsg) {
+                ercMsg->setMsg(msg);
+            } else {
+                ercMsg = new ErcMsg(mProject, *this, QString("%1/%2").arg(mUuid.toStr(),
+                    violation.ownerKey), violation.msgKey, ErcMsg::ErcMsgType_t::BoardError,
+                    msg);
+                ercMsg->setVisible(true);
+            }
+            mErcMsgListDesignRuleViolations.insert(key, ercMsg);
+        }
+    }
+    qDeleteAll(oldMessages);
+    return violations.count();
+}
+
 void Board::addToProject()
 {
+    TraceSpan span("Board::addToProject");
     if (mIsAddedToProject) {
         throw LogicError(__FILE__, __LINE__);
     }
@@ -793,7 +1099,9 @@ void Board::addToProject()
         sgl.add([item](){item->removeFromBoard();});
     }
     mIsAddedToProject = true;
-    forceAirWiresRebuild();
+    if (mIsActivated) {
+        forceAirWiresRebuild();
+    }
     updateErcMessages();
     sgl.dismiss();
 }
@@ -815,7 +1123,7 @@ void Board::removeFromProject()
     sgl.dismiss();
 }
 
-bool Board::save(bool toOriginal, QStringList& errors) noexcept
+bool Board::save(bool toOriginal, QStringList& errors, AsyncFileWriter* writer) noexcept
 {
     bool success = true;
 
@@ -824,8 +1132,18 @@ bool Board::save(bool toOriginal, QStringList& errors) noexcept
     {
         if (mIsAddedToProject)
         {
-            SExpression doc(serializeToDomElement("librepcb_board"));
-            mFile->save(doc, toOriginal);
+            // Serializing is only needed if the board might have been modified by an
+            // undo command (or a setter) since the last time it was saved.
+            quint64 revision = UndoCommand::getModificationCounter();
+            if (mSavedDocumentRevision != revision) {
+                mSavedDocument = serializeToDomElement("librepcb_board"); // can throw
+                mSavedDocumentRevision = revision;
+            }
+            if (writer) {
+                mFile->save(mSavedDocument, toOriginal, *writer); // in a worker thread
+            } else {
+                mFile->save(mSavedDocument, toOriginal);
+            }
         }
         else
         {
@@ -848,6 +1166,7 @@ bool Board::save(bool toOriginal, QStringList& errors) noexcept
 
 void Board::showInView(GraphicsView& view) noexcept
 {
+    activate();
     view.setScene(mGraphicsScene.data());
 }
 
@@ -856,21 +1175,28 @@ void Board::setSelectionRect(const Point& p1, const Point& p2, bool updateItems)
     mGraphicsScene->setSelectionRect(p1, p2);
     if (updateItems) {
         QRectF rectPx = QRectF(p1.toPxQPointF(), p2.toPxQPointF()).normalized();
-        foreach (BI_Device* component, mDeviceInstances) {
-            BI_Footprint& footprint = component->getFootprint();
-            bool selectFootprint = footprint.isSelectable() && footprint.getGrabAreaScenePx().intersects(rectPx);
-            footprint.setSelected(selectFootprint);
-            foreach (BI_FootprintPad* pad, footprint.getPads()) {
-                bool selectPad = pad->isSelectable() && pad->getGrabAreaScenePx().intersects(rectPx);
-                pad->setSelected(selectFootprint || selectPad);
-            }
-            foreach (BI_StrokeText* text, footprint.getStrokeTexts()) {
-                bool selectText = text->isSelectable() && text->getGrabAreaScenePx().intersects(rectPx);
-                text->setSelected(selectFootprint || selectText);
+        // items which were inside the previous rect may need to be deselected, all other
+        // items keep their selection state
+        QList<BI_Base*> candidates = mSpatialIndex->getItems(rectPx.united(mSelectionRectPx));
+        mSelectionRectPx = rectPx;
+        // footprints first since they (de)select their pads and texts too
+        foreach (BI_Base* item, candidates) {
+            if (item->getType() == BI_Base::Type_t::Footprint) {
+                item->setSelected(item->isSelectable()
+                                  && item->getGrabAreaScenePx().intersects(rectPx));
             }
         }
-        foreach (BI_NetSegment* segment, mNetSegments) {
-            segment->setSelectionRect(rectPx);
+        foreach (BI_Base* item, candidates) {
+            bool select = item->isSelectable() && item->getGrabAreaScenePx().intersects(rectPx);
+            if (item->getType() == BI_Base::Type_t::Footprint) {
+                continue;
+            } else if (item->getType() == BI_Base::Type_t::FootprintPad) {
+                select = select || static_cast<BI_FootprintPad*>(item)->getFootprint().isSelected();
+            } else if (item->getType() == BI_Base::Type_t::StrokeText) {
+                BI_Footprint* footprint = static_cast<BI_StrokeText*>(item)->getFootprint();
+                select = select || (footprint && footprint->isSelected());
+            }
+            item->setSelected(select);
         }
         foreach (BI_Plane* plane, mPlanes) {
             bool select = plane->isSelectable() && plane->getGrabAreaScenePx().intersects(rectPx);
@@ -880,14 +1206,12 @@ void Board::setSelectionRect(const Point& p1, const Point& p2, bool updateItems)
             bool select = polygon->isSelectable() && polygon->getGrabAreaScenePx().intersects(rectPx);
             polygon->setSelected(select);
         }
-        foreach (BI_StrokeText* text, mStrokeTexts) {
-            bool select = text->isSelectable() && text->getGrabAreaScenePx().intersects(rectPx);
-            text->setSelected(select);
-        }
         foreach (BI_Hole* hole, mHoles) {
             bool select = hole->isSelectable() && hole->getGrabAreaScenePx().intersects(rectPx);
             hole->setSelected(select);
         }
+    } else {
+        mSelectionRectPx = QRectF();
     }
 }
 
@@ -953,6 +1277,80 @@ void Board::updateIcon() noexcept
     mIcon = QIcon(pixmap);
 }
 
+QList<BI_Plane*> Board::getPlanesSortedByPriority() const noexcept
+{
+    QList<BI_Plane*> planes = mPlanes;
+    qSort(planes.begin(), planes.end(),
+          [](const BI_Plane* p1, const BI_Plane* p2)
+          {return !(*p1 < *p2);}); // sort by priority (highest priority first)
+    return planes;
+}
+
+void Board::startPlanesRebuild(const QList<BI_Plane*>& planes, int dirtyAreas) noexcept
+{
+    cancelPlanesRebuild();
+
+    // Take a snapshot of all planes to build (must be done in this thread). Planes only
+    // depend on other planes on the same layer, so the planes of each layer are built
+    // (in the order of the passed list, i.e. by priority) in a separate task. All tasks
+    // are started from here and no task waits for another one, so they can't starve
+    // the thread pool.
+    QSharedPointer<QAtomicInt> abortFlag(new QAtomicInt(0));
+    QMap<QString, PlanesRebuildChain> chains;
+    foreach (BI_Plane* plane, planes) {
+        PlanesRebuildChain& chain = chains[plane->getLayerName()];
+        chain.builders.append(QSharedPointer<BoardPlaneFragmentsBuilder>(
+            new BoardPlaneFragmentsBuilder(*plane)));
+        chain.abort = abortFlag;
+    }
+    mPlanesRebuildFuture = QtConcurrent::mappedReduced(chains.values(),
+        buildPlanesRebuildChain, unitePlaneFragments);
+    mPlanesRebuildAbort = abortFlag;
+    mPlanesRebuildPlanes = planes;
+    mPlanesRebuildDirtyAreas = dirtyAreas;
+    mPlanesRebuildPending = true;
+    mPlanesRebuildWatcher.setFuture(mPlanesRebuildFuture);
+}
+
+void Board::cancelPlanesRebuild() noexcept
+{
+    // the worker threads may still run for a while, but the result will be discarded
+    if (mPlanesRebuildAbort) {
+        mPlanesRebuildAbort->store(1);
+    }
+    mPlanesRebuildPlanes.clear();
+    mPlanesRebuildPending = false;
+}
+
+void Board::planesRebuildFinished() noexcept
+{
+    // ignore results of cancelled or already applied rebuilds
+    if (mPlanesRebuildPending && mPlanesRebuildFuture.isFinished()) {
+        applyPlanesRebuildResult();
+        triggerAirWiresRebuild();
+    }
+}
+
+void Board::applyPlanesRebuildResult() noexcept
+{
+    Q_ASSERT(mPlanesRebuildPending && mPlanesRebuildFuture.isFinished());
+    BoardPlaneFragmentsBuilder::PlaneFragments fragments = mPlanesRebuildFuture.result();
+    foreach (BI_Plane* plane, mPlanesRebuildPlanes) {
+        if (mPlanes.contains(plane)) { // the plane might be removed in the meantime
+            plane->setFragments(fragments.value(plane));
+        }
+    }
+    mDirtyPlaneAreasPx.remove(0, qMin(mPlanesRebuildDirtyAreas, mDirtyPlaneAreasPx.count()));
+    mPlanesRebuildPlanes.clear();
+    mPlanesRebuildPending = false;
+}
+
+void Board::netSignalRemoved(NetSignal& netsignal) noexcept
+{
+    // the builder keeps a reference to the net signal, so it must not outlive it
+    mAirWiresBuilders.remove(&netsignal);
+}
+
 bool Board::checkAttributesValidity() const noexcept
 {
     if (mUuid.isNull())     return false;
@@ -1019,6 +1417,8 @@ void Board::updateErcMessages() noexcept
     {
         qDeleteAll(mErcMsgListUnplacedComponentInstances);
         mErcMsgListUnplacedComponentInstances.clear();
+        qDeleteAll(mErcMsgListDesignRuleViolations);
+        mErcMsgListDesignRuleViolations.clear();
     }
 }
 
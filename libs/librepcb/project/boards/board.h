@@ -30,6 +30,7 @@
 #include <librepcb/common/fileio/serializableobject.h>
 #include <librepcb/common/units/all_length_units.h>
 #include <librepcb/common/fileio/filepath.h>
+#include <librepcb/common/geometry/path.h>
 #include <librepcb/common/exceptions.h>
 #include <librepcb/common/uuid.h>
 #include "../erc/if_ercmsgprovider.h"
@@ -43,6 +44,8 @@ class GridProperties;
 class GraphicsView;
 class GraphicsScene;
 class SmartSExprFile;
+class AsyncFileWriter;
+class SExpression;
 class GraphicsLayer;
 class BoardDesignRules;
 
@@ -66,6 +69,9 @@ class BoardLayerStack;
 class BoardFabricationOutputSettings;
 class BoardUserSettings;
 class BoardSelectionQuery;
+class BoardSpatialIndex;
+class BoardGeometryCache;
+class BoardAirWiresBuilder;
 
 /*****************************************************************************************
  *  Class Board
@@ -112,8 +118,9 @@ class Board final : public QObject, public AttributeProvider,
         Board() = delete;
         Board(const Board& other) = delete;
         Board(const Board& other, const FilePath& filepath, const QString& name);
-        Board(Project& project, const FilePath& filepath, bool restore, bool readOnly) :
-            Board(project, filepath, restore, readOnly, false, QString()) {}
+        Board(Project& project, const FilePath& filepath, bool restore, bool readOnly,
+              const SExpression* root = nullptr) :
+            Board(project, filepath, restore, readOnly, false, QString(), root) {}
         ~Board() noexcept;
 
         // Getters: General
@@ -121,11 +128,13 @@ class Board final : public QObject, public AttributeProvider,
         const FilePath& getFilePath() const noexcept {return mFilePath;}
         const GridProperties& getGridProperties() const noexcept {return *mGridProperties;}
         GraphicsScene& getGraphicsScene () const noexcept {return *mGraphicsScene;}
+        bool isActivated() const noexcept {return mIsActivated;}
+        BoardSpatialIndex& getSpatialIndex() const noexcept {return *mSpatialIndex;}
+        BoardGeometryCache& getGeometryCache() const noexcept {return *mGeometryCache;}
         BoardLayerStack& getLayerStack() noexcept {return *mLayerStack;}
         const BoardLayerStack& getLayerStack() const noexcept {return *mLayerStack;}
         BoardDesignRules& getDesignRules() noexcept {return *mDesignRules;}
         const BoardDesignRules& getDesignRules() const noexcept {return *mDesignRules;}
-        BoardFabricationOutputSettings& getFabricationOutputSettings() noexcept {return *mFabricationOutputSettings;}
         const BoardFabricationOutputSettings& getFabricationOutputSettings() const noexcept {return *mFabricationOutputSettings;}
         bool isEmpty() const noexcept;
         QList<BI_Base*> getItemsAtScenePos(const Point& pos) const noexcept;
@@ -140,6 +149,7 @@ class Board final : public QObject, public AttributeProvider,
 
         // Setters: General
         void setGridProperties(const GridProperties& grid) noexcept;
+        void setFabricationOutputSettings(const BoardFabricationOutputSettings& s) noexcept;
 
         // Getters: Attributes
         const Uuid& getUuid() const noexcept {return mUuid;}
@@ -163,8 +173,50 @@ class Board final : public QObject, public AttributeProvider,
         const QList<BI_Plane*>& getPlanes() const noexcept {return mPlanes;}
         void addPlane(BI_Plane& plane);
         void removePlane(BI_Plane& plane);
+
+        /**
+         * @brief Rebuild all planes (blocking)
+         *
+         * A running asynchronous rebuild (see #rebuildDirtyPlanes()) is cancelled.
+         */
         void rebuildAllPlanes() noexcept;
 
+        /**
+         * @brief Mark an area of the board as modified for the next plane refill
+         *
+         * @param areaPx    The modified area in scene pixels, without any clearance
+         *                  (a null rect is ignored).
+         *
+         * @see #rebuildDirtyPlanes()
+         */
+        void invalidatePlanes(const QRectF& areaPx) noexcept;
+
+        /**
+         * @brief Rebuild only the planes which are affected by modified areas
+         *
+         * All planes whose outline (plus clearance) intersects with an area passed to
+         * #invalidatePlanes() since the last rebuild are rebuilt, together with all
+         * lower priority planes on the same layer which overlap with the outline of a
+         * rebuilt plane.
+         * All other planes keep their fragments since they would not change anyway, so
+         * the result is identical to #rebuildAllPlanes().
+         *
+         * The fragments are built asynchronously in worker threads from a snapshot of the
+         * board, the planes keep their current fragments until the new ones are
+         * available. Calling this method again while a rebuild is still running cancels
+         * the running rebuild, i.e. its (outdated) result is discarded.
+         *
+         * @see #waitForPlanesRebuild()
+         */
+        void rebuildDirtyPlanes() noexcept;
+
+        /**
+         * @brief Block until a running asynchronous plane rebuild is finished
+         *
+         * Afterwards the result of the rebuild is assigned to the planes.
+         */
+        void waitForPlanesRebuild() noexcept;
+
         // Polygon Methods
         const QList<BI_Polygon*>& getPolygons() const noexcept {return mPolygons;}
         void addPolygon(BI_Polygon& polygon);
@@ -185,10 +237,62 @@ class Board final : public QObject, public AttributeProvider,
         void triggerAirWiresRebuild() noexcept;
         void forceAirWiresRebuild() noexcept;
 
+        // Design Rule Check Methods
+
+        /**
+         * @brief Check the board against its design rules (blocking)
+         *
+         * The checks are distributed to multiple threads, see
+         * librepcb::project::BoardDesignRuleCheck. All violations are reported as
+         * ERC messages of type librepcb::project::ErcMsg::ErcMsgType_t::BoardError. The
+         * messages of the previous run are kept (including their ignore state) as long
+         * as the violation still exists.
+         *
+         * @return The number of found violations
+         */
+        int runDesignRuleCheck() noexcept;
+
+        // Graphics Methods
+
+        /**
+         * @brief Add a graphics item to the graphics scene of this board
+         *
+         * As long as the board is not activated (see #activate()), the item is only
+         * remembered and added to the scene on activation.
+         *
+         * @param item  The item to add (must not be added already)
+         */
+        void addGraphicsItem(QGraphicsItem& item) noexcept;
+
+        /**
+         * @brief Remove a graphics item from the graphics scene of this board
+         *
+         * @param item  The item to remove (must be added with #addGraphicsItem())
+         */
+        void removeGraphicsItem(QGraphicsItem& item) noexcept;
+
         // General Methods
+
+        /**
+         * @brief Build everything which is only needed to display the board (blocking)
+         *
+         * Boards are loaded lazily: until a board is activated, only its model data is
+         * available. The graphics scene is not populated, airwires and plane fragments
+         * are not built and the icon is not rendered. This makes opening projects with
+         * many boards much faster.
+         *
+         * Activating an already activated board does nothing. There is no way to
+         * deactivate a board.
+         *
+         * @note #showInView() activates the board automatically. Exports which need
+         *       plane fragments have to call #rebuildAllPlanes() anyway.
+         */
+        void activate() noexcept;
+
         void addToProject();
         void removeFromProject();
-        bool save(bool toOriginal, QStringList& errors) noexcept;
+        bool save(bool toOriginal, QStringList& errors,
+                  AsyncFileWriter* writer = nullptr) noexcept;
         void showInView(GraphicsView& view) noexcept;
         void saveViewSceneRect(const QRectF& rect) noexcept {mViewRect = rect;}
         const QRectF& restoreViewSceneRect() const noexcept {return mViewRect;}
@@ -224,8 +328,15 @@ class Board final : public QObject, public AttributeProvider,
     private:
 
         Board(Project& project, const FilePath& filepath, bool restore,
-              bool readOnly, bool create, const QString& newName);
+              bool readOnly, bool create, const QString& newName,
+              const SExpression* preparsedRoot = nullptr);
         void updateIcon() noexcept;
+        QList<BI_Plane*> getPlanesSortedByPriority() const noexcept;
+        void startPlanesRebuild(const QList<BI_Plane*>& planes, int dirtyAreas) noexcept;
+        void cancelPlanesRebuild() noexcept;
+        void planesRebuildFinished() noexcept;
+        void applyPlanesRebuildResult() noexcept;
+        void netSignalRemoved(NetSignal& netsignal) noexcept;
         bool checkAttributesValidity() const noexcept;
         void updateErcMessages() noexcept;
 
@@ -237,16 +348,33 @@ class Board final : public QObject, public AttributeProvider,
         Project& mProject; ///< A reference to the Project object (from the ctor)
         FilePath mFilePath; ///< the filepath of the board *.lp file (from the ctor)
         QScopedPointer<SmartSExprFile> mFile;
+        SExpression mSavedDocument; ///< the DOM tree last written by #save()
+        quint64 mSavedDocumentRevision; ///< see #save() (0 if #mSavedDocument is invalid)
         bool mIsAddedToProject;
+        bool mIsActivated; ///< see #activate()
 
         QScopedPointer<GraphicsScene> mGraphicsScene;
+        QHash<QGraphicsItem*, int> mInactiveGraphicsItems; ///< value: insertion order
+        int mInactiveGraphicsItemsCounter;
+        QScopedPointer<BoardSpatialIndex> mSpatialIndex;
+        QScopedPointer<BoardGeometryCache> mGeometryCache;
         QScopedPointer<BoardLayerStack> mLayerStack;
         QScopedPointer<GridProperties> mGridProperties;
         QScopedPointer<BoardDesignRules> mDesignRules;
         QScopedPointer<BoardFabricationOutputSettings> mFabricationOutputSettings;
         QScopedPointer<BoardUserSettings> mUserSettings;
         QRectF mViewRect;
+        QRectF mSelectionRectPx; ///< the last rect passed to #setSelectionRect()
         QSet<NetSignal*> mScheduledNetSignalsForAirWireRebuild;
+        QVector<QRectF> mDirtyPlaneAreasPx; ///< see #invalidatePlanes()
+
+        // Running plane rebuild (see #rebuildDirtyPlanes())
+        QFuture<QHash<const BI_Plane*, QVector<Path>>> mPlanesRebuildFuture;
+        QFutureWatcher<QHash<const BI_Plane*, QVector<Path>>> mPlanesRebuildWatcher;
+        QSharedPointer<QAtomicInt> mPlanesRebuildAbort;
+        QList<BI_Plane*> mPlanesRebuildPlanes; ///< planes which are currently rebuilt
+        int mPlanesRebuildDirtyAreas; ///< number of dirty areas covered by the rebuild
+        bool mPlanesRebuildPending; ///< whether a result is expected (not cancelled)
 
         // Attributes
         Uuid mUuid;
@@ -262,9 +390,11 @@ class Board final : public QObject, public AttributeProvider,
         QList<BI_StrokeText*> mStrokeTexts;
         QList<BI_Hole*> mHoles;
         QMultiHash<NetSignal*, BI_AirWire*> mAirWires;
+        QHash<NetSignal*, QSharedPointer<BoardAirWiresBuilder>> mAirWiresBuilders;
 
         // ERC messages
         QHash<Uuid, ErcMsg*> mErcMsgListUnplacedComponentInstances;
+        QHash<QString, ErcMsg*> mErcMsgListDesignRuleViolations; ///< key: owner/msg key
 };
 
 /*****************************************************************************************
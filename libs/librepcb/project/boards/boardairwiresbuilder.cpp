@@ -21,7 +21,9 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
-#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <functional>
 #include "boardairwiresbuilder.h"
 #include "board.h"
 #include "items/bi_netsegment.h"
@@ -36,7 +38,6 @@
 #include "../circuit/componentsignalinstance.h"
 #include <librepcb/common/graphics/graphicslayer.h>
 #include <librepcb/library/pkg/footprintpad.h>
-#include <delaunay-triangulation/delaunay.h>
 
 /*****************************************************************************************
  *  Namespace
@@ -44,107 +45,6 @@
 namespace librepcb {
 namespace project {
 
-// adapted from horizon/kicad
-static QVector<QPair<Point, Point>> kruskalMst(
-        std::vector<delaunay::Edge<qreal>>& aEdges,
-        std::vector<delaunay::Vector2<qreal>>& aNodes) noexcept
-{
-    unsigned int nodeNumber = aNodes.size();
-    unsigned int mstExpectedSize = nodeNumber - 1;
-    unsigned int mstSize = 0;
-    bool ratsnestLines = false;
-
-    // printf("mst nodes : %d edges : %d\n", aNodes.size(), aEdges.size () );
-    // The output
-    QVector<QPair<Point, Point>> mst;
-
-    // Set tags for marking cycles
-    std::unordered_map<int, int> tags;
-    unsigned int tag = 0;
-
-    for (auto &node : aNodes) {
-        node.tag = tag;
-        tags[node.id] = tag++;
-    }
-
-    // Lists of nodes connected together (subtrees) to detect cycles in the
-    // graph
-    std::vector<std::list<int>> cycles(nodeNumber);
-
-    for (unsigned int i = 0; i < nodeNumber; ++i)
-        cycles[i].push_back(i);
-
-    // Kruskal algorithm requires edges to be sorted by their weight
-    std::sort(aEdges.begin(), aEdges.end(),
-        [](const delaunay::Edge<qreal> &a, const delaunay::Edge<qreal> &b) {
-            return a.weight > b.weight;
-        });
-
-    while (mstSize < mstExpectedSize && !aEdges.empty()) {
-        auto &dt = aEdges.back();
-
-        int srcTag = tags[dt.p1.id];
-        int trgTag = tags[dt.p2.id];
-        // printf("mstSize %d %d %f %d<>%d\n", mstSize, mstExpectedSize,
-        // dt.weight, srcTag, trgTag);
-
-        // Check if by adding this edge we are going to join two different
-        // forests
-        if (srcTag != trgTag) {
-            // Because edges are sorted by their weight, first we always process
-            // connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero
-            // weight,
-            // it means that the rest of the lines are ratsnest.
-            if (!ratsnestLines && dt.weight >= 0)
-                ratsnestLines = true;
-
-            // Update tags
-            if (ratsnestLines) {
-                for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it) {
-                    tags[aNodes[*it].id] = srcTag;
-                }
-
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to
-                // RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not
-                // require any other
-                // edges to exist for getting source/target nodes
-                // CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(),
-                // dt.GetWeight() );
-
-                // assert( newEdge.GetSourceNode()->GetTag() !=
-                // newEdge.GetTargetNode()->GetTag() );
-                // assert(dt.p1.tag != dt.p2.tag);
-                mst.append(qMakePair(Point(dt.p1.x, dt.p1.y), Point(dt.p2.x, dt.p2.y)));
-                ++mstSize;
-            }
-            else {
-                // for( it = cycles[trgTag].begin(), itEnd =
-                // cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it) {
-                    tags[aNodes[*it].id] = srcTag;
-                    aNodes[*it].tag = srcTag;
-                }
-
-                // Processing a connection, decrease the expected size of the
-                // ratsnest MST
-                --mstExpectedSize;
-            }
-
-            // Move nodes that were marked with old tag to the list marked with
-            // the new tag
-            cycles[srcTag].splice(cycles[srcTag].end(), cycles[trgTag]);
-        }
-
-        // Remove the edge that was just processed
-        aEdges.pop_back();
-    }
-
-    return mst;
-}
-
 /*****************************************************************************************
  *  Constructors / Destructor
  ****************************************************************************************/
@@ -162,27 +62,24 @@ BoardAirWiresBuilder::~BoardAirWiresBuilder() noexcept
  *  General Methods
  ****************************************************************************************/
 
-QVector<QPair<Point, Point> > BoardAirWiresBuilder::buildAirWires() const
+QVector<QPair<Point, Point>> BoardAirWiresBuilder::buildAirWires()
 {
-    std::vector<delaunay::Vector2<qreal>> points;
-    QHash<const BI_FootprintPad*, int> padMap;
-    QHash<const BI_Via*, int> viaMap;
-    QHash<const BI_NetPoint*, int> netPointMap;
-    QHash<int, QString> layerMap;
-    std::vector<delaunay::Edge<qreal>> edges;
+    struct NodeInfo {
+        const BI_Base* item;
+        Point position;
+        QString layerName;
+    };
+    QVector<NodeInfo> nodes;
+    QVector<QPair<const BI_Base*, const BI_Base*>> connections;
 
     // pads
     foreach (ComponentSignalInstance* cmpSig, mNetSignal.getComponentSignals()) { Q_ASSERT(cmpSig);
         foreach (BI_FootprintPad* pad, cmpSig->getRegisteredFootprintPads()) {
             if (&pad->getBoard() != &mBoard) continue;
-            int id = points.size();
-            Point pos = pad->getPosition();
-            points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-            padMap[pad] = id;
             if (pad->getLibPad().getBoardSide() == library::FootprintPad::BoardSide::THT) {
-                layerMap[id] = QString(); // on all layers
+                nodes.append(NodeInfo{pad, pad->getPosition(), QString()}); // on all layers
             } else {
-                layerMap[id] = pad->getLayerName();
+                nodes.append(NodeInfo{pad, pad->getPosition(), pad->getLayerName()});
             }
         }
     }
@@ -191,74 +88,422 @@ QVector<QPair<Point, Point> > BoardAirWiresBuilder::buildAirWires() const
     foreach (const BI_NetSegment* netsegment, mNetSignal.getBoardNetSegments()) { Q_ASSERT(netsegment);
         if (&netsegment->getBoard() != &mBoard) continue;
         foreach (const BI_Via* via, netsegment->getVias()) { Q_ASSERT(via);
-            int id = points.size();
-            Point pos = via->getPosition();
-            points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-            viaMap[via] = id;
-            layerMap[id] = QString(); // on all layers
+            nodes.append(NodeInfo{via, via->getPosition(), QString()}); // on all layers
         }
         foreach (const BI_NetPoint* netpoint, netsegment->getNetPoints()) { Q_ASSERT(netpoint);
-            int id = points.size();
-            Point pos = netpoint->getPosition();
-            points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-            netPointMap[netpoint] = id;
-            layerMap[id] = netpoint->getLayer().getName();
+            nodes.append(NodeInfo{netpoint, netpoint->getPosition(),
+                                  netpoint->getLayer().getName()});
             if (const BI_Via* via = netpoint->getVia()) {
-                Q_ASSERT(viaMap.contains(via));
-                edges.emplace_back(points[id], points[viaMap[via]], -1);
+                connections.append(qMakePair<const BI_Base*, const BI_Base*>(netpoint, via));
             }
             if (const BI_FootprintPad* pad = netpoint->getFootprintPad()) {
-                Q_ASSERT(padMap.contains(pad));
-                edges.emplace_back(points[id], points[padMap[pad]], -1);
+                connections.append(qMakePair<const BI_Base*, const BI_Base*>(netpoint, pad));
             }
         }
         foreach (const BI_NetLine* netline, netsegment->getNetLines()) { Q_ASSERT(netline);
-            Q_ASSERT(netPointMap.contains(&netline->getStartPoint()));
-            Q_ASSERT(netPointMap.contains(&netline->getEndPoint()));
-            edges.emplace_back(points[netPointMap[&netline->getStartPoint()]],
-                               points[netPointMap[&netline->getEndPoint()]], -1);
+            connections.append(qMakePair<const BI_Base*, const BI_Base*>(
+                &netline->getStartPoint(), &netline->getEndPoint()));
+        }
+    }
+
+    // update the cached nodes, remember which of them were added or moved
+    QSet<int> movedNodes;
+    QSet<int> layerChangedNodes;
+    QSet<int> currentNodes;
+    foreach (const NodeInfo& info, nodes) {
+        int id = mNodeIds.value(info.item, -1);
+        if (id < 0) {
+            id = addNode(*info.item);
+            movedNodes.insert(id);
+        } else if (mNodes.at(id).position != info.position) {
+            movedNodes.insert(id);
+        }
+        if ((mNodes.at(id).layerName != info.layerName) || movedNodes.contains(id)) {
+            layerChangedNodes.insert(id);
+        }
+        currentNodes.insert(id);
+    }
+
+    // remove links to removed or moved nodes from the Yao graph
+    QSet<QPair<int, int>> emptyCones; // cones (node, cone) whose nearest node was removed
+    for (int id = 0; id < mNodes.count(); ++id) {
+        if (!mNodes.at(id).item) continue;
+        if (!currentNodes.contains(id)) {
+            unlinkNode(id, emptyCones);
+            removeNode(id);
+        } else if (movedNodes.contains(id)) {
+            unlinkNode(id, emptyCones);
+        }
+    }
+
+    // apply new positions and layers
+    foreach (const NodeInfo& info, nodes) {
+        Node& node = mNodes[mNodeIds.value(info.item)];
+        node.position = info.position;
+        node.layerName = info.layerName;
+    }
+
+    // add added or moved nodes to the Yao graph (comparing them with all other nodes is
+    // only worth it for a few nodes, otherwise rebuild the whole graph)
+    if (movedNodes.count() > sMaxIncrementalNodes) {
+        rebuildYaoGraph();
+    } else {
+        foreach (int id, movedNodes) {
+            for (int other = 0; other < mNodes.count(); ++other) {
+                if ((other == id) || (!mNodes.at(other).item)) continue;
+                if (mNodes.at(other).position == mNodes.at(id).position) continue;
+                updateNearest(id, getCone(mNodes.at(id).position, mNodes.at(other).position), other);
+                if (!movedNodes.contains(other)) {
+                    updateNearest(other, getCone(mNodes.at(other).position, mNodes.at(id).position), id);
+                }
+            }
+        }
+        typedef QPair<int, int> NodeCone;
+        foreach (const NodeCone& nodeCone, emptyCones) {
+            if (mNodes.at(nodeCone.first).item && (!movedNodes.contains(nodeCone.first))) {
+                findNearest(nodeCone.first, nodeCone.second);
+            }
         }
     }
 
-    // determine connections made by planes
+    // update the plane fragments and which nodes they contain
+    QVector<Fragment> fragments;
     foreach (const BI_Plane* plane, mNetSignal.getBoardPlanes()) { Q_ASSERT(plane);
         if (&plane->getBoard() != &mBoard) continue;
         foreach (const Path& fragment, plane->getFragments()) {
-            int lastId = -1;
-            for (const auto& point : points) {
-                QString pointLayer = layerMap[point.id];
-                if (pointLayer.isNull() || (pointLayer == plane->getLayerName())) {
-                    Point p(point.x, point.y);
-                    if (fragment.toQPainterPathPx().contains(p.toPxQPointF())) {
-                        if (lastId >= 0) {
-                            edges.emplace_back(points[lastId], points[point.id], -1);
-                        }
-                        lastId = point.id;
+            fragments.append(Fragment{plane, plane->getLayerName(), fragment,
+                                      QSharedPointer<PointInPolygonIndex>()});
+        }
+    }
+    bool fragmentsChanged = (fragments.count() != mFragments.count());
+    for (int i = 0; (!fragmentsChanged) && (i < fragments.count()); ++i) {
+        fragmentsChanged = (fragments.at(i).plane != mFragments.at(i).plane)
+                        || (fragments.at(i).layerName != mFragments.at(i).layerName)
+                        || (fragments.at(i).outline != mFragments.at(i).outline);
+    }
+    if (fragmentsChanged) {
+        mFragments = fragments;
+        for (int i = 0; i < mFragments.count(); ++i) {
+            mFragments[i].index.reset(new PointInPolygonIndex(mFragments.at(i).outline));
+        }
+        layerChangedNodes = currentNodes;
+    }
+    updateFragments(layerChangedNodes);
+
+    // determine groups of connected nodes
+    QVector<int> groups(mNodes.count());
+    std::function<int(int)> findGroup = [&groups, &findGroup](int id) {
+        if (groups.at(id) != id) groups[id] = findGroup(groups.at(id));
+        return groups.at(id);
+    };
+    auto joinGroups = [&groups, &findGroup](int id1, int id2) {
+        int group1 = findGroup(id1);
+        int group2 = findGroup(id2);
+        if (group1 == group2) return false;
+        groups[qMax(group1, group2)] = qMin(group1, group2);
+        return true;
+    };
+    for (int id = 0; id < groups.count(); ++id) {
+        groups[id] = id;
+    }
+    typedef QPair<const BI_Base*, const BI_Base*> Connection;
+    foreach (const Connection& connection, connections) {
+        Q_ASSERT(mNodeIds.contains(connection.first));
+        Q_ASSERT(mNodeIds.contains(connection.second));
+        joinGroups(mNodeIds.value(connection.first), mNodeIds.value(connection.second));
+    }
+    QVector<int> firstNodeOfFragment(mFragments.count(), -1);
+    for (int id = 0; id < mNodes.count(); ++id) {
+        if (!mNodes.at(id).item) continue;
+        foreach (int fragment, mNodes.at(id).fragments) {
+            if (firstNodeOfFragment.at(fragment) >= 0) {
+                joinGroups(firstNodeOfFragment.at(fragment), id);
+            } else {
+                firstNodeOfFragment[fragment] = id;
+            }
+        }
+    }
+
+    // nodes at the same position are connected without airwire
+    QHash<Point, int> nodeAtPosition;
+    for (int id = 0; id < mNodes.count(); ++id) {
+        const Node& node = mNodes.at(id);
+        if (!node.item) continue;
+        if (nodeAtPosition.contains(node.position)) {
+            joinGroups(nodeAtPosition.value(node.position), id);
+        } else {
+            nodeAtPosition.insert(node.position, id);
+        }
+    }
+
+    // collect candidate edges from the Yao graph
+    QVector<QPair<int, int>> edges;
+    for (int id = 0; id < mNodes.count(); ++id) {
+        const Node& node = mNodes.at(id);
+        if (!node.item) continue;
+        for (int cone = 0; cone < sConeCount; ++cone) {
+            if (node.nearest[cone] >= 0) {
+                edges.append(qMakePair(id, node.nearest[cone]));
+            }
+        }
+    }
+
+    // find airwires with Kruskal's algorithm
+    QVector<qint64> weights;
+    QVector<int> order;
+    for (int i = 0; i < edges.count(); ++i) {
+        weights.append(getDistance2(edges.at(i).first, edges.at(i).second));
+        order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (weights.at(a) != weights.at(b)) return weights.at(a) < weights.at(b);
+        return a < b;
+    });
+    QVector<QPair<Point, Point>> airwires;
+    foreach (int i, order) {
+        const QPair<int, int>& edge = edges.at(i);
+        if (joinGroups(edge.first, edge.second)) {
+            airwires.append(qMakePair(mNodes.at(edge.first).position,
+                                      mNodes.at(edge.second).position));
+        }
+    }
+    return airwires;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+int BoardAirWiresBuilder::addNode(const BI_Base& item) noexcept
+{
+    int id;
+    if (!mFreeNodeIds.isEmpty()) {
+        id = mFreeNodeIds.takeLast();
+    } else {
+        id = mNodes.count();
+        mNodes.append(Node());
+    }
+    Node& node = mNodes[id];
+    node.item = &item;
+    node.position = Point();
+    node.layerName = QString();
+    node.nearest.fill(-1);
+    node.nearestOf.clear();
+    node.fragments.clear();
+    mNodeIds.insert(&item, id);
+    return id;
+}
+
+void BoardAirWiresBuilder::removeNode(int id) noexcept
+{
+    mNodeIds.remove(mNodes.at(id).item);
+    mNodes[id].item = nullptr;
+    mNodes[id].fragments.clear();
+    mFreeNodeIds.append(id);
+}
+
+void BoardAirWiresBuilder::unlinkNode(int id, QSet<QPair<int, int>>& emptyCones) noexcept
+{
+    Node& node = mNodes[id];
+    for (int cone = 0; cone < sConeCount; ++cone) {
+        if (node.nearest[cone] >= 0) {
+            mNodes[node.nearest[cone]].nearestOf.remove(id);
+            node.nearest[cone] = -1;
+        }
+    }
+    foreach (int other, node.nearestOf) {
+        for (int cone = 0; cone < sConeCount; ++cone) {
+            if (mNodes.at(other).nearest[cone] == id) {
+                mNodes[other].nearest[cone] = -1;
+                emptyCones.insert(qMakePair(other, cone));
+            }
+        }
+    }
+    node.nearestOf.clear();
+}
+
+void BoardAirWiresBuilder::updateNearest(int id, int cone, int candidate) noexcept
+{
+    Node& node = mNodes[id];
+    int current = node.nearest[cone];
+    if ((current < 0) || isCloser(id, candidate, current)) {
+        if (current >= 0) {
+            mNodes[current].nearestOf.remove(id);
+        }
+        node.nearest[cone] = candidate;
+        mNodes[candidate].nearestOf.insert(id);
+    }
+}
+
+void BoardAirWiresBuilder::findNearest(int id, int cone) noexcept
+{
+    for (int other = 0; other < mNodes.count(); ++other) {
+        if ((other == id) || (!mNodes.at(other).item)) continue;
+        if (mNodes.at(other).position == mNodes.at(id).position) continue;
+        if (getCone(mNodes.at(id).position, mNodes.at(other).position) == cone) {
+            updateNearest(id, cone, other);
+        }
+    }
+}
+
+void BoardAirWiresBuilder::rebuildYaoGraph() noexcept
+{
+    QVector<int> ids;
+    qint64 left = 0, right = 0, bottom = 0, top = 0;
+    for (int id = 0; id < mNodes.count(); ++id) {
+        Node& node = mNodes[id];
+        if (!node.item) continue;
+        node.nearest.fill(-1);
+        node.nearestOf.clear();
+        qint64 x = node.position.getX().toNm();
+        qint64 y = node.position.getY().toNm();
+        if (ids.isEmpty() || (x < left))   left = x;
+        if (ids.isEmpty() || (x > right))  right = x;
+        if (ids.isEmpty() || (y < bottom)) bottom = y;
+        if (ids.isEmpty() || (y > top))    top = y;
+        ids.append(id);
+    }
+    if (ids.isEmpty()) {
+        return;
+    }
+
+    // put the nodes into a grid with about one node per cell (but not more cells than
+    // nodes in one direction, in case all nodes are on a line)
+    qint64 width = right - left + 1;
+    qint64 height = top - bottom + 1;
+    qint64 cellSize = qMax(qint64(std::ceil(qSqrt(qreal(width) * qreal(height) / ids.count()))),
+                           qMax(width, height) / ids.count() + 1);
+    int columns = (width / cellSize) + 1;
+    int rows = (height / cellSize) + 1;
+    QVector<QVector<int>> cells(columns * rows);
+    auto getColumn = [&](int id) {
+        return int((mNodes.at(id).position.getX().toNm() - left) / cellSize);
+    };
+    auto getRow = [&](int id) {
+        return int((mNodes.at(id).position.getY().toNm() - bottom) / cellSize);
+    };
+    foreach (int id, ids) {
+        cells[getColumn(id) + getRow(id) * columns].append(id);
+    }
+
+    // search the nearest node of each cone in rings of cells around each node
+    foreach (int id, ids) {
+        const Point& pos = mNodes.at(id).position;
+        qreal x = pos.getX().toNm(), y = pos.getY().toNm();
+
+        // the farthest distance a node in a cone can have, i.e. the farthest vertex of
+        // the intersection of the cone and the grid bounding box
+        static const int dirs[sConeCount + 1][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1},
+                                                    {-1, 0}, {-1, -1}, {0, -1}, {1, -1},
+                                                    {1, 0}};
+        std::array<qreal, sConeCount> maxDistance;
+        maxDistance.fill(0);
+        for (int cone = 0; cone < sConeCount; ++cone) {
+            for (int i = cone; i <= cone + 1; ++i) { // the two rays bounding the cone
+                qreal t = std::numeric_limits<qreal>::max();
+                if (dirs[i][0] > 0) t = qMin(t, right - x);
+                if (dirs[i][0] < 0) t = qMin(t, x - left);
+                if (dirs[i][1] > 0) t = qMin(t, top - y);
+                if (dirs[i][1] < 0) t = qMin(t, y - bottom);
+                t *= qSqrt(dirs[i][0] * dirs[i][0] + dirs[i][1] * dirs[i][1]);
+                maxDistance[cone] = qMax(maxDistance.at(cone), t);
+            }
+        }
+        for (qint64 cornerX : {left, right}) {
+            for (qint64 cornerY : {bottom, top}) {
+                Point corner(Length(cornerX), Length(cornerY));
+                if (corner == pos) continue;
+                qreal distance = qSqrt(qPow(cornerX - x, 2) + qPow(cornerY - y, 2));
+                int cone = getCone(pos, corner);
+                maxDistance[cone] = qMax(maxDistance.at(cone), distance);
+            }
+        }
+
+        int column = getColumn(id);
+        int row = getRow(id);
+        for (int ring = 0; ; ++ring) {
+            for (int r = row - ring; r <= row + ring; ++r) {
+                if ((r < 0) || (r >= rows)) continue;
+                int step = ((r == row - ring) || (r == row + ring)) ? 1 : qMax(2 * ring, 1);
+                for (int c = column - ring; c <= column + ring; c += step) {
+                    if ((c < 0) || (c >= columns)) continue;
+                    foreach (int other, cells.at(c + r * columns)) {
+                        if ((other == id) || (mNodes.at(other).position == pos)) continue;
+                        updateNearest(id, getCone(pos, mNodes.at(other).position), other);
                     }
                 }
             }
+            // all nodes outside of this ring are at least this far away
+            qreal minDistance = qreal(ring) * cellSize;
+            bool done = true;
+            for (int cone = 0; (cone < sConeCount) && done; ++cone) {
+                int nearest = mNodes.at(id).nearest[cone];
+                if (maxDistance.at(cone) + 1 < minDistance) continue; // nothing left in cone
+                done = (nearest >= 0) && (qSqrt(getDistance2(id, nearest)) < minDistance);
+            }
+            if (done) break;
         }
     }
+}
 
-    // remember how many edges are already known as connected
-    uint connectedEdges = edges.size();
-
-    // determine additional edges between found points (candidates for airwires)
-    if (points.size() >= 3) { // minimum 3 points needed for triangulation
-        delaunay::Delaunay<qreal> del;
-        del.triangulate(points);
-        edges.insert(edges.end(), del.getEdges().begin(), del.getEdges().end());
-    } else if (points.size() == 2) {
-        edges.emplace_back(points[0], points[1], -1);
+void BoardAirWiresBuilder::updateFragments(const QSet<int>& ids) noexcept
+{
+    foreach (int id, ids) {
+        mNodes[id].fragments.clear();
     }
+    for (int i = 0; i < mFragments.count(); ++i) {
+        const Fragment& fragment = mFragments.at(i);
+        QVector<int> candidates;
+        QVector<Point> positions;
+        foreach (int id, ids) {
+            const Node& node = mNodes.at(id);
+            if (node.layerName.isNull() || (node.layerName == fragment.layerName)) {
+                candidates.append(id);
+                positions.append(node.position);
+            }
+        }
+        foreach (int index, fragment.index->getContainedPoints(positions)) {
+            mNodes[candidates.at(index)].fragments.append(i);
+        }
+    }
+}
 
-    // determine weights of these new edges
-    for (uint i = connectedEdges; i < edges.size(); ++i) {
-        edges[i].weight = edges[i].p1.dist2(edges[i].p2);
+bool BoardAirWiresBuilder::isCloser(int id, int candidate, int current) const noexcept
+{
+    qint64 candidateDistance = getDistance2(id, candidate);
+    qint64 currentDistance = getDistance2(id, current);
+    if (candidateDistance != currentDistance) {
+        return candidateDistance < currentDistance;
+    } else {
+        return candidate < current; // make the result independent of processing order
     }
+}
+
+qint64 BoardAirWiresBuilder::getDistance2(int id1, int id2) const noexcept
+{
+    const Point& p1 = mNodes.at(id1).position;
+    const Point& p2 = mNodes.at(id2).position;
+    qint64 dx = p2.getX().toNm() - p1.getX().toNm();
+    qint64 dy = p2.getY().toNm() - p1.getY().toNm();
+    return (dx * dx) + (dy * dy);
+}
 
-    // find airwires in list of edges
-    return kruskalMst(edges, points);
+int BoardAirWiresBuilder::getCone(const Point& from, const Point& to) noexcept
+{
+    // 8 cones of 45 degrees each, every cone contains its start angle but not its end
+    // angle (exact integer arithmetic, so the result does not depend on rounding)
+    qint64 dx = to.getX().toNm() - from.getX().toNm();
+    qint64 dy = to.getY().toNm() - from.getY().toNm();
+    Q_ASSERT((dx != 0) || (dy != 0));
+    if ((dx > 0) && (dy >= 0)) {
+        return (dy < dx) ? 0 : 1;
+    } else if ((dx <= 0) && (dy > 0)) {
+        return (-dx < dy) ? 2 : 3;
+    } else if ((dx < 0) && (dy <= 0)) {
+        return (-dy < -dx) ? 4 : 5;
+    } else {
+        return (dx < -dy) ? 6 : 7;
+    }
 }
 
 /*****************************************************************************************
@@ -24,7 +24,10 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <array>
 #include <librepcb/common/units/point.h>
+#include <librepcb/common/geometry/path.h>
+#include <librepcb/common/geometry/pointinpolygonindex.h>
 
 /*****************************************************************************************
  *  Namespace / Forward Declarations
@@ -34,13 +37,30 @@ namespace project {
 
 class NetSignal;
 class Board;
+class BI_Base;
+class BI_Plane;
 
 /*****************************************************************************************
  *  Class BoardAirWiresBuilder
  ****************************************************************************************/
 
 /**
- * @brief The BoardAirWiresBuilder class
+ * @brief The BoardAirWiresBuilder class calculates the airwires of a net signal
+ *
+ * The airwires are the minimum spanning tree between all groups of connected nodes
+ * (pads, vias and netpoints) of the net signal. Candidate edges for the spanning tree
+ * are taken from a Yao graph (for each node, the nearest other node in each of 8
+ * cones), which contains the euclidean minimum spanning tree but, in contrast to a
+ * triangulation, can be updated locally when nodes are moved.
+ *
+ * The builder keeps its state between calls of #buildAirWires(), so only nodes which
+ * were added, removed or moved since the last call need to be processed again. Thus
+ * an instance should be kept as long as the net signal exists. If many nodes have
+ * changed (e.g. on the first call), the Yao graph is rebuilt from scratch with the help
+ * of a uniform grid instead.
+ *
+ * Nodes at the same position are considered as connected, i.e. no zero-length airwires
+ * are created.
  */
 class BoardAirWiresBuilder final
 {
@@ -53,14 +73,55 @@ class BoardAirWiresBuilder final
         ~BoardAirWiresBuilder() noexcept;
 
         // General Methods
-        QVector<QPair<Point, Point>> buildAirWires() const;
+        QVector<QPair<Point, Point>> buildAirWires();
 
         // Operator Overloadings
         BoardAirWiresBuilder& operator=(const BoardAirWiresBuilder& rhs) = delete;
 
+
+    private: // Types
+        static const int sConeCount = 8;
+        static const int sMaxIncrementalNodes = 32; ///< see #buildAirWires()
+
+        struct Node {
+            const BI_Base* item;    ///< nullptr if the slot is unused
+            Point position;
+            QString layerName;      ///< null if the node is on all layers
+            std::array<int, sConeCount> nearest; ///< nearest node per cone (-1 if none)
+            QSet<int> nearestOf;    ///< nodes which have this node as nearest in a cone
+            QVector<int> fragments; ///< indices of plane fragments containing this node
+        };
+
+        struct Fragment {
+            const BI_Plane* plane;
+            QString layerName;
+            Path outline;
+            QSharedPointer<PointInPolygonIndex> index;
+        };
+
+
+    private: // Methods
+        int addNode(const BI_Base& item) noexcept;
+        void removeNode(int id) noexcept;
+        void unlinkNode(int id, QSet<QPair<int, int>>& emptyCones) noexcept;
+        void updateNearest(int id, int cone, int candidate) noexcept;
+        void findNearest(int id, int cone) noexcept;
+        void rebuildYaoGraph() noexcept;
+        void updateFragments(const QSet<int>& ids) noexcept;
+        bool isCloser(int id, int candidate, int current) const noexcept;
+        qint64 getDistance2(int id1, int id2) const noexcept;
+        static int getCone(const Point& from, const Point& to) noexcept;
+
+
     private: // Data
         const Board& mBoard;
         const NetSignal& mNetSignal;
+
+        // Cached state
+        QVector<Node> mNodes;
+        QHash<const BI_Base*, int> mNodeIds;
+        QVector<int> mFreeNodeIds;
+        QVector<Fragment> mFragments;
 };
 
 /*****************************************************************************************
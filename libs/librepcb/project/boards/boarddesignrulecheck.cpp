@@ -0,0 +1,497 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtConcurrent/QtConcurrent>
+#include "boarddesignrulecheck.h"
+#include <librepcb/common/graphics/graphicslayer.h>
+#include <librepcb/common/utils/clipperhelpers.h>
+#include <librepcb/library/pkg/footprint.h>
+#include <librepcb/library/pkg/footprintpad.h>
+#include <librepcb/library/pkg/packagepad.h>
+#include "../circuit/componentinstance.h"
+#include "../circuit/netsignal.h"
+#include "items/bi_device.h"
+#include "items/bi_footprint.h"
+#include "items/bi_footprintpad.h"
+#include "items/bi_hole.h"
+#include "items/bi_netline.h"
+#include "items/bi_netsegment.h"
+#include "items/bi_plane.h"
+#include "items/bi_via.h"
+#include "board.h"
+#include "boardgeometrycache.h"
+#include "boardlayerstack.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+BoardDesignRuleCheck::BoardDesignRuleCheck(const Board& board,
+                                           const BoardDesignRules& rules) noexcept :
+    mRules(rules),
+    mClearanceExpansion(qMax(rules.getMinCopperClearance() - tolerance(), Length(0)))
+{
+    takeSnapshot(board);
+}
+
+BoardDesignRuleCheck::~BoardDesignRuleCheck() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+QList<BoardDesignRuleCheck::Violation> BoardDesignRuleCheck::execute(
+        const QAtomicInt* abort) const noexcept
+{
+    // split the geometric checks into chunks and run them in the global thread pool
+    static const int chunkSize = 256;
+    QList<QFuture<QList<Violation>>> futures;
+    for (auto it = mLayerObjects.constBegin(); it != mLayerObjects.constEnd(); ++it) {
+        QString layer = it.key();
+        for (int i = 0; i < it.value().count(); i += chunkSize) {
+            futures.append(QtConcurrent::run([this, layer, i, abort](){
+                return checkClearances(layer, i, chunkSize, abort);
+            }));
+        }
+        // planes are large, so each fragment gets its own job
+        for (int i = 0; i < it.value().count(); ++i) {
+            if (mCopperObjects.at(it.value().at(i)).isPlane) {
+                futures.append(QtConcurrent::run([this, layer, i, abort](){
+                    return checkPlaneClearances(layer, i, abort);
+                }));
+            }
+        }
+    }
+    for (int i = 0; i < mDrills.count(); i += chunkSize) {
+        futures.append(QtConcurrent::run([this, i, abort](){
+            return checkDrillClearances(i, chunkSize, abort);
+        }));
+    }
+
+    // collect results (items on multiple layers may lead to duplicate violations)
+    QList<Violation> violations = mSnapshotViolations;
+    QSet<QPair<QString, QString>> keys;
+    foreach (const QFuture<QList<Violation>>& future, futures) {
+        foreach (const Violation& violation, future.result()) {
+            QPair<QString, QString> key(violation.msgKey, violation.ownerKey);
+            if (!keys.contains(key)) {
+                keys.insert(key);
+                violations.append(violation);
+            }
+        }
+    }
+    return violations;
+}
+
+/*****************************************************************************************
+ *  Static Methods
+ ****************************************************************************************/
+
+QString BoardDesignRuleCheck::getDescription(const BI_FootprintPad& pad) noexcept
+{
+    return tr("Pad %1:%2").arg(
+        pad.getFootprint().getDeviceInstance().getComponentInstance().getName(),
+        pad.getLibPackagePad().getName());
+}
+
+QString BoardDesignRuleCheck::getDescription(const BI_Via& via) noexcept
+{
+    return tr("Via of net %1").arg(via.getNetSignalOfNetSegment().getName());
+}
+
+QString BoardDesignRuleCheck::getDescription(const BI_NetLine& netline) noexcept
+{
+    return tr("Trace of net %1").arg(netline.getNetSignalOfNetSegment().getName());
+}
+
+QString BoardDesignRuleCheck::getDescription(const BI_Plane& plane) noexcept
+{
+    return tr("Plane of net %1").arg(plane.getNetSignal().getName());
+}
+
+bool BoardDesignRuleCheck::intersects(const ClipperLib::Paths& a, const ClipperLib::Paths& b)
+{
+    try {
+        ClipperLib::Paths intersections;
+        ClipperLib::Clipper c;
+        c.AddPaths(a, ClipperLib::ptSubject, true);
+        c.AddPaths(b, ClipperLib::ptClip, true);
+        c.Execute(ClipperLib::ctIntersection, intersections, ClipperLib::pftNonZero,
+                  ClipperLib::pftNonZero);
+        return !intersections.empty();
+    } catch (const std::exception& e) {
+        throw LogicError(__FILE__, __LINE__,
+            QString(tr("Failed to intersect paths: %1")).arg(e.what()));
+    }
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+void BoardDesignRuleCheck::takeSnapshot(const Board& board) noexcept
+{
+    BoardGeometryCache& cache = board.getGeometryCache();
+
+    // enabled copper layers
+    QStringList copperLayers;
+    foreach (const GraphicsLayer* layer, board.getLayerStack().getAllLayers()) {
+        if (layer->isCopperLayer() && layer->isEnabled()) {
+            copperLayers.append(layer->getName());
+        }
+    }
+
+    // pads and holes of devices
+    foreach (const BI_Device* device, board.getDeviceInstances()) {
+        QString name = device->getComponentInstance().getName();
+        foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
+            CopperObject obj;
+            obj.key = QString("%1:%2").arg(device->getComponentInstanceUuid().toStr(),
+                                           pad->getLibPadUuid().toStr());
+            obj.description = getDescription(*pad);
+            obj.netSignal = pad->getCompSigInstNetSignal();
+            obj.isPlane = false;
+            obj.area.push_back(cache.getPadOutline(*pad, Length(0), tolerance()));
+            obj.expandedArea.push_back(cache.getPadOutline(*pad, mClearanceExpansion,
+                                                           tolerance()));
+            obj.bounds = getBounds(obj.area);
+            QStringList layers;
+            foreach (const QString& layer, copperLayers) {
+                if (pad->isOnLayer(layer)) layers.append(layer);
+            }
+            addCopperObject(layers, obj);
+
+            const library::FootprintPad& libPad = pad->getLibPad();
+            if (libPad.getBoardSide() == library::FootprintPad::BoardSide::THT) {
+                checkAnnularRing(obj.key, obj.description,
+                                 qMin(libPad.getWidth(), libPad.getHeight()),
+                                 libPad.getDrillDiameter());
+                Drill drill;
+                drill.key = obj.key;
+                drill.description = obj.description;
+                drill.netSignal = obj.netSignal;
+                drill.copperObject = mCopperObjects.count() - 1;
+                drill.area = ClipperHelpers::convert(
+                    Path::circle(libPad.getDrillDiameter() + mRules.getMinDrillCopperClearance() * 2)
+                    .translated(pad->getPosition()), tolerance());
+                addDrill(drill);
+            }
+        }
+        for (const Hole& hole : device->getFootprint().getLibFootprint().getHoles()) {
+            Drill drill;
+            drill.key = QString("%1:%2").arg(device->getComponentInstanceUuid().toStr(),
+                                             hole.getUuid().toStr());
+            drill.description = tr("Hole of %1").arg(name);
+            drill.netSignal = nullptr;
+            drill.copperObject = -1;
+            drill.area = ClipperHelpers::convert(
+                Path::circle(hole.getDiameter() + mRules.getMinDrillCopperClearance() * 2)
+                .translated(device->getFootprint().mapToScene(hole.getPosition())), tolerance());
+            addDrill(drill);
+        }
+    }
+
+    // board holes
+    foreach (const BI_Hole* hole, board.getHoles()) {
+        Drill drill;
+        drill.key = hole->getHole().getUuid().toStr();
+        drill.description = tr("Hole");
+        drill.netSignal = nullptr;
+        drill.copperObject = -1;
+        drill.area = ClipperHelpers::convert(
+            Path::circle(hole->getHole().getDiameter() + mRules.getMinDrillCopperClearance() * 2)
+            .translated(hole->getHole().getPosition()), tolerance());
+        addDrill(drill);
+    }
+
+    // net segment items
+    foreach (const BI_NetSegment* netsegment, board.getNetSegments()) {
+        const NetSignal& netsignal = netsegment->getNetSignal();
+
+        // vias
+        foreach (const BI_Via* via, netsegment->getVias()) {
+            CopperObject obj;
+            obj.key = via->getUuid().toStr();
+            obj.description = getDescription(*via);
+            obj.netSignal = &netsignal;
+            obj.isPlane = false;
+            obj.area.push_back(cache.getViaOutline(*via, Length(0), tolerance()));
+            obj.expandedArea.push_back(cache.getViaOutline(*via, mClearanceExpansion,
+                                                           tolerance()));
+            obj.bounds = getBounds(obj.area);
+            addCopperObject(copperLayers, obj);
+            checkAnnularRing(obj.key, obj.description, via->getSize(),
+                             via->getDrillDiameter());
+            Drill drill;
+            drill.key = obj.key;
+            drill.description = obj.description;
+            drill.netSignal = obj.netSignal;
+            drill.copperObject = mCopperObjects.count() - 1;
+            drill.area = ClipperHelpers::convert(
+                Path::circle(via->getDrillDiameter() + mRules.getMinDrillCopperClearance() * 2)
+                .translated(via->getPosition()), tolerance());
+            addDrill(drill);
+        }
+
+        // netlines
+        foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
+            CopperObject obj;
+            obj.key = netline->getUuid().toStr();
+            obj.description = getDescription(*netline);
+            obj.netSignal = &netsignal;
+            obj.isPlane = false;
+            obj.area.push_back(ClipperHelpers::convert(netline->getSceneOutline(),
+                                                       tolerance()));
+            obj.expandedArea.push_back(ClipperHelpers::convert(
+                netline->getSceneOutline(mClearanceExpansion), tolerance()));
+            obj.bounds = getBounds(obj.area);
+            addCopperObject(QStringList{netline->getLayer().getName()}, obj);
+            checkCopperWidth(obj.key, obj.description, netline->getWidth());
+        }
+    }
+
+    // planes (each fragment separately to get smaller bounding rects)
+    foreach (const BI_Plane* plane, board.getPlanes()) {
+        QString description = getDescription(*plane);
+        foreach (const Path& fragment, plane->getFragments()) {
+            CopperObject obj;
+            obj.key = plane->getUuid().toStr();
+            obj.description = description;
+            obj.netSignal = &plane->getNetSignal();
+            obj.isPlane = true;
+            obj.area.push_back(ClipperHelpers::convert(fragment, tolerance()));
+            obj.bounds = getBounds(obj.area);
+            addCopperObject(QStringList{plane->getLayerName()}, obj);
+        }
+        checkCopperWidth(plane->getUuid().toStr(), description, plane->getMinWidth());
+    }
+}
+
+void BoardDesignRuleCheck::addCopperObject(const QStringList& layers,
+                                           const CopperObject& obj) noexcept
+{
+    int index = mCopperObjects.count();
+    mCopperObjects.append(obj);
+    foreach (const QString& layer, layers) {
+        if (!mLayerTrees.contains(layer)) {
+            mLayerTrees.insert(layer, QSharedPointer<RTree<int>>(new RTree<int>()));
+        }
+        mLayerTrees.value(layer)->insert(obj.bounds, index);
+        mLayerObjects[layer].append(index);
+    }
+}
+
+void BoardDesignRuleCheck::addDrill(const Drill& drill) noexcept
+{
+    mDrills.append(drill);
+    mDrills.last().bounds = getBounds(ClipperLib::Paths{drill.area});
+}
+
+void BoardDesignRuleCheck::checkCopperWidth(const QString& key, const QString& description,
+                                            const Length& width) noexcept
+{
+    if (width < mRules.getMinCopperWidth()) {
+        mSnapshotViolations.append(Violation{"MinCopperWidth", key,
+            tr("Copper width of %1 is %2mm (minimum: %3mm)")
+            .arg(description, width.toMmString(),
+                 mRules.getMinCopperWidth().toMmString())});
+    }
+}
+
+void BoardDesignRuleCheck::checkAnnularRing(const QString& key, const QString& description,
+                                            const Length& size, const Length& drill) noexcept
+{
+    Length ring = (size - drill) / 2;
+    if (ring < mRules.getMinAnnularRing()) {
+        mSnapshotViolations.append(Violation{"MinAnnularRing", key,
+            tr("Annular ring of %1 is %2mm (minimum: %3mm)")
+            .arg(description, ring.toMmString(),
+                 mRules.getMinAnnularRing().toMmString())});
+    }
+}
+
+QList<BoardDesignRuleCheck::Violation> BoardDesignRuleCheck::checkClearances(
+        const QString& layer, int first, int count, const QAtomicInt* abort) const noexcept
+{
+    QList<Violation> violations;
+    QVector<int> objects = mLayerObjects.value(layer);
+    for (int i = first; (i < first + count) && (i < objects.count()); ++i) {
+        if (abort && abort->load()) break;
+        const CopperObject& a = mCopperObjects.at(objects.at(i));
+        if (a.isPlane) continue; // see checkPlaneClearances()
+        foreach (int j, findCandidates(layer, a.bounds)) {
+            const CopperObject& b = mCopperObjects.at(j);
+            if ((j <= objects.at(i)) || b.isPlane) continue; // check each pair only once
+            if (a.netSignal && (a.netSignal == b.netSignal)) continue;
+            try {
+                if (hasClearanceViolation(a, b)) {
+                    violations.append(createClearanceViolation(a, b));
+                }
+            } catch (const Exception& e) {
+                qWarning() << "Failed to check clearance:" << e.getMsg();
+            }
+        }
+    }
+    return violations;
+}
+
+QList<BoardDesignRuleCheck::Violation> BoardDesignRuleCheck::checkPlaneClearances(
+        const QString& layer, int index, const QAtomicInt* abort) const noexcept
+{
+    // A plane fragment usually overlaps with the bounding rects of a huge number of
+    // objects, but most of them are cut out with enough clearance. So first check all
+    // candidates at once and only compare them separately if there is any violation.
+    QList<Violation> violations;
+    if (abort && abort->load()) return violations;
+    int planeIndex = mLayerObjects.value(layer).at(index);
+    const CopperObject& plane = mCopperObjects.at(planeIndex);
+    try {
+        QVector<int> candidates;
+        ClipperLib::Paths expandedAreas;
+        foreach (int j, findCandidates(layer, plane.bounds)) {
+            const CopperObject& obj = mCopperObjects.at(j);
+            if (plane.netSignal == obj.netSignal) continue;
+            if (obj.isPlane && (j <= planeIndex)) continue; // check each pair only once
+            candidates.append(j);
+            if (obj.isPlane) {
+                ClipperLib::Paths paths = obj.area;
+                ClipperHelpers::offset(paths, mClearanceExpansion, tolerance()); // can throw
+                expandedAreas.insert(expandedAreas.end(), paths.begin(), paths.end());
+            } else {
+                expandedAreas.insert(expandedAreas.end(), obj.expandedArea.begin(),
+                                     obj.expandedArea.end());
+            }
+        }
+        if (candidates.isEmpty() || (!intersects(plane.area, expandedAreas))) {
+            return violations;
+        }
+        foreach (int j, candidates) {
+            if (abort && abort->load()) break;
+            const CopperObject& obj = mCopperObjects.at(j);
+            if (hasClearanceViolation(plane, obj)) {
+                violations.append(createClearanceViolation(plane, obj));
+            }
+        }
+    } catch (const Exception& e) {
+        qWarning() << "Failed to check plane clearance:" << e.getMsg();
+    }
+    return violations;
+}
+
+QList<BoardDesignRuleCheck::Violation> BoardDesignRuleCheck::checkDrillClearances(
+        int first, int count, const QAtomicInt* abort) const noexcept
+{
+    QList<Violation> violations;
+    for (int i = first; (i < first + count) && (i < mDrills.count()); ++i) {
+        if (abort && abort->load()) break;
+        const Drill& drill = mDrills.at(i);
+        ClipperLib::Paths drillArea{drill.area};
+        QSet<int> checkedObjects;
+        foreach (const QString& layer, mLayerTrees.keys()) {
+            foreach (int j, findCandidates(layer, drill.bounds)) {
+                if (checkedObjects.contains(j)) continue; // object is on multiple layers
+                checkedObjects.insert(j);
+                const CopperObject& obj = mCopperObjects.at(j);
+                if (j == drill.copperObject) continue;
+                if (drill.netSignal && (drill.netSignal == obj.netSignal)) continue;
+                try {
+                    if (intersects(drillArea, obj.area)) {
+                        violations.append(Violation{"DrillCopperClearance",
+                            QString("%1/%2").arg(drill.key, obj.key),
+                            tr("Drill clearance violation: %1 <-> %2")
+                            .arg(drill.description, obj.description)});
+                    }
+                } catch (const Exception& e) {
+                    qWarning() << "Failed to check drill clearance:" << e.getMsg();
+                }
+            }
+        }
+    }
+    return violations;
+}
+
+QList<int> BoardDesignRuleCheck::findCandidates(const QString& layer,
+                                                const QRectF& bounds) const noexcept
+{
+    QSharedPointer<RTree<int>> tree = mLayerTrees.value(layer);
+    if (!tree) return QList<int>();
+    qreal margin = mRules.getMinCopperClearance().toNm();
+    return tree->find(bounds.adjusted(-margin, -margin, margin, margin));
+}
+
+bool BoardDesignRuleCheck::hasClearanceViolation(const CopperObject& a,
+                                                 const CopperObject& b) const
+{
+    // the expanded area of planes is expensive, so it's calculated only if needed
+    if (!a.isPlane) {
+        return intersects(a.expandedArea, b.area);
+    } else if (!b.isPlane) {
+        return intersects(b.expandedArea, a.area);
+    } else {
+        ClipperLib::Paths expandedArea = a.area;
+        ClipperHelpers::offset(expandedArea, mClearanceExpansion, tolerance()); // can throw
+        return intersects(expandedArea, b.area);
+    }
+}
+
+BoardDesignRuleCheck::Violation BoardDesignRuleCheck::createClearanceViolation(
+        const CopperObject& a, const CopperObject& b) const noexcept
+{
+    // sort the keys to get the same owner key regardless of the check order
+    const CopperObject& first = (a.key < b.key) ? a : b;
+    const CopperObject& second = (a.key < b.key) ? b : a;
+    return Violation{"CopperClearance", QString("%1/%2").arg(first.key, second.key),
+                     tr("Clearance violation: %1 <-> %2")
+                     .arg(first.description, second.description)};
+}
+
+QRectF BoardDesignRuleCheck::getBounds(const ClipperLib::Paths& paths) noexcept
+{
+    qreal left = 0, top = 0, right = 0, bottom = 0;
+    bool first = true;
+    for (const ClipperLib::Path& path : paths) {
+        for (const ClipperLib::IntPoint& p : path) {
+            if (first || (p.X < left)) left = p.X;
+            if (first || (p.X > right)) right = p.X;
+            if (first || (p.Y < top)) top = p.Y;
+            if (first || (p.Y > bottom)) bottom = p.Y;
+            first = false;
+        }
+    }
+    return QRectF(QPointF(left, top), QPointF(right, bottom));
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
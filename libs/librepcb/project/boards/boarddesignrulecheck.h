@@ -0,0 +1,180 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_PROJECT_BOARDDESIGNRULECHECK_H
+#define LIBREPCB_PROJECT_BOARDDESIGNRULECHECK_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <clipper/clipper.hpp>
+#include <librepcb/common/boarddesignrules.h>
+#include <librepcb/common/units/all_length_units.h>
+#include <librepcb/common/utils/rtree.h>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+class Board;
+class BI_FootprintPad;
+class BI_NetLine;
+class BI_Plane;
+class BI_Via;
+class NetSignal;
+
+/*****************************************************************************************
+ *  Class BoardDesignRuleCheck
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardDesignRuleCheck class checks a board against its design rules
+ *
+ * The following rules of librepcb::BoardDesignRules are checked:
+ *  - Copper clearance between netlines, pads, vias and plane fragments of different nets
+ *  - Minimum width of netlines and planes
+ *  - Minimum annular ring of vias and THT pads
+ *  - Clearance between drills (vias, THT pads, holes) and foreign copper
+ *
+ * Like librepcb::project::BoardPlaneFragmentsBuilder, the check is split into two steps:
+ * The constructor takes a snapshot of all copper objects (this must be done in the
+ * thread which owns the board, outlines of pads and vias are taken from the
+ * librepcb::project::BoardGeometryCache). #execute() then only works on this snapshot
+ * and distributes the geometric checks to multiple threads. Candidate pairs are found
+ * with a librepcb::RTree per copper layer, so only nearby objects are compared.
+ *
+ * To avoid false positives caused by flattening arcs (e.g. plane fragments are built
+ * with the same arc tolerance), violations smaller than #tolerance() are ignored.
+ */
+class BoardDesignRuleCheck final
+{
+        Q_DECLARE_TR_FUNCTIONS(BoardDesignRuleCheck)
+
+    public:
+
+        // Types
+        struct Violation {
+            QString msgKey;     ///< identifies the violated rule, e.g. "CopperClearance"
+            QString ownerKey;   ///< identifies the involved items (stable between runs)
+            QString message;    ///< human readable description
+        };
+
+        // Constructors / Destructor
+        BoardDesignRuleCheck() = delete;
+        BoardDesignRuleCheck(const BoardDesignRuleCheck& other) = delete;
+        BoardDesignRuleCheck(const Board& board, const BoardDesignRules& rules) noexcept;
+        ~BoardDesignRuleCheck() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Run all checks on the snapshot (thread-safe, blocking)
+         *
+         * @param abort     If not nullptr and set to a non-zero value (from another
+         *                  thread), the check is aborted as soon as possible and an
+         *                  incomplete list is returned.
+         *
+         * @return All found violations (each violation is reported only once, even if
+         *         the involved items are on multiple layers)
+         */
+        QList<Violation> execute(const QAtomicInt* abort = nullptr) const noexcept;
+
+        // Operator Overloadings
+        BoardDesignRuleCheck& operator=(const BoardDesignRuleCheck& rhs) = delete;
+
+        // Static Methods
+        static Length tolerance() noexcept {return Length(5000);}
+        static QString getDescription(const BI_FootprintPad& pad) noexcept;
+        static QString getDescription(const BI_Via& via) noexcept;
+        static QString getDescription(const BI_NetLine& netline) noexcept;
+        static QString getDescription(const BI_Plane& plane) noexcept;
+
+        /**
+         * @brief Check whether two areas overlap (touching areas do not overlap)
+         *
+         * @throw Exception if the paths could not be processed
+         */
+        static bool intersects(const ClipperLib::Paths& a, const ClipperLib::Paths& b);
+
+
+    private: // Types
+        struct CopperObject {
+            QString key;                ///< unique per item (fragments share their plane's key)
+            QString description;        ///< used in messages
+            const NetSignal* netSignal; ///< nullptr if not connected to a net
+            bool isPlane;
+            ClipperLib::Paths area;
+            ClipperLib::Paths expandedArea; ///< area + clearance (empty for planes)
+            QRectF bounds;              ///< bounding rect of #area in nanometers
+        };
+
+        struct Drill {
+            QString key;
+            QString description;
+            const NetSignal* netSignal; ///< nullptr for non-plated holes
+            int copperObject;           ///< index of the own copper (-1 if none)
+            ClipperLib::Path area;      ///< drill + clearance
+            QRectF bounds;              ///< bounding rect of #area in nanometers
+        };
+
+
+    private: // Methods
+        void takeSnapshot(const Board& board) noexcept;
+        void addCopperObject(const QStringList& layers, const CopperObject& obj) noexcept;
+        void addDrill(const Drill& drill) noexcept;
+        void checkCopperWidth(const QString& key, const QString& description,
+                              const Length& width) noexcept;
+        void checkAnnularRing(const QString& key, const QString& description,
+                              const Length& size, const Length& drill) noexcept;
+        QList<Violation> checkClearances(const QString& layer, int first, int count,
+                                         const QAtomicInt* abort) const noexcept;
+        QList<Violation> checkPlaneClearances(const QString& layer, int index,
+                                              const QAtomicInt* abort) const noexcept;
+        QList<Violation> checkDrillClearances(int first, int count,
+                                              const QAtomicInt* abort) const noexcept;
+        QList<int> findCandidates(const QString& layer, const QRectF& bounds) const noexcept;
+        bool hasClearanceViolation(const CopperObject& a, const CopperObject& b) const;
+        Violation createClearanceViolation(const CopperObject& a,
+                                           const CopperObject& b) const noexcept;
+        static QRectF getBounds(const ClipperLib::Paths& paths) noexcept;
+
+
+    private: // Data
+        BoardDesignRules mRules;
+        Length mClearanceExpansion; ///< copper clearance minus tolerance
+
+        // Snapshot
+        QVector<CopperObject> mCopperObjects;
+        QHash<QString, QVector<int>> mLayerObjects; ///< key: copper layer name
+        QHash<QString, QSharedPointer<RTree<int>>> mLayerTrees; ///< key: copper layer name
+        QVector<Drill> mDrills;
+        QList<Violation> mSnapshotViolations; ///< from checks which need no geometry
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
+
+#endif // LIBREPCB_PROJECT_BOARDDESIGNRULECHECK_H
@@ -0,0 +1,90 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "boardgeometrycache.h"
+#include <librepcb/common/utils/clipperhelpers.h>
+#include "items/bi_footprintpad.h"
+#include "items/bi_via.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+BoardGeometryCache::BoardGeometryCache() noexcept
+{
+}
+
+BoardGeometryCache::~BoardGeometryCache() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+ClipperLib::Path BoardGeometryCache::getPadOutline(const BI_FootprintPad& pad,
+    const Length& expansion, const Length& maxArcTolerance) noexcept
+{
+    QHash<Key, ClipperLib::Path>& outlines = mOutlines[&pad];
+    Key key(expansion, maxArcTolerance);
+    if (!outlines.contains(key)) {
+        outlines.insert(key, ClipperHelpers::convert(pad.getSceneOutline(expansion),
+                                                     maxArcTolerance));
+    }
+    return outlines.value(key);
+}
+
+ClipperLib::Path BoardGeometryCache::getViaOutline(const BI_Via& via,
+    const Length& expansion, const Length& maxArcTolerance) noexcept
+{
+    QHash<Key, ClipperLib::Path>& outlines = mOutlines[&via];
+    Key key(expansion, maxArcTolerance);
+    if (!outlines.contains(key)) {
+        outlines.insert(key, ClipperHelpers::convert(via.getSceneOutline(expansion),
+                                                     maxArcTolerance));
+    }
+    return outlines.value(key);
+}
+
+void BoardGeometryCache::invalidateItem(const BI_Base& item) noexcept
+{
+    mOutlines.remove(&item);
+}
+
+void BoardGeometryCache::clear() noexcept
+{
+    mOutlines.clear();
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
@@ -0,0 +1,107 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_PROJECT_BOARDGEOMETRYCACHE_H
+#define LIBREPCB_PROJECT_BOARDGEOMETRYCACHE_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <clipper/clipper.hpp>
+#include <librepcb/common/units/all_length_units.h>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+class BI_Base;
+class BI_FootprintPad;
+class BI_Via;
+
+/*****************************************************************************************
+ *  Class BoardGeometryCache
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardGeometryCache class caches the (flattened) copper outlines of pads and
+ *        vias as ClipperLib polygons
+ *
+ * Converting a pad or via outline to a ClipperLib path requires flattening all arcs,
+ * which is quite expensive and has to be done for every plane rebuild. Since pads and
+ * vias are rarely modified, the converted outlines are cached per item, expansion
+ * (clearance) and arc tolerance.
+ *
+ * Items have to call #invalidateItem() when they are added to or removed from the board
+ * and whenever their outline or position has changed.
+ *
+ * @note Must only be used from the thread which owns the board.
+ */
+class BoardGeometryCache final
+{
+    public:
+
+        // Constructors / Destructor
+        BoardGeometryCache() noexcept;
+        BoardGeometryCache(const BoardGeometryCache& other) = delete;
+        ~BoardGeometryCache() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Get the outline of a pad in scene coordinates
+         *
+         * Same as `ClipperHelpers::convert(pad.getSceneOutline(expansion), maxArcTolerance)`.
+         */
+        ClipperLib::Path getPadOutline(const BI_FootprintPad& pad, const Length& expansion,
+                                       const Length& maxArcTolerance) noexcept;
+
+        /**
+         * @brief Get the outline of a via in scene coordinates
+         *
+         * Same as `ClipperHelpers::convert(via.getSceneOutline(expansion), maxArcTolerance)`.
+         */
+        ClipperLib::Path getViaOutline(const BI_Via& via, const Length& expansion,
+                                       const Length& maxArcTolerance) noexcept;
+
+        void invalidateItem(const BI_Base& item) noexcept;
+        void clear() noexcept;
+
+        // Operator Overloadings
+        BoardGeometryCache& operator=(const BoardGeometryCache& rhs) = delete;
+
+
+    private: // Types
+        typedef QPair<Length, Length> Key; ///< expansion, max. arc tolerance
+
+
+    private: // Data
+        QHash<const BI_Base*, QHash<Key, ClipperLib::Path>> mOutlines;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
+
+#endif // LIBREPCB_PROJECT_BOARDGEOMETRYCACHE_H
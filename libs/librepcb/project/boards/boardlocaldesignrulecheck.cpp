@@ -0,0 +1,128 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "boardlocaldesignrulecheck.h"
+#include <librepcb/common/boarddesignrules.h>
+#include <librepcb/common/graphics/graphicslayer.h>
+#include <librepcb/common/utils/clipperhelpers.h>
+#include "items/bi_footprintpad.h"
+#include "items/bi_netline.h"
+#include "items/bi_via.h"
+#include "board.h"
+#include "boarddesignrulecheck.h"
+#include "boardgeometrycache.h"
+#include "boardspatialindex.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+BoardLocalDesignRuleCheck::BoardLocalDesignRuleCheck(const Board& board) noexcept :
+    mBoard(board)
+{
+}
+
+BoardLocalDesignRuleCheck::~BoardLocalDesignRuleCheck() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+QStringList BoardLocalDesignRuleCheck::checkNetLine(const BI_NetLine& netline) const noexcept
+{
+    QStringList violations;
+    const BoardDesignRules& rules = mBoard.getDesignRules();
+    const NetSignal* netsignal = &netline.getNetSignalOfNetSegment();
+    QString layerName = netline.getLayer().getName();
+    Length tolerance = BoardDesignRuleCheck::tolerance();
+
+    // copper width
+    if (netline.getWidth() < rules.getMinCopperWidth()) {
+        violations.append(tr("Trace width is below %1mm")
+                          .arg(rules.getMinCopperWidth().toMmString()));
+    }
+
+    try {
+        // the area which must not overlap with copper of other nets
+        Length expansion = qMax(rules.getMinCopperClearance() - tolerance, Length(0));
+        Path outline = netline.getSceneOutline(expansion);
+        ClipperLib::Paths area{ClipperHelpers::convert(outline, tolerance)};
+        QRectF areaPx = outline.toQPainterPathPx().boundingRect();
+
+        // netlines, pads and vias
+        BoardGeometryCache& cache = mBoard.getGeometryCache();
+        foreach (const BI_Base* item, mBoard.getSpatialIndex().getItems(areaPx, layerName)) {
+            ClipperLib::Paths obstacle;
+            QString description;
+            switch (item->getType()) {
+                case BI_Base::Type_t::NetLine: {
+                    const BI_NetLine* other = static_cast<const BI_NetLine*>(item);
+                    if (&other->getNetSignalOfNetSegment() == netsignal) continue;
+                    if (other->getLayer().getName() != layerName) continue;
+                    obstacle.push_back(ClipperHelpers::convert(other->getSceneOutline(),
+                                                               tolerance));
+                    description = BoardDesignRuleCheck::getDescription(*other);
+                    break;
+                }
+                case BI_Base::Type_t::FootprintPad: {
+                    const BI_FootprintPad* pad = static_cast<const BI_FootprintPad*>(item);
+                    if (pad->getCompSigInstNetSignal() == netsignal) continue;
+                    if (!pad->isOnLayer(layerName)) continue;
+                    obstacle.push_back(cache.getPadOutline(*pad, Length(0), tolerance));
+                    description = BoardDesignRuleCheck::getDescription(*pad);
+                    break;
+                }
+                case BI_Base::Type_t::Via: {
+                    const BI_Via* via = static_cast<const BI_Via*>(item);
+                    if (&via->getNetSignalOfNetSegment() == netsignal) continue;
+                    obstacle.push_back(cache.getViaOutline(*via, Length(0), tolerance));
+                    description = BoardDesignRuleCheck::getDescription(*via);
+                    break;
+                }
+                default:
+                    continue;
+            }
+            if (BoardDesignRuleCheck::intersects(area, obstacle)) { // can throw
+                violations.append(tr("Clearance violation with %1").arg(description));
+            }
+        }
+    } catch (const Exception& e) {
+        qWarning() << "Failed to check clearance of netline:" << e.getMsg();
+    }
+    return violations;
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
@@ -0,0 +1,97 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_PROJECT_BOARDLOCALDESIGNRULECHECK_H
+#define LIBREPCB_PROJECT_BOARDLOCALDESIGNRULECHECK_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+class Board;
+class BI_NetLine;
+
+/*****************************************************************************************
+ *  Class BoardLocalDesignRuleCheck
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardLocalDesignRuleCheck class checks single items against the design
+ *        rules of a board, fast enough to be used while an item is moved interactively
+ *
+ * In contrast to librepcb::project::BoardDesignRuleCheck, no snapshot of the whole
+ * board is taken. Nearby copper is fetched from the librepcb::project::BoardSpatialIndex
+ * on every check and outlines of pads and vias come from the
+ * librepcb::project::BoardGeometryCache.
+ *
+ * Planes are not checked: While an item is moved, the plane fragments do not yet keep
+ * clearance to it, but they will as soon as the planes are rebuilt. So any overlap with
+ * a plane would be a false positive.
+ *
+ * The same rules and tolerances as in librepcb::project::BoardDesignRuleCheck are used,
+ * i.e. a violation reported here is reported by the board-wide check too.
+ *
+ * @note Must only be used from the thread which owns the board.
+ */
+class BoardLocalDesignRuleCheck final
+{
+        Q_DECLARE_TR_FUNCTIONS(BoardLocalDesignRuleCheck)
+
+    public:
+
+        // Constructors / Destructor
+        BoardLocalDesignRuleCheck() = delete;
+        BoardLocalDesignRuleCheck(const BoardLocalDesignRuleCheck& other) = delete;
+        explicit BoardLocalDesignRuleCheck(const Board& board) noexcept;
+        ~BoardLocalDesignRuleCheck() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Check the width of a netline and its clearance to copper of other nets
+         *
+         * @param netline   The netline to check (must be added to the board).
+         *
+         * @return Human readable descriptions of all violations (empty if there are none)
+         */
+        QStringList checkNetLine(const BI_NetLine& netline) const noexcept;
+
+        // Operator Overloadings
+        BoardLocalDesignRuleCheck& operator=(const BoardLocalDesignRuleCheck& rhs) = delete;
+
+
+    private: // Data
+        const Board& mBoard;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
+
+#endif // LIBREPCB_PROJECT_BOARDLOCALDESIGNRULECHECK_H
@@ -36,6 +36,9 @@
 #include "items/bi_netline.h"
 #include "items/bi_polygon.h"
 #include "items/bi_hole.h"
+#include "board.h"
+#include "boardgeometrycache.h"
+#include "boardspatialindex.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -47,9 +50,13 @@ namespace project {
  *  Constructors / Destructor
  ****************************************************************************************/
 
-BoardPlaneFragmentsBuilder::BoardPlaneFragmentsBuilder(BI_Plane& plane) noexcept :
-    mPlane(plane)
+BoardPlaneFragmentsBuilder::BoardPlaneFragmentsBuilder(const BI_Plane& plane) noexcept :
+    mPlane(plane), mSnapshotTaken(false), mOutline(plane.getOutline()),
+    mMinWidth(plane.getMinWidth()), mMinClearance(plane.getMinClearance()),
+    mKeepOrphans(plane.getKeepOrphans()), mAbort(nullptr)
 {
+    takeSnapshot();
+    mSnapshotTaken = true;
 }
 
 BoardPlaneFragmentsBuilder::~BoardPlaneFragmentsBuilder() noexcept
@@ -60,18 +67,26 @@ BoardPlaneFragmentsBuilder::~BoardPlaneFragmentsBuilder() noexcept
  *  General Methods
  ****************************************************************************************/
 
-QVector<Path> BoardPlaneFragmentsBuilder::buildFragments() noexcept
+QVector<Path> BoardPlaneFragmentsBuilder::buildFragments(const PlaneFragments& otherPlanes,
+                                                         const QAtomicInt* abort) noexcept
 {
+    Q_ASSERT(mSnapshotTaken);
+    mAbort = abort;
     try {
         mResult.clear();
+        mConnectedNetSignalAreas = mConnectedPadAndViaAreas;
         addPlaneOutline();
         clipToBoardOutline();
-        subtractOtherObjects();
+        if (isAborted()) return QVector<Path>();
+        subtractOtherObjects(otherPlanes);
+        if (isAborted()) return QVector<Path>();
         ensureMinimumWidth();
+        if (isAborted()) return QVector<Path>();
         flattenResult();
-        if (!mPlane.getKeepOrphans()) {
+        if (!mKeepOrphans) {
             removeOrphans();
         }
+        if (isAborted()) return QVector<Path>();
         return ClipperHelpers::convert(mResult);
     } catch (const Exception& e) {
         qCritical() << "Failed to build plane fragments! Leave plane empty...";
@@ -80,13 +95,194 @@ QVector<Path> BoardPlaneFragmentsBuilder::buildFragments() noexcept
     }
 }
 
+/*****************************************************************************************
+ *  Static Methods
+ ****************************************************************************************/
+
+QRectF BoardPlaneFragmentsBuilder::getAffectedAreaPx(const BI_Via& via) noexcept
+{
+    QRectF area = via.getSceneOutline().toQPainterPathPx().boundingRect();
+    foreach (const BI_NetPoint* netpoint, via.getNetPoints()) {
+        area = area.united(getAffectedAreaPx(*netpoint));
+    }
+    return area;
+}
+
+QRectF BoardPlaneFragmentsBuilder::getAffectedAreaPx(const BI_NetPoint& netpoint) noexcept
+{
+    QRectF area;
+    foreach (const BI_NetLine* netline, netpoint.getLines()) {
+        area = area.united(netline->getSceneOutline().toQPainterPathPx().boundingRect());
+    }
+    return area;
+}
+
+QRectF BoardPlaneFragmentsBuilder::getAffectedAreaPx(const BI_Device& device) noexcept
+{
+    QRectF area;
+    const BI_Footprint& footprint = device.getFootprint();
+    for (const Hole& hole : footprint.getLibFootprint().getHoles()) {
+        Point pos = footprint.mapToScene(hole.getPosition());
+        Path path = Path::circle(hole.getDiameter()).translated(pos);
+        area = area.united(path.toQPainterPathPx().boundingRect());
+    }
+    foreach (const BI_FootprintPad* pad, footprint.getPads()) {
+        area = area.united(pad->getSceneOutline().toQPainterPathPx().boundingRect());
+        foreach (const BI_NetPoint* netpoint, pad->getNetPoints()) {
+            area = area.united(getAffectedAreaPx(*netpoint));
+        }
+    }
+    return area;
+}
+
+QRectF BoardPlaneFragmentsBuilder::getAffectedAreaPx(const BI_NetSegment& netsegment) noexcept
+{
+    return getAffectedAreaPx(netsegment.getVias(), netsegment.getNetLines());
+}
+
+QRectF BoardPlaneFragmentsBuilder::getAffectedAreaPx(const QList<BI_Via*>& vias,
+    const QList<BI_NetLine*>& netlines) noexcept
+{
+    QRectF area;
+    foreach (const BI_Via* via, vias) {
+        area = area.united(via->getSceneOutline().toQPainterPathPx().boundingRect());
+    }
+    foreach (const BI_NetLine* netline, netlines) {
+        area = area.united(netline->getSceneOutline().toQPainterPathPx().boundingRect());
+    }
+    return area;
+}
+
 /*****************************************************************************************
  *  Private Methods
  ****************************************************************************************/
 
+void BoardPlaneFragmentsBuilder::takeSnapshot() noexcept
+{
+    const BI_Plane& thisPlane = planeForSnapshot();
+    const Board& board = thisPlane.getBoard();
+
+    // board outlines
+    foreach (const BI_Polygon* polygon, board.getPolygons()) {
+        if (polygon->getPolygon().getLayerName() == GraphicsLayer::sBoardOutlines) {
+            mBoardOutlines.append(polygon->getPolygon().getPath());
+        }
+    }
+
+    // other planes
+    foreach (const BI_Plane* plane, board.getPlanes()) {
+        if (plane == &thisPlane) continue;
+        if (*plane < thisPlane) continue; // ignore planes with lower priority
+        if (plane->getLayerName() != thisPlane.getLayerName()) continue;
+        if (&plane->getNetSignal() == &thisPlane.getNetSignal()) continue;
+        mOtherPlanes.append(plane);
+        mOtherPlaneFragments.insert(plane, plane->getFragments());
+    }
+
+    // Only items near the plane can influence it, so fetch them from the spatial index
+    // instead of iterating over all items of the board (the snapshot is taken in the
+    // GUI thread for every plane to rebuild, so it must be cheap).
+    QRectF areaPx = mOutline.toQPainterPathPx().boundingRect();
+    qreal marginPx = (mMinClearance + maxArcTolerance()).toPx();
+    areaPx.adjust(-marginPx, -marginPx, marginPx, marginPx);
+    QList<const BI_FootprintPad*> pads;
+    QList<const BI_Via*> vias;
+    QList<const BI_NetLine*> netlines;
+    QList<BI_Base*> items =
+        board.getSpatialIndex().getItems(areaPx, thisPlane.getLayerName());
+    foreach (const BI_Base* item, items) {
+        switch (item->getType()) {
+            case BI_Base::Type_t::FootprintPad:
+                pads.append(static_cast<const BI_FootprintPad*>(item));
+                break;
+            case BI_Base::Type_t::Via:
+                vias.append(static_cast<const BI_Via*>(item));
+                break;
+            case BI_Base::Type_t::NetLine:
+                netlines.append(static_cast<const BI_NetLine*>(item));
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the spatial index returns items in arbitrary order, but the resulting fragments
+    // must not depend on the history of the index
+    std::sort(pads.begin(), pads.end(),
+              [](const BI_FootprintPad* a, const BI_FootprintPad* b) {
+        const Uuid& deviceA = a->getFootprint().getComponentInstanceUuid();
+        const Uuid& deviceB = b->getFootprint().getComponentInstanceUuid();
+        if (deviceA != deviceB) {
+            return deviceA < deviceB;
+        }
+        return a->getLibPadUuid() < b->getLibPadUuid();
+    });
+    std::sort(vias.begin(), vias.end(), [](const BI_Via* a, const BI_Via* b) {
+        return a->getUuid() < b->getUuid();
+    });
+    std::sort(netlines.begin(), netlines.end(),
+              [](const BI_NetLine* a, const BI_NetLine* b) {
+        return a->getUuid() < b->getUuid();
+    });
+
+    // outlines of pads and vias are taken from the cache to avoid flattening their arcs
+    // again for every rebuild
+    BoardGeometryCache& cache = board.getGeometryCache();
+
+    // holes from devices
+    foreach (const BI_Device* device, board.getDeviceInstances()) {
+        for (const Hole& hole : device->getFootprint().getLibFootprint().getHoles()) {
+            Point pos = device->getFootprint().mapToScene(hole.getPosition());
+            Length dia = hole.getDiameter() + mMinClearance * 2;
+            mCutOuts.append(Path::circle(dia).translated(pos));
+        }
+    }
+
+    // board holes
+    for (const BI_Hole* hole : board.getHoles()) {
+        Length dia = hole->getHole().getDiameter() + mMinClearance * 2;
+        mCutOuts.append(Path::circle(dia).translated(hole->getHole().getPosition()));
+    }
+
+    // pads
+    foreach (const BI_FootprintPad* pad, pads) {
+        if (!pad->isOnLayer(thisPlane.getLayerName())) continue;
+        if (pad->getCompSigInstNetSignal() == &thisPlane.getNetSignal()) {
+            mConnectedPadAndViaAreas.push_back(
+                cache.getPadOutline(*pad, Length(0), maxArcTolerance()));
+        }
+        if (needsCutOut(*pad)) {
+            mPadAndViaCutOuts.push_back(
+                cache.getPadOutline(*pad, mMinClearance, maxArcTolerance()));
+        }
+    }
+
+    // vias
+    foreach (const BI_Via* via, vias) {
+        if (&via->getNetSignalOfNetSegment() == &thisPlane.getNetSignal()) {
+            mConnectedPadAndViaAreas.push_back(
+                cache.getViaOutline(*via, Length(0), maxArcTolerance()));
+        }
+        if (needsCutOut(*via)) {
+            mPadAndViaCutOuts.push_back(
+                cache.getViaOutline(*via, mMinClearance, maxArcTolerance()));
+        }
+    }
+
+    // netlines
+    foreach (const BI_NetLine* netline, netlines) {
+        if (netline->getLayer().getName() != thisPlane.getLayerName()) continue;
+        if (&netline->getNetSignalOfNetSegment() == &thisPlane.getNetSignal()) {
+            mConnectedNetSignalOutlines.append(netline->getSceneOutline());
+        } else {
+            mCutOuts.append(netline->getSceneOutline(mMinClearance));
+        }
+    }
+}
+
 void BoardPlaneFragmentsBuilder::addPlaneOutline()
 {
-    mResult.push_back(ClipperHelpers::convert(mPlane.getOutline(), maxArcTolerance()));
+    mResult.push_back(ClipperHelpers::convert(mOutline, maxArcTolerance()));
 }
 
 void BoardPlaneFragmentsBuilder::clipToBoardOutline()
@@ -94,18 +290,15 @@ void BoardPlaneFragmentsBuilder::clipToBoardOutline()
     // determine board area
     ClipperLib::Paths boardArea;
     ClipperLib::Clipper boardAreaClipper;
-    foreach (const BI_Polygon* polygon, mPlane.getBoard().getPolygons()) {
-        if (polygon->getPolygon().getLayerName() == GraphicsLayer::sBoardOutlines) {
-            ClipperLib::Path path = ClipperHelpers::convert(polygon->getPolygon().getPath(),
-                                                            maxArcTolerance());
-            boardAreaClipper.AddPath(path, ClipperLib::ptSubject, true);
-        }
+    foreach (const Path& outline, mBoardOutlines) {
+        ClipperLib::Path path = ClipperHelpers::convert(outline, maxArcTolerance());
+        boardAreaClipper.AddPath(path, ClipperLib::ptSubject, true);
     }
     boardAreaClipper.Execute(ClipperLib::ctXor, boardArea, ClipperLib::pftEvenOdd,
                              ClipperLib::pftEvenOdd);
 
     // perform clearance offset
-    ClipperHelpers::offset(boardArea, -mPlane.getMinClearance(), maxArcTolerance()); // can throw
+    ClipperHelpers::offset(boardArea, -mMinClearance, maxArcTolerance()); // can throw
 
     // if we have no board area, abort here
     if (boardArea.empty()) return;
@@ -118,77 +311,35 @@ void BoardPlaneFragmentsBuilder::clipToBoardOutline()
                  ClipperLib::pftNonZero);
 }
 
-void BoardPlaneFragmentsBuilder::subtractOtherObjects()
+void BoardPlaneFragmentsBuilder::subtractOtherObjects(const PlaneFragments& otherPlanes)
 {
     ClipperLib::Clipper c;
     c.AddPaths(mResult, ClipperLib::ptSubject, true);
 
     // subtract other planes
-    foreach (const BI_Plane* plane, mPlane.getBoard().getPlanes()) {
-        if (plane == &mPlane) continue;
-        if (*plane < mPlane) continue; // ignore planes with lower priority
-        if (plane->getLayerName() != mPlane.getLayerName()) continue;
-        if (&plane->getNetSignal() == &mPlane.getNetSignal()) continue;
-        ClipperLib::Paths paths = ClipperHelpers::convert(plane->getFragments(),
-                                                          maxArcTolerance());
-        ClipperHelpers::offset(paths, mPlane.getMinClearance(), maxArcTolerance()); // can throw
+    foreach (const BI_Plane* plane, mOtherPlanes) {
+        if (isAborted()) return;
+        ClipperLib::Paths paths = ClipperHelpers::convert(
+            otherPlanes.value(plane, mOtherPlaneFragments.value(plane)), maxArcTolerance());
+        ClipperHelpers::offset(paths, mMinClearance, maxArcTolerance()); // can throw
         c.AddPaths(paths, ClipperLib::ptClip, true);
     }
 
-    // subtract holes and pads from devices
-    foreach (const BI_Device* device, mPlane.getBoard().getDeviceInstances()) {
-        for (const Hole& hole : device->getFootprint().getLibFootprint().getHoles()) {
-            Point pos = device->getFootprint().mapToScene(hole.getPosition());
-            Length dia = hole.getDiameter() + mPlane.getMinClearance() * 2;
-            Path path = Path::circle(dia).translated(pos);
-            c.AddPath(ClipperHelpers::convert(path, maxArcTolerance()),
-                      ClipperLib::ptClip, true);
-        }
-        foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
-            if (!pad->isOnLayer(mPlane.getLayerName())) continue;
-            if (pad->getCompSigInstNetSignal() == &mPlane.getNetSignal()) {
-                ClipperLib::Path path = ClipperHelpers::convert(pad->getSceneOutline(),
-                                                                maxArcTolerance());
-                mConnectedNetSignalAreas.push_back(path);
-            }
-            c.AddPath(createPadCutOut(*pad), ClipperLib::ptClip, true);
-        }
-    }
+    // subtract pads and vias
+    c.AddPaths(mPadAndViaCutOuts, ClipperLib::ptClip, true);
 
-    // subtract board holes
-    for (const BI_Hole* hole : mPlane.getBoard().getHoles()) {
-        Length dia = hole->getHole().getDiameter() + mPlane.getMinClearance() * 2;
-        Path path = Path::circle(dia).translated(hole->getHole().getPosition());
-        c.AddPath(ClipperHelpers::convert(path, maxArcTolerance()),
+    // subtract holes and netlines
+    foreach (const Path& cutOut, mCutOuts) {
+        if (isAborted()) return; // flattening arcs is expensive
+        c.AddPath(ClipperHelpers::convert(cutOut, maxArcTolerance()),
                   ClipperLib::ptClip, true);
     }
 
-    // subtract net segment items
-    foreach (const BI_NetSegment* netsegment, mPlane.getBoard().getNetSegments()) {
-
-        // subtract vias
-        foreach (const BI_Via* via, netsegment->getVias()) {
-            if (&netsegment->getNetSignal() == &mPlane.getNetSignal()) {
-                ClipperLib::Path path = ClipperHelpers::convert(via->getSceneOutline(),
-                                                                maxArcTolerance());
-                mConnectedNetSignalAreas.push_back(path);
-            }
-            c.AddPath(createViaCutOut(*via), ClipperLib::ptClip, true);
-        }
-
-        // subtract netlines
-        foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
-            if (netline->getLayer().getName() != mPlane.getLayerName()) continue;
-            if (&netsegment->getNetSignal() == &mPlane.getNetSignal()) {
-                ClipperLib::Path path = ClipperHelpers::convert(netline->getSceneOutline(),
-                                                                maxArcTolerance());
-                mConnectedNetSignalAreas.push_back(path);
-            } else {
-                ClipperLib::Path path = ClipperHelpers::convert(
-                    netline->getSceneOutline(mPlane.getMinClearance()), maxArcTolerance());
-                c.AddPath(path, ClipperLib::ptClip, true);
-            }
-        }
+    // remember areas connected to the plane's net signal (to detect orphans)
+    foreach (const Path& outline, mConnectedNetSignalOutlines) {
+        if (isAborted()) return;
+        mConnectedNetSignalAreas.push_back(ClipperHelpers::convert(outline,
+                                                                   maxArcTolerance()));
     }
 
     c.Execute(ClipperLib::ctDifference, mResult, ClipperLib::pftEvenOdd,
@@ -197,8 +348,9 @@ void BoardPlaneFragmentsBuilder::subtractOtherObjects()
 
 void BoardPlaneFragmentsBuilder::ensureMinimumWidth()
 {
-    Length delta = mPlane.getMinWidth() / 2;
+    Length delta = mMinWidth / 2;
     ClipperHelpers::offset(mResult, -delta, maxArcTolerance()); // can throw
+    if (isAborted()) return;
     ClipperHelpers::offset(mResult, delta, maxArcTolerance()); // can throw
 }
 
@@ -218,6 +370,7 @@ void BoardPlaneFragmentsBuilder::removeOrphans()
 {
     mResult.erase(std::remove_if(mResult.begin(), mResult.end(),
         [this](const ClipperLib::Path& p){
+            if (isAborted()) return false; // the result is discarded anyway
             ClipperLib::Paths intersections;
             ClipperLib::Clipper c;
             c.AddPaths(mConnectedNetSignalAreas, ClipperLib::ptSubject, true);
@@ -233,24 +386,18 @@ void BoardPlaneFragmentsBuilder::removeOrphans()
  *  Helper Methods
  ****************************************************************************************/
 
-ClipperLib::Path BoardPlaneFragmentsBuilder::createPadCutOut(const BI_FootprintPad& pad) const noexcept
+bool BoardPlaneFragmentsBuilder::needsCutOut(const BI_FootprintPad& pad) const noexcept
 {
-    bool differentNetSignal = (pad.getCompSigInstNetSignal() != &mPlane.getNetSignal());
-    if ((mPlane.getConnectStyle() == BI_Plane::ConnectStyle::None) || differentNetSignal) {
-        return ClipperHelpers::convert(pad.getSceneOutline(mPlane.getMinClearance()), maxArcTolerance());
-    } else {
-        return ClipperLib::Path();
-    }
+    const BI_Plane& plane = planeForSnapshot();
+    bool differentNetSignal = (pad.getCompSigInstNetSignal() != &plane.getNetSignal());
+    return (plane.getConnectStyle() == BI_Plane::ConnectStyle::None) || differentNetSignal;
 }
 
-ClipperLib::Path BoardPlaneFragmentsBuilder::createViaCutOut(const BI_Via& via) const noexcept
+bool BoardPlaneFragmentsBuilder::needsCutOut(const BI_Via& via) const noexcept
 {
-    bool differentNetSignal = (&via.getNetSignalOfNetSegment() != &mPlane.getNetSignal());
-    if ((mPlane.getConnectStyle() == BI_Plane::ConnectStyle::None) || differentNetSignal) {
-        return ClipperHelpers::convert(via.getSceneOutline(mPlane.getMinClearance()), maxArcTolerance());
-    } else {
-        return ClipperLib::Path();
-    }
+    const BI_Plane& plane = planeForSnapshot();
+    bool differentNetSignal = (&via.getNetSignalOfNetSegment() != &plane.getNetSignal());
+    return (plane.getConnectStyle() == BI_Plane::ConnectStyle::None) || differentNetSignal;
 }
 
 /*****************************************************************************************
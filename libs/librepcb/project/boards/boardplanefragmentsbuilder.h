@@ -35,6 +35,10 @@ namespace project {
 
 class BI_Plane;
 class BI_Via;
+class BI_NetPoint;
+class BI_NetLine;
+class BI_NetSegment;
+class BI_Device;
 class BI_FootprintPad;
 
 /*****************************************************************************************
@@ -43,35 +47,99 @@ class BI_FootprintPad;
 
 /**
  * @brief The BoardPlaneFragmentsBuilder class
+ *
+ * Building the fragments is split into two steps: The constructor takes a snapshot of
+ * all board items needed to calculate the fragments of a plane (this must be done in
+ * the thread which owns the board). #buildFragments() then only works on this snapshot,
+ * so it can be called from any thread, even if the board is modified meanwhile.
  */
 class BoardPlaneFragmentsBuilder final
 {
     public:
 
+        // Types
+        typedef QHash<const BI_Plane*, QVector<Path>> PlaneFragments;
+
         // Constructors / Destructor
         BoardPlaneFragmentsBuilder() = delete;
         BoardPlaneFragmentsBuilder(const BoardPlaneFragmentsBuilder& other) = delete;
-        BoardPlaneFragmentsBuilder(BI_Plane& plane) noexcept;
+        BoardPlaneFragmentsBuilder(const BI_Plane& plane) noexcept;
         ~BoardPlaneFragmentsBuilder() noexcept;
 
+        // Getters
+
+        /**
+         * @brief Get the plane to build
+         *
+         * @warning While #buildFragments() is running in another thread, the returned
+         *          plane must only be used as identifier (it may be modified or even
+         *          deleted meanwhile).
+         */
+        const BI_Plane& getPlane() const noexcept {return mPlane;}
+
         // General Methods
-        QVector<Path> buildFragments() noexcept;
+
+        /**
+         * @brief Calculate the fragments of the plane (thread-safe)
+         *
+         * @param otherPlanes   Fragments of other planes which were built but not yet
+         *                      assigned to their planes. For planes not contained in this
+         *                      hash, the fragments from the snapshot are used. This
+         *                      allows to build a whole chain of planes without modifying
+         *                      the board.
+         * @param abort         If not nullptr and set to a non-zero value (from another
+         *                      thread), the build is aborted as soon as possible and an
+         *                      empty list is returned. The flag is checked between (and
+         *                      within) the expensive clipping steps.
+         *
+         * @return The calculated plane fragments
+         */
+        QVector<Path> buildFragments(const PlaneFragments& otherPlanes = PlaneFragments(),
+                                     const QAtomicInt* abort = nullptr) noexcept;
 
         // Operator Overloadings
         BoardPlaneFragmentsBuilder& operator=(const BoardPlaneFragmentsBuilder& rhs) = delete;
 
+        // Static Methods
+
+        /**
+         * @brief Get the scene area (in pixels) where an item may influence plane fragments
+         *
+         * The returned area does not contain any clearance, it is the bounding rect of
+         * all copper which moves together with the passed item (including attached
+         * netlines). Used to mark planes as dirty, see
+         * librepcb::project::Board::invalidatePlanes().
+         */
+        static QRectF getAffectedAreaPx(const BI_Via& via) noexcept;
+        static QRectF getAffectedAreaPx(const BI_NetPoint& netpoint) noexcept;
+        static QRectF getAffectedAreaPx(const BI_Device& device) noexcept;
+        static QRectF getAffectedAreaPx(const BI_NetSegment& netsegment) noexcept;
+        static QRectF getAffectedAreaPx(const QList<BI_Via*>& vias,
+                                        const QList<BI_NetLine*>& netlines) noexcept;
+
 
     private: // Methods
+        void takeSnapshot() noexcept;
         void addPlaneOutline();
         void clipToBoardOutline();
-        void subtractOtherObjects();
+        void subtractOtherObjects(const PlaneFragments& otherPlanes);
         void ensureMinimumWidth();
         void flattenResult();
         void removeOrphans();
 
         // Helper Methods
-        ClipperLib::Path createPadCutOut(const BI_FootprintPad& pad) const noexcept;
-        ClipperLib::Path createViaCutOut(const BI_Via& via) const noexcept;
+        bool needsCutOut(const BI_FootprintPad& pad) const noexcept;
+        bool needsCutOut(const BI_Via& via) const noexcept;
+        bool isAborted() const noexcept {return mAbort && mAbort->load();}
+
+        /**
+         * Returns the plane to build, but only while taking the snapshot. Everything
+         * reachable from #buildFragments() must use the snapshot instead.
+         */
+        const BI_Plane& planeForSnapshot() const noexcept {
+            Q_ASSERT(!mSnapshotTaken);
+            return mPlane;
+        }
 
         /**
          * Returns the maximum allowed arc tolerance when flattening arcs. Do not change
@@ -82,7 +150,24 @@ class BoardPlaneFragmentsBuilder final
 
 
     private: // Data
-        BI_Plane& mPlane;
+        const BI_Plane& mPlane; ///< only used as identifier, see #planeForSnapshot()
+        bool mSnapshotTaken;
+
+        // Snapshot
+        Path mOutline;
+        Length mMinWidth;
+        Length mMinClearance;
+        bool mKeepOrphans;
+        QVector<Path> mBoardOutlines;
+        QVector<const BI_Plane*> mOtherPlanes; ///< higher priority planes, same layer
+        PlaneFragments mOtherPlaneFragments;
+        QVector<Path> mCutOuts; ///< holes and netlines
+        QVector<Path> mConnectedNetSignalOutlines; ///< netlines
+        ClipperLib::Paths mPadAndViaCutOuts; ///< from librepcb::project::BoardGeometryCache
+        ClipperLib::Paths mConnectedPadAndViaAreas; ///< from the geometry cache
+
+        // Results
+        const QAtomicInt* mAbort; ///< see #buildFragments()
         ClipperLib::Paths mConnectedNetSignalAreas;
         ClipperLib::Paths mResult;
 };
@@ -0,0 +1,145 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include "boardspatialindex.h"
+#include <librepcb/common/graphics/graphicslayer.h>
+#include "items/bi_footprintpad.h"
+#include "items/bi_netpoint.h"
+#include "items/bi_netline.h"
+#include "items/bi_stroketext.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+BoardSpatialIndex::BoardSpatialIndex() noexcept
+{
+}
+
+BoardSpatialIndex::~BoardSpatialIndex() noexcept
+{
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+void BoardSpatialIndex::addItem(BI_Base& item) noexcept
+{
+    Q_ASSERT(!mEntries.contains(&item));
+    mEntries.insert(&item, Entry{false, QString(), QRectF()});
+    mInvalidatedItems.insert(&item);
+}
+
+void BoardSpatialIndex::removeItem(BI_Base& item) noexcept
+{
+    Q_ASSERT(mEntries.contains(&item));
+    Entry entry = mEntries.take(&item);
+    if (entry.indexed) {
+        bool removed = mTrees.value(entry.layerName)->remove(entry.rectPx, &item);
+        Q_ASSERT(removed); Q_UNUSED(removed);
+    }
+    mInvalidatedItems.remove(&item);
+}
+
+void BoardSpatialIndex::invalidateItem(BI_Base& item) noexcept
+{
+    if (mEntries.contains(&item)) {
+        mInvalidatedItems.insert(&item);
+    }
+}
+
+QList<BI_Base*> BoardSpatialIndex::getItems(const QRectF& rectPx,
+                                            const QString& layerName) const noexcept
+{
+    updateInvalidatedItems();
+    QList<BI_Base*> items;
+    if (layerName.isEmpty()) {
+        foreach (const QSharedPointer<RTree<BI_Base*>>& tree, mTrees) {
+            items.append(tree->find(rectPx));
+        }
+    } else {
+        if (mTrees.contains(layerName)) {
+            items.append(mTrees.value(layerName)->find(rectPx));
+        }
+        if (mTrees.contains(QString())) {
+            items.append(mTrees.value(QString())->find(rectPx));
+        }
+    }
+    return items;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+void BoardSpatialIndex::updateInvalidatedItems() const noexcept
+{
+    foreach (BI_Base* item, mInvalidatedItems) {
+        Entry& entry = mEntries[item];
+        if (entry.indexed) {
+            mTrees.value(entry.layerName)->remove(entry.rectPx, item);
+        }
+        entry.layerName = getLayerName(*item);
+        entry.rectPx = item->getGrabAreaScenePx().boundingRect();
+        if (!mTrees.contains(entry.layerName)) {
+            mTrees.insert(entry.layerName,
+                          QSharedPointer<RTree<BI_Base*>>(new RTree<BI_Base*>()));
+        }
+        mTrees.value(entry.layerName)->insert(entry.rectPx, item);
+        entry.indexed = true;
+    }
+    mInvalidatedItems.clear();
+}
+
+QString BoardSpatialIndex::getLayerName(const BI_Base& item) noexcept
+{
+    switch (item.getType()) {
+        case BI_Base::Type_t::NetPoint:
+            return static_cast<const BI_NetPoint&>(item).getLayer().getName();
+        case BI_Base::Type_t::NetLine:
+            return static_cast<const BI_NetLine&>(item).getLayer().getName();
+        case BI_Base::Type_t::StrokeText:
+            return static_cast<const BI_StrokeText&>(item).getText().getLayerName();
+        case BI_Base::Type_t::FootprintPad: {
+            // THT pads are on all copper layers
+            QString layerName = static_cast<const BI_FootprintPad&>(item).getLayerName();
+            return GraphicsLayer::isCopperLayer(layerName) ? layerName : QString();
+        }
+        default: // vias, footprints
+            return QString();
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
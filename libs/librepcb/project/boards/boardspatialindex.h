@@ -0,0 +1,123 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_PROJECT_BOARDSPATIALINDEX_H
+#define LIBREPCB_PROJECT_BOARDSPATIALINDEX_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <librepcb/common/utils/rtree.h>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+
+class BI_Base;
+
+/*****************************************************************************************
+ *  Class BoardSpatialIndex
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardSpatialIndex class allows fast lookup of board items by scene area
+ *
+ * Items are indexed with the bounding rect of their grab area
+ * (librepcb::project::BI_Base::getGrabAreaScenePx()), separated by layer. Items which
+ * are not bound to a single layer (vias, THT pads, footprints) are put into a separate
+ * tree which is included in every query.
+ *
+ * Items have to add themselves when they are added to the board, remove themselves when
+ * they are removed from the board, and call #invalidateItem() whenever their grab area
+ * or layer has changed. Invalidated items are only re-indexed on the next query, so
+ * invalidating is cheap and may be done before the item has updated its graphics item.
+ *
+ * Currently indexed: vias, netpoints, netlines, footprints, footprint pads and stroke
+ * texts. Planes, polygons and holes are few and modified through their geometry objects,
+ * so they are not indexed (yet).
+ *
+ * @note Must only be used from the thread which owns the board.
+ */
+class BoardSpatialIndex final
+{
+    public:
+
+        // Constructors / Destructor
+        BoardSpatialIndex() noexcept;
+        BoardSpatialIndex(const BoardSpatialIndex& other) = delete;
+        ~BoardSpatialIndex() noexcept;
+
+        // General Methods
+        void addItem(BI_Base& item) noexcept;
+        void removeItem(BI_Base& item) noexcept;
+        void invalidateItem(BI_Base& item) noexcept;
+
+        /**
+         * @brief Get all items whose grab area bounding rect intersects a scene area
+         *
+         * @param rectPx        The scene area in pixels (may have zero size to query a
+         *                      single point).
+         * @param layerName     If not empty, only items on this layer (and items not
+         *                      bound to a single layer) are returned.
+         *
+         * @return Candidates in arbitrary order (the caller has to check the exact
+         *         grab area if needed)
+         *
+         * @note Invalidated items are re-indexed before the query. This only updates the
+         *       internal cache (the indexed rects always represent the items' current
+         *       grab areas from the caller's view), that's why this method is const and
+         *       the trees are mutable.
+         */
+        QList<BI_Base*> getItems(const QRectF& rectPx,
+                                 const QString& layerName = QString()) const noexcept;
+
+        // Operator Overloadings
+        BoardSpatialIndex& operator=(const BoardSpatialIndex& rhs) = delete;
+
+
+    private: // Types
+        struct Entry {
+            bool indexed;       ///< whether the item is currently contained in a tree
+            QString layerName;  ///< the key of the tree containing the item
+            QRectF rectPx;      ///< the rect the item was indexed with
+        };
+
+
+    private: // Methods
+        void updateInvalidatedItems() const noexcept;
+        static QString getLayerName(const BI_Base& item) noexcept;
+
+
+    private: // Data
+        mutable QHash<BI_Base*, Entry> mEntries;
+        mutable QSet<BI_Base*> mInvalidatedItems;
+        mutable QHash<QString, QSharedPointer<RTree<BI_Base*>>> mTrees; ///< key: layer name
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace project
+} // namespace librepcb
+
+#endif // LIBREPCB_PROJECT_BOARDSPATIALINDEX_H
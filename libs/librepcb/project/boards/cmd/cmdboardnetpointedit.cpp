@@ -26,6 +26,8 @@
 #include "../items/bi_netpoint.h"
 #include "../items/bi_footprintpad.h"
 #include "../items/bi_via.h"
+#include "../board.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -42,7 +44,8 @@ CmdBoardNetPointEdit::CmdBoardNetPointEdit(BI_NetPoint& point) noexcept :
     mOldLayer(&point.getLayer()), mNewLayer(mOldLayer),
     mOldFootprintPad(point.getFootprintPad()), mNewFootprintPad(mOldFootprintPad),
     mOldVia(point.getVia()), mNewVia(mOldVia),
-    mOldPos(point.getPosition()), mNewPos(mOldPos)
+    mOldPos(point.getPosition()), mNewPos(mOldPos),
+    mOldPlaneAreaPx(BoardPlaneFragmentsBuilder::getAffectedAreaPx(point)), mNewPlaneAreaPx()
 {
 }
 
@@ -99,6 +102,9 @@ bool CmdBoardNetPointEdit::performExecute()
 {
     performRedo(); // can throw
 
+    mNewPlaneAreaPx = BoardPlaneFragmentsBuilder::getAffectedAreaPx(mNetPoint);
+    mNetPoint.getBoard().invalidatePlanes(mNewPlaneAreaPx);
+
     return true; // TODO: determine if the netpoint was really modified
 }
 
@@ -113,6 +119,8 @@ void CmdBoardNetPointEdit::performUndo()
     sgl.add([&](){mNetPoint.setViaToAttach(mNewVia);});
     mNetPoint.setPosition(mOldPos);
     sgl.dismiss();
+    mNetPoint.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mNetPoint.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 void CmdBoardNetPointEdit::performRedo()
@@ -126,6 +134,8 @@ void CmdBoardNetPointEdit::performRedo()
     sgl.add([&](){mNetPoint.setViaToAttach(mOldVia);});
     mNetPoint.setPosition(mNewPos);
     sgl.dismiss();
+    mNetPoint.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mNetPoint.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 /*****************************************************************************************
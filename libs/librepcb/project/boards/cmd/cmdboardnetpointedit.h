@@ -92,6 +92,10 @@ class CmdBoardNetPointEdit final : public UndoCommand
         BI_Via* mNewVia;
         Point mOldPos;
         Point mNewPos;
+
+        // Plane areas (see librepcb::project::Board::invalidatePlanes())
+        QRectF mOldPlaneAreaPx;
+        QRectF mNewPlaneAreaPx;
 };
 
 /*****************************************************************************************
@@ -24,6 +24,7 @@
 #include "cmdboardnetsegmentadd.h"
 #include "../board.h"
 #include "../items/bi_netsegment.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -72,11 +73,13 @@ bool CmdBoardNetSegmentAdd::performExecute()
 void CmdBoardNetSegmentAdd::performUndo()
 {
     mBoard.removeNetSegment(*mNetSegment); // can throw
+    mBoard.invalidatePlanes(BoardPlaneFragmentsBuilder::getAffectedAreaPx(*mNetSegment));
 }
 
 void CmdBoardNetSegmentAdd::performRedo()
 {
     mBoard.addNetSegment(*mNetSegment); // can throw
+    mBoard.invalidatePlanes(BoardPlaneFragmentsBuilder::getAffectedAreaPx(*mNetSegment));
 }
 
 /*****************************************************************************************
@@ -22,9 +22,11 @@
  ****************************************************************************************/
 #include <QtCore>
 #include "cmdboardnetsegmentaddelements.h"
+#include "../board.h"
 #include "../items/bi_netpoint.h"
 #include "../items/bi_netline.h"
 #include "../items/bi_netsegment.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -117,11 +119,15 @@ bool CmdBoardNetSegmentAddElements::performExecute()
 void CmdBoardNetSegmentAddElements::performUndo()
 {
     mNetSegment.removeElements(mVias, mNetPoints, mNetLines); // can throw
+    mNetSegment.getBoard().invalidatePlanes(
+        BoardPlaneFragmentsBuilder::getAffectedAreaPx(mVias, mNetLines));
 }
 
 void CmdBoardNetSegmentAddElements::performRedo()
 {
     mNetSegment.addElements(mVias, mNetPoints, mNetLines); // can throw
+    mNetSegment.getBoard().invalidatePlanes(
+        BoardPlaneFragmentsBuilder::getAffectedAreaPx(mVias, mNetLines));
 }
 
 /*****************************************************************************************
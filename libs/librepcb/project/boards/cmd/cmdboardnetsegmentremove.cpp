@@ -24,6 +24,7 @@
 #include "cmdboardnetsegmentremove.h"
 #include "../board.h"
 #include "../items/bi_netsegment.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -59,11 +60,13 @@ bool CmdBoardNetSegmentRemove::performExecute()
 void CmdBoardNetSegmentRemove::performUndo()
 {
     mBoard.addNetSegment(mNetSegment); // can throw
+    mBoard.invalidatePlanes(BoardPlaneFragmentsBuilder::getAffectedAreaPx(mNetSegment));
 }
 
 void CmdBoardNetSegmentRemove::performRedo()
 {
     mBoard.removeNetSegment(mNetSegment); // can throw
+    mBoard.invalidatePlanes(BoardPlaneFragmentsBuilder::getAffectedAreaPx(mNetSegment));
 }
 
 /*****************************************************************************************
@@ -26,6 +26,7 @@
 #include "../items/bi_netpoint.h"
 #include "../items/bi_netline.h"
 #include "../items/bi_netsegment.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -80,11 +81,15 @@ bool CmdBoardNetSegmentRemoveElements::performExecute()
 void CmdBoardNetSegmentRemoveElements::performUndo()
 {
     mNetSegment.addElements(mVias, mNetPoints, mNetLines); // can throw
+    mNetSegment.getBoard().invalidatePlanes(
+        BoardPlaneFragmentsBuilder::getAffectedAreaPx(mVias, mNetLines));
 }
 
 void CmdBoardNetSegmentRemoveElements::performRedo()
 {
     mNetSegment.removeElements(mVias, mNetPoints, mNetLines); // can throw
+    mNetSegment.getBoard().invalidatePlanes(
+        BoardPlaneFragmentsBuilder::getAffectedAreaPx(mVias, mNetLines));
 }
 
 /*****************************************************************************************
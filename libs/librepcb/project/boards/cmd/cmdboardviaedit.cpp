@@ -23,6 +23,8 @@
 #include <QtCore>
 #include "cmdboardviaedit.h"
 #include "../items/bi_via.h"
+#include "../board.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -39,7 +41,8 @@ CmdBoardViaEdit::CmdBoardViaEdit(BI_Via& via) noexcept :
     mOldPos(via.getPosition()), mNewPos(mOldPos),
     mOldShape(via.getShape()), mNewShape(mOldShape),
     mOldSize(via.getSize()), mNewSize(mOldSize),
-    mOldDrillDiameter(via.getDrillDiameter()), mNewDrillDiameter(mOldDrillDiameter)
+    mOldDrillDiameter(via.getDrillDiameter()), mNewDrillDiameter(mOldDrillDiameter),
+    mOldPlaneAreaPx(BoardPlaneFragmentsBuilder::getAffectedAreaPx(via)), mNewPlaneAreaPx()
 {
 }
 
@@ -100,6 +103,9 @@ bool CmdBoardViaEdit::performExecute()
 {
     performRedo(); // can throw
 
+    mNewPlaneAreaPx = BoardPlaneFragmentsBuilder::getAffectedAreaPx(mVia);
+    mVia.getBoard().invalidatePlanes(mNewPlaneAreaPx);
+
     return true; // TODO: determine if the via was really modified
 }
 
@@ -109,6 +115,8 @@ void CmdBoardViaEdit::performUndo()
     mVia.setShape(mOldShape);
     mVia.setSize(mOldSize);
     mVia.setDrillDiameter(mOldDrillDiameter);
+    mVia.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mVia.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 void CmdBoardViaEdit::performRedo()
@@ -117,6 +125,8 @@ void CmdBoardViaEdit::performRedo()
     mVia.setShape(mNewShape);
     mVia.setSize(mNewSize);
     mVia.setDrillDiameter(mNewDrillDiameter);
+    mVia.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mVia.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 /*****************************************************************************************
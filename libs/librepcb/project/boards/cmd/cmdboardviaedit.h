@@ -87,6 +87,10 @@ class CmdBoardViaEdit final : public UndoCommand
         Length mNewSize;
         Length mOldDrillDiameter;
         Length mNewDrillDiameter;
+
+        // Plane areas (see librepcb::project::Board::invalidatePlanes())
+        QRectF mOldPlaneAreaPx;
+        QRectF mNewPlaneAreaPx;
 };
 
 /*****************************************************************************************
@@ -23,6 +23,8 @@
 #include <QtCore>
 #include "cmddeviceinstanceedit.h"
 #include "../items/bi_device.h"
+#include "../board.h"
+#include "../boardplanefragmentsbuilder.h"
 
 /*****************************************************************************************
  *  Namespace
@@ -38,7 +40,8 @@ CmdDeviceInstanceEdit::CmdDeviceInstanceEdit(BI_Device& dev) noexcept :
     UndoCommand(tr("Edit device instance")), mDevice(dev),
     mOldPos(mDevice.getPosition()), mNewPos(mOldPos),
     mOldRotation(mDevice.getRotation()), mNewRotation(mOldRotation),
-    mOldMirrored(mDevice.getIsMirrored()), mNewMirrored(mOldMirrored)
+    mOldMirrored(mDevice.getIsMirrored()), mNewMirrored(mOldMirrored),
+    mOldPlaneAreaPx(BoardPlaneFragmentsBuilder::getAffectedAreaPx(dev)), mNewPlaneAreaPx()
 {
 }
 
@@ -141,6 +144,9 @@ bool CmdDeviceInstanceEdit::performExecute()
 {
     performRedo(); // can throw
 
+    mNewPlaneAreaPx = BoardPlaneFragmentsBuilder::getAffectedAreaPx(mDevice);
+    mDevice.getBoard().invalidatePlanes(mNewPlaneAreaPx);
+
     if (mNewPos != mOldPos)                 return true;
     if (mNewRotation != mOldRotation)       return true;
     if (mNewMirrored != mOldMirrored)       return true;
@@ -152,6 +158,8 @@ void CmdDeviceInstanceEdit::performUndo()
     mDevice.setIsMirrored(mOldMirrored); // can throw
     mDevice.setPosition(mOldPos);
     mDevice.setRotation(mOldRotation);
+    mDevice.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mDevice.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 void CmdDeviceInstanceEdit::performRedo()
@@ -159,6 +167,8 @@ void CmdDeviceInstanceEdit::performRedo()
     mDevice.setIsMirrored(mNewMirrored); // can throw
     mDevice.setPosition(mNewPos);
     mDevice.setRotation(mNewRotation);
+    mDevice.getBoard().invalidatePlanes(mOldPlaneAreaPx);
+    mDevice.getBoard().invalidatePlanes(mNewPlaneAreaPx);
 }
 
 /*****************************************************************************************
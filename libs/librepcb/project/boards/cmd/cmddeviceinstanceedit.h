@@ -87,6 +87,10 @@ class CmdDeviceInstanceEdit final : public UndoCommand
         bool mOldMirrored;
         bool mNewMirrored;
 
+        // Plane areas (see librepcb::project::Board::invalidatePlanes())
+        QRectF mOldPlaneAreaPx;
+        QRectF mNewPlaneAreaPx;
+
         friend class CmdDeviceInstanceEditAll;
 };
 
@@ -78,7 +78,7 @@ void BI_Base::addToBoard(QGraphicsItem* item) noexcept
 {
     Q_ASSERT(!mIsAddedToBoard);
     if (item) {
-        mBoard.getGraphicsScene().addItem(*item);
+        mBoard.addGraphicsItem(*item);
     }
     mIsAddedToBoard = true;
 }
@@ -87,7 +87,7 @@ void BI_Base::removeFromBoard(QGraphicsItem* item) noexcept
 {
     Q_ASSERT(mIsAddedToBoard);
     if (item) {
-        mBoard.getGraphicsScene().removeItem(*item);
+        mBoard.removeGraphicsItem(*item);
     }
     mIsAddedToBoard = false;
 }
@@ -25,6 +25,7 @@
 #include "bi_footprintpad.h"
 #include "../cmd/cmdfootprintstroketextsreset.h"
 #include "../board.h"
+#include "../boardspatialindex.h"
 #include "../../project.h"
 #include "../../circuit/circuit.h"
 #include "../../library/projectlibrary.h"
@@ -198,6 +199,7 @@ void BI_Footprint::addToBoard()
         sgl.add([text](){text->removeFromBoard();});
     }
     BI_Base::addToBoard(mGraphicsItem.data());
+    mBoard.getSpatialIndex().addItem(*this);
     sgl.dismiss();
 }
 
@@ -215,6 +217,7 @@ void BI_Footprint::removeFromBoard()
         text->removeFromBoard(); // can throw
         sgl.add([text](){text->addToBoard();});
     }
+    mBoard.getSpatialIndex().removeItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
     sgl.dismiss();
 }
@@ -299,6 +302,7 @@ void BI_Footprint::deviceInstanceMoved(const Point& pos)
 {
     mGraphicsItem->setPos(pos.toPxQPointF());
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
     foreach (BI_FootprintPad* pad, mPads) {
         pad->updatePosition();
         mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
@@ -313,6 +317,7 @@ void BI_Footprint::deviceInstanceRotated(const Angle& rot)
     Q_UNUSED(rot);
     updateGraphicsItemTransform();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
     foreach (BI_FootprintPad* pad, mPads) {
         pad->updatePosition();
         mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
@@ -324,6 +329,7 @@ void BI_Footprint::deviceInstanceMirrored(bool mirrored)
     Q_UNUSED(mirrored);
     updateGraphicsItemTransform();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
     foreach (BI_FootprintPad* pad, mPads) {
         pad->updatePosition();
         mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
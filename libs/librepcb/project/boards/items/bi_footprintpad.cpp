@@ -27,6 +27,8 @@
 #include <librepcb/library/pkg/footprintpad.h>
 #include <librepcb/library/pkg/packagepad.h>
 #include "../board.h"
+#include "../boardgeometrycache.h"
+#include "../boardspatialindex.h"
 #include "../../project.h"
 #include "../../circuit/circuit.h"
 #include "../../settings/projectsettings.h"
@@ -135,6 +137,8 @@ void BI_FootprintPad::addToBoard()
     }
     componentSignalInstanceNetSignalChanged(nullptr, getCompSigInstNetSignal());
     BI_Base::addToBoard(mGraphicsItem.data());
+    mBoard.getSpatialIndex().addItem(*this);
+    mBoard.getGeometryCache().invalidateItem(*this);
 }
 
 void BI_FootprintPad::removeFromBoard()
@@ -146,6 +150,8 @@ void BI_FootprintPad::removeFromBoard()
         mComponentSignalInstance->unregisterFootprintPad(*this); // can throw
     }
     componentSignalInstanceNetSignalChanged(getCompSigInstNetSignal(), nullptr);
+    mBoard.getSpatialIndex().removeItem(*this);
+    mBoard.getGeometryCache().invalidateItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
 }
 
@@ -183,6 +189,8 @@ void BI_FootprintPad::updatePosition() noexcept
     mGraphicsItem->setPos(mPosition.toPxQPointF());
     updateGraphicsItemTransform();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
+    mBoard.getGeometryCache().invalidateItem(*this);
     foreach (BI_NetPoint* netpoint, mRegisteredNetPoints) {
         netpoint->setPosition(mPosition);
     }
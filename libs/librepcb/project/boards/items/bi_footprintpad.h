@@ -35,6 +35,7 @@ namespace librepcb {
 
 namespace library {
 class FootprintPad;
+class PackagePad;
 class ComponentSignal;
 }
 
@@ -74,6 +75,7 @@ class BI_FootprintPad final : public BI_Base
         QString getLayerName() const noexcept;
         bool isOnLayer(const QString& layerName) const noexcept;
         const library::FootprintPad& getLibPad() const noexcept {return *mFootprintPad;}
+        const library::PackagePad& getLibPackagePad() const noexcept {return *mPackagePad;}
         ComponentSignalInstance* getComponentSignalInstance() const noexcept {return mComponentSignalInstance;}
         NetSignal* getCompSigInstNetSignal() const noexcept;
         bool isUsed() const noexcept {return (mRegisteredNetPoints.count() > 0);}
@@ -23,6 +23,7 @@
 #include <QtCore>
 #include "bi_netline.h"
 #include "../board.h"
+#include "../boardspatialindex.h"
 #include "bi_netpoint.h"
 #include "bi_netsegment.h"
 #include "../../project.h"
@@ -186,6 +187,7 @@ void BI_NetLine::setWidth(const Length& width) noexcept
     if ((width != mWidth) && (width >= 0)) {
         mWidth = width;
         mGraphicsItem->updateCacheAndRepaint();
+        mBoard.getSpatialIndex().invalidateItem(*this);
     }
 }
 
@@ -210,6 +212,7 @@ void BI_NetLine::addToBoard()
                                               &NetSignal::highlightedChanged,
                                               [this](){mGraphicsItem->update();});
     BI_Base::addToBoard(mGraphicsItem.data());
+    mBoard.getSpatialIndex().addItem(*this);
     sg.dismiss();
 }
 
@@ -227,6 +230,7 @@ void BI_NetLine::removeFromBoard()
     mEndPoint->unregisterNetLine(*this); // can throw
 
     disconnect(mHighlightChangedConnection);
+    mBoard.getSpatialIndex().removeItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
     sg.dismiss();
 }
@@ -235,6 +239,7 @@ void BI_NetLine::updateLine() noexcept
 {
     mPosition = (mStartPoint->getPosition() + mEndPoint->getPosition()) / 2;
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
 }
 
 void BI_NetLine::serialize(SExpression& root) const
@@ -29,6 +29,7 @@
 #include "bi_device.h"
 #include "bi_via.h"
 #include "../board.h"
+#include "../boardspatialindex.h"
 #include "../boardlayerstack.h"
 #include "../../project.h"
 #include "../../circuit/circuit.h"
@@ -202,6 +203,7 @@ void BI_NetPoint::setLayer(GraphicsLayer& layer)
             throw LogicError(__FILE__, __LINE__);
         }
         mLayer = &layer;
+        mBoard.getSpatialIndex().invalidateItem(*this);
     }
 }
 
@@ -234,6 +236,7 @@ void BI_NetPoint::setPadToAttach(BI_FootprintPad* pad)
     }
     mFootprintPad = pad;
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
 }
 
 void BI_NetPoint::setViaToAttach(BI_Via* via)
@@ -265,6 +268,7 @@ void BI_NetPoint::setViaToAttach(BI_Via* via)
     }
     mVia = via;
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
 }
 
 void BI_NetPoint::setPosition(const Point& position) noexcept
@@ -272,6 +276,7 @@ void BI_NetPoint::setPosition(const Point& position) noexcept
     if (position != mPosition) {
         mPosition = position;
         mGraphicsItem->setPos(mPosition.toPxQPointF());
+        mBoard.getSpatialIndex().invalidateItem(*this);
         updateLines();
         mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
     }
@@ -304,6 +309,7 @@ void BI_NetPoint::addToBoard()
                                           [this](){mGraphicsItem->update();});
     mErcMsgDeadNetPoint->setVisible(true);
     BI_Base::addToBoard(mGraphicsItem.data());
+    mBoard.getSpatialIndex().addItem(*this);
     mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
 }
 
@@ -327,6 +333,7 @@ void BI_NetPoint::removeFromBoard()
     }
     disconnect(mHighlightChangedConnection);
     mErcMsgDeadNetPoint->setVisible(false);
+    mBoard.getSpatialIndex().removeItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
     mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
 }
@@ -341,6 +348,7 @@ void BI_NetPoint::registerNetLine(BI_NetLine& netline)
     mRegisteredLines.append(&netline);
     netline.updateLine();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
     mErcMsgDeadNetPoint->setVisible(mRegisteredLines.isEmpty());
 }
 
@@ -352,6 +360,7 @@ void BI_NetPoint::unregisterNetLine(BI_NetLine& netline)
     mRegisteredLines.removeOne(&netline);
     netline.updateLine();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.getSpatialIndex().invalidateItem(*this);
     mErcMsgDeadNetPoint->setVisible(mRegisteredLines.isEmpty());
 }
 
@@ -212,7 +212,12 @@ void BI_Plane::clear() noexcept
 void BI_Plane::rebuild() noexcept
 {
     BoardPlaneFragmentsBuilder builder(*this);
-    mFragments = builder.buildFragments();
+    setFragments(builder.buildFragments());
+}
+
+void BI_Plane::setFragments(const QVector<Path>& fragments) noexcept
+{
+    mFragments = fragments;
     mGraphicsItem->updateCacheAndRepaint();
     mBoard.scheduleAirWiresRebuild(mNetSignal);
 }
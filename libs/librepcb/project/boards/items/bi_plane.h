@@ -102,6 +102,7 @@ class BI_Plane final : public BI_Base, public SerializableObject
         void removeFromBoard() override;
         void clear() noexcept;
         void rebuild() noexcept;
+        void setFragments(const QVector<Path>& fragments) noexcept;
 
         /// @copydoc librepcb::SerializableObject::serialize()
         void serialize(SExpression& root) const override;
@@ -23,6 +23,7 @@
 #include <QtCore>
 #include "bi_stroketext.h"
 #include "../board.h"
+#include "../boardspatialindex.h"
 #include "../boardlayerstack.h"
 #include "../../project.h"
 #include "./bi_footprint.h"
@@ -115,6 +116,9 @@ void BI_StrokeText::updateGraphicsItems() noexcept
     } else {
         mAnchorGraphicsItem->setLayer(nullptr);
     }
+
+    // the grab area may have changed
+    mBoard.getSpatialIndex().invalidateItem(*this);
 }
 
 void BI_StrokeText::addToBoard()
@@ -123,7 +127,8 @@ void BI_StrokeText::addToBoard()
         throw LogicError(__FILE__, __LINE__);
     }
     BI_Base::addToBoard(mGraphicsItem.data());
-    mBoard.getGraphicsScene().addItem(*mAnchorGraphicsItem);
+    mBoard.addGraphicsItem(*mAnchorGraphicsItem);
+    mBoard.getSpatialIndex().addItem(*this);
 }
 
 void BI_StrokeText::removeFromBoard()
@@ -131,8 +136,9 @@ void BI_StrokeText::removeFromBoard()
     if (!isAddedToBoard()) {
         throw LogicError(__FILE__, __LINE__);
     }
+    mBoard.getSpatialIndex().removeItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
-    mBoard.getGraphicsScene().removeItem(*mAnchorGraphicsItem);
+    mBoard.removeGraphicsItem(*mAnchorGraphicsItem);
 }
 
 void BI_StrokeText::serialize(SExpression& root) const
@@ -103,15 +103,15 @@ class BI_StrokeText final : public BI_Base, public SerializableObject,
         void strokeTextLayerNameChanged(const QString& newLayerName) noexcept override {Q_UNUSED(newLayerName); updateGraphicsItems();}
         void strokeTextTextChanged(const QString& newText) noexcept override {Q_UNUSED(newText);}
         void strokeTextPositionChanged(const Point& newPos) noexcept override {Q_UNUSED(newPos); updateGraphicsItems();}
-        void strokeTextRotationChanged(const Angle& newRot) noexcept override {Q_UNUSED(newRot);}
+        void strokeTextRotationChanged(const Angle& newRot) noexcept override {Q_UNUSED(newRot); updateGraphicsItems();}
         void strokeTextHeightChanged(const Length& newHeight) noexcept override {Q_UNUSED(newHeight);}
         void strokeTextStrokeWidthChanged(const Length& newStrokeWidth) noexcept override {Q_UNUSED(newStrokeWidth);}
         void strokeTextLetterSpacingChanged(const StrokeTextSpacing& spacing) noexcept override {Q_UNUSED(spacing);}
         void strokeTextLineSpacingChanged(const StrokeTextSpacing& spacing) noexcept override {Q_UNUSED(spacing);}
         void strokeTextAlignChanged(const Alignment& newAlign) noexcept override {Q_UNUSED(newAlign);}
-        void strokeTextMirroredChanged(bool mirrored) noexcept override {Q_UNUSED(mirrored);}
+        void strokeTextMirroredChanged(bool mirrored) noexcept override {Q_UNUSED(mirrored); updateGraphicsItems();}
         void strokeTextAutoRotateChanged(bool newAutoRotate) noexcept override {Q_UNUSED(newAutoRotate);}
-        void strokeTextPathsChanged(const QVector<Path>& paths) noexcept override {Q_UNUSED(paths);}
+        void strokeTextPathsChanged(const QVector<Path>& paths) noexcept override {Q_UNUSED(paths); updateGraphicsItems();}
 
 
     private: // Data
@@ -26,6 +26,8 @@
 #include "bi_netline.h"
 #include "bi_netsegment.h"
 #include "../board.h"
+#include "../boardgeometrycache.h"
+#include "../boardspatialindex.h"
 #include "../boardlayerstack.h"
 #include "../../project.h"
 #include "../../circuit/circuit.h"
@@ -149,6 +151,8 @@ void BI_Via::setPosition(const Point& position) noexcept
     if (position != mPosition) {
         mPosition = position;
         mGraphicsItem->setPos(mPosition.toPxQPointF());
+        mBoard.getSpatialIndex().invalidateItem(*this);
+        mBoard.getGeometryCache().invalidateItem(*this);
         updateNetPoints();
         mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
     }
@@ -159,6 +163,8 @@ void BI_Via::setShape(Shape shape) noexcept
     if (shape != mShape) {
         mShape = shape;
         mGraphicsItem->updateCacheAndRepaint();
+        mBoard.getSpatialIndex().invalidateItem(*this);
+        mBoard.getGeometryCache().invalidateItem(*this);
     }
 }
 
@@ -167,6 +173,8 @@ void BI_Via::setSize(const Length& size) noexcept
     if (size != mSize) {
         mSize = size;
         mGraphicsItem->updateCacheAndRepaint();
+        mBoard.getSpatialIndex().invalidateItem(*this);
+        mBoard.getGeometryCache().invalidateItem(*this);
     }
 }
 
@@ -191,6 +199,8 @@ void BI_Via::addToBoard()
                                           &NetSignal::highlightedChanged,
                                           [this](){mGraphicsItem->update();});
     BI_Base::addToBoard(mGraphicsItem.data());
+    mBoard.getSpatialIndex().addItem(*this);
+    mBoard.getGeometryCache().invalidateItem(*this);
     mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
 }
 
@@ -200,6 +210,8 @@ void BI_Via::removeFromBoard()
         throw LogicError(__FILE__, __LINE__);
     }
     disconnect(mHighlightChangedConnection);
+    mBoard.getSpatialIndex().removeItem(*this);
+    mBoard.getGeometryCache().invalidateItem(*this);
     BI_Base::removeFromBoard(mGraphicsItem.data());
     mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
 }
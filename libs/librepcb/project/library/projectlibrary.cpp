@@ -21,10 +21,12 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <QtConcurrent/QtConcurrent>
 #include <librepcb/common/exceptions.h>
 #include "projectlibrary.h"
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/tracer.h>
 #include "../project.h"
 #include <librepcb/library/sym/symbol.h>
 #include <librepcb/library/pkg/package.h>
@@ -59,10 +61,22 @@ ProjectLibrary::ProjectLibrary(Project& project, bool restore, bool readOnly) :
     try
     {
         // Load all library elements
-        loadElements<Symbol>    (mLibraryPath.getPathTo("sym"),    "symbols",      mSymbols);
-        loadElements<Package>   (mLibraryPath.getPathTo("pkg"),    "packages",     mPackages);
-        loadElements<Component> (mLibraryPath.getPathTo("cmp"),    "components",   mComponents);
-        loadElements<Device>    (mLibraryPath.getPathTo("dev"),    "devices",      mDevices);
+        // load all library elements in parallel
+        TraceSpan span("ProjectLibrary::loadElements");
+        QList<QFuture<LoadedElement>> symbols    = startLoadingElements<Symbol>   (mLibraryPath.getPathTo("sym"));
+        QList<QFuture<LoadedElement>> packages   = startLoadingElements<Package>  (mLibraryPath.getPathTo("pkg"));
+        QList<QFuture<LoadedElement>> components = startLoadingElements<Component>(mLibraryPath.getPathTo("cmp"));
+        QList<QFuture<LoadedElement>> devices    = startLoadingElements<Device>   (mLibraryPath.getPathTo("dev"));
+
+        // always wait for all elements to avoid leaking any of them in case of an error
+        QList<QSharedPointer<Exception>> errors;
+        errors.append(finishLoadingElements(symbols,    "symbols",      mSymbols));
+        errors.append(finishLoadingElements(packages,   "packages",     mPackages));
+        errors.append(finishLoadingElements(components, "components",   mComponents));
+        errors.append(finishLoadingElements(devices,    "devices",      mDevices));
+        foreach (const QSharedPointer<Exception>& error, errors) {
+            if (error) error->raise();
+        }
     }
     catch (Exception &e)
     {
@@ -202,9 +216,11 @@ bool ProjectLibrary::save(bool toOriginal, QStringList& errors) noexcept
  ****************************************************************************************/
 
 template <typename ElementType>
-void ProjectLibrary::loadElements(const FilePath& directory, const QString& type,
-                                  QHash<Uuid, ElementType*>& elementList)
+QList<QFuture<ProjectLibrary::LoadedElement>> ProjectLibrary::startLoadingElements(
+        const FilePath& directory) noexcept
 {
+    QList<QFuture<LoadedElement>> futures;
+    QThread* thread = QThread::currentThread();
     QDir dir(directory.toStr());
 
     // search all subdirectories which have a valid UUID as directory name
@@ -225,19 +241,52 @@ void ProjectLibrary::loadElements(const FilePath& directory, const QString& type
             continue;
         }
 
-        // load the library element --> an exception will be thrown on error
-        ElementType* element = new ElementType(subdirPath, false);
+        // load the library element in the thread pool, exceptions are passed as result
+        // (instead of being rethrown by QFuture::result()) because all futures have to
+        // be finished anyway to not leak the successfully loaded elements
+        futures.append(QtConcurrent::run([subdirPath, thread]() {
+            TraceSpan span("ProjectLibrary::loadElement", subdirPath);
+            LoadedElement result{subdirPath, nullptr, QSharedPointer<Exception>()};
+            try {
+                ElementType* element = new ElementType(subdirPath, false); // can throw
+                element->moveToThread(thread); // the element is used in the main thread
+                result.element = element;
+            } catch (const Exception& e) {
+                result.error.reset(e.clone());
+            }
+            return result;
+        }));
+    }
+    return futures;
+}
 
-        if (elementList.contains(element->getUuid())) {
-            throw RuntimeError(__FILE__, __LINE__,
-                QString(tr("There are multiple library elements with the same "
-                "UUID in the directory \"%1\"")).arg(subdirPath.toNative()));
+template <typename ElementType>
+QSharedPointer<Exception> ProjectLibrary::finishLoadingElements(
+        const QList<QFuture<LoadedElement>>& futures, const QString& type,
+        QHash<Uuid, ElementType*>& elementList) noexcept
+{
+    QSharedPointer<Exception> error;
+    foreach (const QFuture<LoadedElement>& future, futures) {
+        LoadedElement result = future.result(); // blocks until the element is loaded
+        ElementType* element = static_cast<ElementType*>(result.element);
+        if (!element) {
+            if (!error) error = result.error;
+        } else if (elementList.contains(element->getUuid())) {
+            if (!error) {
+                error.reset(new RuntimeError(__FILE__, __LINE__,
+                    QString(tr("There are multiple library elements with the same "
+                    "UUID in the directory \"%1\"")).arg(result.directory.toNative())));
+            }
+            delete element;
+        } else {
+            elementList.insert(element->getUuid(), element);
         }
-
-        elementList.insert(element->getUuid(), element);
     }
 
-    qDebug() << "successfully loaded" << elementList.count() << qPrintable(type);
+    if (!error) {
+        qDebug() << "successfully loaded" << elementList.count() << qPrintable(type);
+    }
+    return error;
 }
 
 template <typename ElementType>
@@ -301,11 +350,10 @@ bool ProjectLibrary::saveElements(bool toOriginal, QStringList& errors, const Fi
                 element->moveIntoParentDirectory(parentDir);
             }
             if (toOriginal && (!mSavedLibraryElements.contains(element))) {
-                // TODO:
-                // - first save to temporary files! Not yet supported by LibraryBaseElement :(
-                // - only save if needed (to improve performance)
-                //  - either if file format was upgraded
-                //  - or if library element was modified (not yet supported anyway)
+                // TODO: first save to temporary files! Not yet supported by
+                // LibraryBaseElement :(
+                // Note: files are only overwritten if their content has changed (e.g.
+                // because the file format was upgraded)
                 element->save(); // can throw
                 mSavedLibraryElements.insert(element);
             }
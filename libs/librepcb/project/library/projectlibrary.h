@@ -101,10 +101,20 @@ class ProjectLibrary final : public QObject
         ProjectLibrary(const ProjectLibrary& other);
         ProjectLibrary& operator=(const ProjectLibrary& rhs);
 
+        // Private Types
+        struct LoadedElement {
+            FilePath directory;
+            library::LibraryBaseElement* element; ///< nullptr if loading failed
+            QSharedPointer<Exception> error;      ///< the reason if loading failed
+        };
+
         // Private Methods
         template <typename ElementType>
-        void loadElements(const FilePath& directory, const QString& type,
-                          QHash<Uuid, ElementType*>& elementList);
+        QList<QFuture<LoadedElement>> startLoadingElements(const FilePath& directory) noexcept;
+        template <typename ElementType>
+        QSharedPointer<Exception> finishLoadingElements(
+            const QList<QFuture<LoadedElement>>& futures, const QString& type,
+            QHash<Uuid, ElementType*>& elementList) noexcept;
         template <typename ElementType>
         void addElement(ElementType& element,
                         QHash<Uuid, ElementType*>& elementList,
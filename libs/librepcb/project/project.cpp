@@ -21,15 +21,19 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <QtConcurrent/QtConcurrent>
 #include <QPrinter>
 #include <librepcb/common/exceptions.h>
+#include <librepcb/common/fileio/asyncfilewriter.h>
 #include <librepcb/common/fileio/directorylock.h>
+#include <librepcb/common/fileio/sexpressioncache.h>
 #include <librepcb/common/fileio/smarttextfile.h>
 #include <librepcb/common/fileio/smartsexprfile.h>
 #include <librepcb/common/fileio/smartversionfile.h>
 #include <librepcb/common/fileio/sexpression.h>
 #include <librepcb/common/fileio/fileutils.h>
 #include <librepcb/common/font/strokefontpool.h>
+#include <librepcb/common/tracer.h>
 #include "project.h"
 #include "library/projectlibrary.h"
 #include "circuit/circuit.h"
@@ -56,6 +60,7 @@ Project::Project(const FilePath& filepath, bool create, bool readOnly) :
     mFilepath(filepath), mLock(filepath.getParentDir()), mIsRestored(false),
     mIsReadOnly(readOnly)
 {
+    TraceSpan span("Project::Project", filepath);
     qDebug() << (create ? "create project:" : "open project:") << filepath.toNative();
 
     // Check if the file extension is correct
@@ -190,6 +195,42 @@ Project::Project(const FilePath& filepath, bool create, bool readOnly) :
         }
         mStrokeFontPool.reset(new StrokeFontPool(fontobeneDir));
 
+        // Start reading and parsing all schematics and boards in the thread pool while
+        // the library and the circuit are loaded. The objects are created later in the
+        // main thread since they depend on the circuit and contain graphics items.
+        QList<FilePath> schematicFilePaths, boardFilePaths;
+        QList<QFuture<SExpression>> schematicFiles, boardFiles;
+        bool restore = mIsRestored;
+        // binary cache of the parsed schematics and boards (in the user directory which
+        // is not under version control), not used for read-only projects
+        SExpressionCache cache(mPath.getPathTo("user/cache"), mPath);
+        bool useCache = !mIsReadOnly;
+        FilePath schematicsFilepath = mPath.getPathTo("core/schematics.lp");
+        FilePath boardsFilepath = mPath.getPathTo("core/boards.lp");
+        if (create) {
+            mSchematicsFile.reset(SmartSExprFile::create(schematicsFilepath));
+            mBoardsFile.reset(SmartSExprFile::create(boardsFilepath));
+        } else {
+            mSchematicsFile.reset(new SmartSExprFile(schematicsFilepath, mIsRestored, mIsReadOnly));
+            SExpression schRoot = mSchematicsFile->parseFileAndBuildDomTree();
+            foreach (const SExpression& node, schRoot.getChildren("schematic")) {
+                FilePath fp = FilePath::fromRelative(mPath, node.getValueOfFirstChild<QString>(true));
+                schematicFilePaths.append(fp);
+                schematicFiles.append(QtConcurrent::run([fp, restore, cache, useCache]() {
+                    return parseFile(fp, restore, useCache ? &cache : nullptr);
+                }));
+            }
+            mBoardsFile.reset(new SmartSExprFile(boardsFilepath, mIsRestored, mIsReadOnly));
+            SExpression brdRoot = mBoardsFile->parseFileAndBuildDomTree();
+            foreach (const SExpression& node, brdRoot.getChildren("board")) {
+                FilePath fp = FilePath::fromRelative(mPath, node.getValueOfFirstChild<QString>(true));
+                boardFilePaths.append(fp);
+                boardFiles.append(QtConcurrent::run([fp, restore, cache, useCache]() {
+                    return parseFile(fp, restore, useCache ? &cache : nullptr);
+                }));
+            }
+        }
+
         // Create all needed objects
         mProjectMetadata.reset(new ProjectMetadata(*this, mIsRestored, mIsReadOnly, create));
         connect(mProjectMetadata.data(), &ProjectMetadata::attributesChanged,
@@ -203,32 +244,26 @@ Project::Project(const FilePath& filepath, bool create, bool readOnly) :
         mSchematicLayerProvider.reset(new SchematicLayerProvider(*this));
 
         // Load all schematics
-        FilePath schematicsFilepath = mPath.getPathTo("core/schematics.lp");
-        if (create) {
-            mSchematicsFile.reset(SmartSExprFile::create(schematicsFilepath));
-        } else {
-            mSchematicsFile.reset(new SmartSExprFile(schematicsFilepath, mIsRestored, mIsReadOnly));
-            SExpression schRoot = mSchematicsFile->parseFileAndBuildDomTree();
-            foreach (const SExpression& node, schRoot.getChildren("schematic")) {
-                FilePath fp = FilePath::fromRelative(mPath, node.getValueOfFirstChild<QString>(true));
-                Schematic* schematic = new Schematic(*this, fp, mIsRestored, mIsReadOnly);
-                addSchematic(*schematic);
-            }
+        for (int i = 0; i < schematicFilePaths.count(); ++i) {
+            // blocks until parsed, rethrows the exception if parsing failed
+            SExpression root = schematicFiles.at(i).result();
+            Schematic* schematic = new Schematic(*this, schematicFilePaths.at(i),
+                                                 mIsRestored, mIsReadOnly, &root);
+            addSchematic(*schematic);
+        }
+        if (!create) {
             qDebug() << mSchematics.count() << "schematics successfully loaded!";
         }
 
         // Load all boards
-        FilePath boardsFilepath = mPath.getPathTo("core/boards.lp");
-        if (create) {
-            mBoardsFile.reset(SmartSExprFile::create(boardsFilepath));
-        } else {
-            mBoardsFile.reset(new SmartSExprFile(boardsFilepath, mIsRestored, mIsReadOnly));
-            SExpression brdRoot = mBoardsFile->parseFileAndBuildDomTree();
-            foreach (const SExpression& node, brdRoot.getChildren("board")) {
-                FilePath fp = FilePath::fromRelative(mPath, node.getValueOfFirstChild<QString>(true));
-                Board* board = new Board(*this, fp, mIsRestored, mIsReadOnly);
-                addBoard(*board);
-            }
+        for (int i = 0; i < boardFilePaths.count(); ++i) {
+            // blocks until parsed, rethrows the exception if parsing failed
+            SExpression root = boardFiles.at(i).result();
+            Board* board = new Board(*this, boardFilePaths.at(i), mIsRestored, mIsReadOnly,
+                                     &root);
+            addBoard(*board);
+        }
+        if (!create) {
             qDebug() << mBoards.count() << "boards successfully loaded!";
         }
 
@@ -517,6 +552,19 @@ void Project::save(bool toOriginal)
     Q_ASSERT(errors.isEmpty());
 }
 
+void Project::autosave(AsyncFileWriter& writer)
+{
+    QStringList errors;
+
+    if (!save(false, errors, &writer))
+    {
+        QString msg = QString(tr("The project could not be saved!\n\nError Message:\n%1",
+            "variable count of error messages", errors.count())).arg(errors.join("\n"));
+        throw RuntimeError(__FILE__, __LINE__, msg);
+    }
+    Q_ASSERT(errors.isEmpty());
+}
+
 /*****************************************************************************************
  *  Inherited from AttributeProvider
  ****************************************************************************************/
@@ -600,7 +648,7 @@ Version Project::getProjectFileFormatVersion(const FilePath& dir)
  *  Private Methods
  ****************************************************************************************/
 
-bool Project::save(bool toOriginal, QStringList& errors) noexcept
+bool Project::save(bool toOriginal, QStringList& errors, AsyncFileWriter* writer) noexcept
 {
     bool success = true;
 
@@ -665,26 +713,26 @@ bool Project::save(bool toOriginal, QStringList& errors) noexcept
     // Save all removed schematics (*.lp files)
     foreach (Schematic* schematic, mRemovedSchematics)
     {
-        if (!schematic->save(toOriginal, errors))
+        if (!schematic->save(toOriginal, errors, writer))
             success = false;
     }
     // Save all added schematics (*.lp files)
     foreach (Schematic* schematic, mSchematics)
     {
-        if (!schematic->save(toOriginal, errors))
+        if (!schematic->save(toOriginal, errors, writer))
             success = false;
     }
 
     // Save all removed boards (*.lp files)
     foreach (Board* board, mRemovedBoards)
     {
-        if (!board->save(toOriginal, errors))
+        if (!board->save(toOriginal, errors, writer))
             success = false;
     }
     // Save all added boards (*.lp files)
     foreach (Board* board, mBoards)
     {
-        if (!board->save(toOriginal, errors))
+        if (!board->save(toOriginal, errors, writer))
             success = false;
     }
 
@@ -700,6 +748,11 @@ bool Project::save(bool toOriginal, QStringList& errors) noexcept
     if (!mErcMsgList->save(toOriginal, errors))
         success = false;
 
+    // start writing schematics and boards in the background
+    if (writer) {
+        writer->start();
+    }
+
     // if the project was restored from a backup, reset the mIsRestored flag as the current
     // state of the project is no longer a restored backup but a properly saved project
     if (mIsRestored && success && toOriginal)
@@ -740,6 +793,13 @@ void Project::printSchematicPages(QPrinter& printer, QList<int>& pages)
     }
 }
 
+SExpression Project::parseFile(const FilePath& filepath, bool restore,
+                               const SExpressionCache* cache)
+{
+    SmartSExprFile file(filepath, restore, true); // can throw
+    return file.parseFileAndBuildDomTree(cache); // can throw
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
@@ -40,6 +40,8 @@ namespace librepcb {
 
 class SmartTextFile;
 class SmartSExprFile;
+class AsyncFileWriter;
+class SExpressionCache;
 class SmartVersionFile;
 class StrokeFontPool;
 
@@ -378,6 +380,19 @@ class Project final : public QObject, public AttributeProvider
          */
         void save(bool toOriginal);
 
+        /**
+         * @brief Save the whole project to temporary files without blocking (autosave)
+         *
+         * All files are serialized immediately, but the (big) schematic and board files
+         * are formatted and written by the passed writer in a worker thread. Errors while
+         * writing these files are reported by librepcb::AsyncFileWriter::finished().
+         *
+         * @param writer    The writer to use (must not be busy with another project)
+         *
+         * @throw Exception if saving any other file failed
+         */
+        void autosave(AsyncFileWriter& writer);
+
 
         // Inherited from AttributeProvider
         /// @copydoc librepcb::AttributeProvider::getUserDefinedAttributeValue()
@@ -457,10 +472,13 @@ class Project final : public QObject, public AttributeProvider
          *
          * @param toOriginal    True: save to original files; False: save to temporary files
          * @param errors        All errors will be added to this string list (translated)
+         * @param writer        If not nullptr, schematics and boards are written by this
+         *                      writer (see #autosave())
          *
          * @return True on success (then the error list should be empty), false otherwise
          */
-        bool save(bool toOriginal, QStringList& errors) noexcept;
+        bool save(bool toOriginal, QStringList& errors,
+                  AsyncFileWriter* writer = nullptr) noexcept;
 
         /**
          * @brief Print some schematics to a QPrinter (printer or file)
@@ -472,6 +490,21 @@ class Project final : public QObject, public AttributeProvider
          */
         void printSchematicPages(QPrinter& printer, QList<int>& pages);
 
+        /**
+         * @brief Read and parse a schematic or board file (used in worker threads)
+         *
+         * @param filepath  The file to parse
+         * @param restore   See librepcb::SmartFile::SmartFile()
+         * @param cache     The cache to use (nullptr to always parse the text file)
+         *
+         * @return The parsed DOM tree
+         *
+         * @throw Exception     If the file could not be read or parsed (QtConcurrent
+         *                      forwards it to the caller of QFuture::result())
+         */
+        static SExpression parseFile(const FilePath& filepath, bool restore,
+                                     const SExpressionCache* cache);
+
 
         // Project File (*.lpp)
         FilePath mPath; ///< the path to the project directory
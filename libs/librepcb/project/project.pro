@@ -23,11 +23,15 @@ INCLUDEPATH += \
 SOURCES += \
     boards/board.cpp \
     boards/boardairwiresbuilder.cpp \
+    boards/boarddesignrulecheck.cpp \
     boards/boardfabricationoutputsettings.cpp \
+    boards/boardgeometrycache.cpp \
     boards/boardgerberexport.cpp \
     boards/boardlayerstack.cpp \
+    boards/boardlocaldesignrulecheck.cpp \
     boards/boardplanefragmentsbuilder.cpp \
     boards/boardselectionquery.cpp \
+    boards/boardspatialindex.cpp \
     boards/boardusersettings.cpp \
     boards/cmd/cmdboardadd.cpp \
     boards/cmd/cmdboarddesignrulesmodify.cpp \
@@ -136,11 +140,15 @@ SOURCES += \
 HEADERS += \
     boards/board.h \
     boards/boardairwiresbuilder.h \
+    boards/boarddesignrulecheck.h \
     boards/boardfabricationoutputsettings.h \
+    boards/boardgeometrycache.h \
     boards/boardgerberexport.h \
     boards/boardlayerstack.h \
+    boards/boardlocaldesignrulecheck.h \
     boards/boardplanefragmentsbuilder.h \
     boards/boardselectionquery.h \
+    boards/boardspatialindex.h \
     boards/boardusersettings.h \
     boards/cmd/cmdboardadd.h \
     boards/cmd/cmdboarddesignrulesmodify.h \
@@ -24,6 +24,7 @@
 #include "schematic.h"
 #include <librepcb/common/fileio/smartsexprfile.h>
 #include <librepcb/common/fileio/sexpression.h>
+#include <librepcb/common/undocommand.h>
 #include <librepcb/common/scopeguardlist.h>
 #include "../project.h"
 #include <librepcb/library/sym/symbolpin.h>
@@ -50,9 +51,10 @@ namespace project {
  ****************************************************************************************/
 
 Schematic::Schematic(Project& project, const FilePath& filepath, bool restore,
-                     bool readOnly, bool create, const QString& newName):
+                     bool readOnly, bool create, const QString& newName,
+                     const SExpression* preparsedRoot) :
     QObject(&project), AttributeProvider(), mProject(project), mFilePath(filepath),
-    mIsAddedToProject(false)
+    mSavedDocumentRevision(0), mIsAddedToProject(false)
 {
     try
     {
@@ -73,7 +75,8 @@ Schematic::Schematic(Project& project, const FilePath& filepath, bool restore,
         else
         {
             mFile.reset(new SmartSExprFile(mFilePath, restore, readOnly));
-            SExpression root = mFile->parseFileAndBuildDomTree();
+            SExpression root = preparsedRoot ? *preparsedRoot
+                                             : mFile->parseFileAndBuildDomTree();
 
             // the schematic seems to be ready to open, so we will create all needed objects
 
@@ -237,6 +240,7 @@ QList<SI_SymbolPin*> Schematic::getPinsAtScenePos(const Point& pos) const noexce
 void Schematic::setGridProperties(const GridProperties& grid) noexcept
 {
     *mGridProperties = grid;
+    mSavedDocumentRevision = 0; // not modified by an undo command
 }
 
 /*****************************************************************************************
@@ -366,7 +370,7 @@ void Schematic::removeFromProject()
     sgl.dismiss();
 }
 
-bool Schematic::save(bool toOriginal, QStringList& errors) noexcept
+bool Schematic::save(bool toOriginal, QStringList& errors, AsyncFileWriter* writer) noexcept
 {
     bool success = true;
 
@@ -375,8 +379,18 @@ bool Schematic::save(bool toOriginal, QStringList& errors) noexcept
     {
         if (mIsAddedToProject)
         {
-            SExpression doc(serializeToDomElement("librepcb_schematic"));
-            mFile->save(doc, toOriginal);
+            // Serializing is only needed if the schematic might have been modified by an
+            // undo command (or a setter) since the last time it was saved.
+            quint64 revision = UndoCommand::getModificationCounter();
+            if (mSavedDocumentRevision != revision) {
+                mSavedDocument = serializeToDomElement("librepcb_schematic"); // can throw
+                mSavedDocumentRevision = revision;
+            }
+            if (writer) {
+                mFile->save(mSavedDocument, toOriginal, *writer); // in a worker thread
+            } else {
+                mFile->save(mSavedDocument, toOriginal);
+            }
         }
         else
         {
@@ -42,6 +42,8 @@ class GridProperties;
 class GraphicsView;
 class GraphicsScene;
 class SmartSExprFile;
+class AsyncFileWriter;
+class SExpression;
 
 namespace project {
 
@@ -107,8 +109,9 @@ class Schematic final : public QObject, public AttributeProvider,
         // Constructors / Destructor
         Schematic() = delete;
         Schematic(const Schematic& other) = delete;
-        Schematic(Project& project, const FilePath& filepath, bool restore, bool readOnly) :
-            Schematic(project, filepath, restore, readOnly, false, QString()) {}
+        Schematic(Project& project, const FilePath& filepath, bool restore, bool readOnly,
+                  const SExpression* root = nullptr) :
+            Schematic(project, filepath, restore, readOnly, false, QString(), root) {}
         ~Schematic() noexcept;
 
         // Getters: General
@@ -144,7 +147,8 @@ class Schematic final : public QObject, public AttributeProvider,
         // General Methods
         void addToProject();
         void removeFromProject();
-        bool save(bool toOriginal, QStringList& errors) noexcept;
+        bool save(bool toOriginal, QStringList& errors,
+                  AsyncFileWriter* writer = nullptr) noexcept;
         void showInView(GraphicsView& view) noexcept;
         void saveViewSceneRect(const QRectF& rect) noexcept {mViewRect = rect;}
         const QRectF& restoreViewSceneRect() const noexcept {return mViewRect;}
@@ -179,7 +183,8 @@ class Schematic final : public QObject, public AttributeProvider,
     private:
 
         Schematic(Project& project, const FilePath& filepath, bool restore,
-                  bool readOnly, bool create, const QString& newName);
+                  bool readOnly, bool create, const QString& newName,
+                  const SExpression* preparsedRoot = nullptr);
         void updateIcon() noexcept;
         bool checkAttributesValidity() const noexcept;
 
@@ -191,6 +196,8 @@ class Schematic final : public QObject, public AttributeProvider,
         Project& mProject; ///< A reference to the Project object (from the ctor)
         FilePath mFilePath; ///< the filepath of the schematic *.lp file (from the ctor)
         QScopedPointer<SmartSExprFile> mFile;
+        SExpression mSavedDocument; ///< the DOM tree last written by #save()
+        quint64 mSavedDocumentRevision; ///< see #save() (0 if #mSavedDocument is invalid)
         bool mIsAddedToProject;
 
         QScopedPointer<GraphicsScene> mGraphicsScene;
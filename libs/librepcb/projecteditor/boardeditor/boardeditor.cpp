@@ -234,7 +234,9 @@ bool BoardEditor::setActiveBoardIndex(int index) noexcept
     Board* board = getActiveBoard();
     if (board)
     {
-        // stop airwire rebuild on every project modification (for performance reasons)
+        // stop plane and airwire rebuild on every project modification (for performance reasons)
+        disconnect(&mProjectEditor.getUndoStack(), &UndoStack::stateModified,
+                   board, &Board::rebuildDirtyPlanes);
         disconnect(&mProjectEditor.getUndoStack(), &UndoStack::stateModified,
                    board, &Board::triggerAirWiresRebuild);
         // save current view scene rect
@@ -250,8 +252,11 @@ bool BoardEditor::setActiveBoardIndex(int index) noexcept
         board->showInView(*mGraphicsView);
         mGraphicsView->setVisibleSceneRect(board->restoreViewSceneRect());
         mGraphicsView->setGridProperties(board->getGridProperties());
-        // force airwire rebuild immediately and on every project modification
+        // force airwire rebuild immediately and on every project modification, planes
+        // are rebuilt asynchronously on every project modification
         board->triggerAirWiresRebuild();
+        connect(&mProjectEditor.getUndoStack(), &UndoStack::stateModified,
+                board, &Board::rebuildDirtyPlanes);
         connect(&mProjectEditor.getUndoStack(), &UndoStack::stateModified,
                 board, &Board::triggerAirWiresRebuild);
         // check QAction
@@ -486,6 +491,22 @@ void BoardEditor::on_actionModifyDesignRules_triggered()
     }
 }
 
+void BoardEditor::on_actionRunDesignRuleCheck_triggered()
+{
+    Board* board = getActiveBoard();
+    if (!board) return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    int violations = board->runDesignRuleCheck();
+    QApplication::restoreOverrideCursor();
+    if (violations > 0) {
+        mErcMsgDock->show();
+        mErcMsgDock->raise();
+    }
+    mUi->statusbar->showMessage(tr("Design rule check finished: %1 violation(s) found")
+                                .arg(violations), 5000);
+}
+
 void BoardEditor::on_actionRebuildPlanes_triggered()
 {
     Board* board = getActiveBoard();
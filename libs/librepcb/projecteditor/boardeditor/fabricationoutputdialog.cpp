@@ -161,7 +161,7 @@ void FabricationOutputDialog::on_btnGenerate_clicked()
         s.setEnableSolderPasteTop(mUi->cbxSolderPasteTop->isChecked());
         s.setEnableSolderPasteBot(mUi->cbxSolderPasteBot->isChecked());
         if (s != mBoard.getFabricationOutputSettings()) {
-            mBoard.getFabricationOutputSettings() = s; // TODO: use undo command
+            mBoard.setFabricationOutputSettings(s); // TODO: use undo command
         }
 
         // generate files
@@ -33,6 +33,7 @@
 #include <librepcb/project/boards/items/bi_netpoint.h>
 #include <librepcb/project/boards/cmd/cmdboardnetsegmentaddelements.h>
 #include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardlocaldesignrulecheck.h>
 #include <librepcb/library/pkg/footprintpad.h>
 #include <librepcb/project/boards/items/bi_footprint.h>
 #include <librepcb/project/boards/items/bi_footprintpad.h>
@@ -364,6 +365,9 @@ bool BES_DrawTrace::startPositioning(Board& board, const Point& pos,
         mPositioningNetLine1 = l1;
         mPositioningNetPoint2 = p3;
         mPositioningNetLine2 = l2;
+        if (!mDesignRuleCheck) {
+            mDesignRuleCheck.reset(new BoardLocalDesignRuleCheck(board));
+        }
 
         // properly place the new netpoints/netlines according the current wire mode
         updateNetpointPositions(pos);
@@ -455,6 +459,8 @@ bool BES_DrawTrace::abortPositioning(bool showErrMsgBox) noexcept
         mPositioningNetLine2 = nullptr;
         mPositioningNetPoint1 = nullptr;
         mPositioningNetPoint2 = nullptr;
+        mDesignRuleCheck.reset();
+        mEditorUi.statusbar->clearMessage();
         mUndoStack.abortCmdGroup(); // can throw
         return true;
     }
@@ -473,6 +479,23 @@ void BES_DrawTrace::updateNetpointPositions(const Point& cursorPos) noexcept
 
     // Force updating airwires immediately as they are important for creating traces.
     mPositioningNetPoint2->getBoard().triggerAirWiresRebuild();
+
+    updateDesignRuleViolations();
+}
+
+void BES_DrawTrace::updateDesignRuleViolations() noexcept
+{
+    // Only the lines under construction are checked (against nearby copper), so this is
+    // fast enough to be done on every mouse move.
+    if ((!mDesignRuleCheck) || (!mPositioningNetLine1) || (!mPositioningNetLine2)) return;
+    QStringList violations = mDesignRuleCheck->checkNetLine(*mPositioningNetLine1)
+                           + mDesignRuleCheck->checkNetLine(*mPositioningNetLine2);
+    violations.removeDuplicates();
+    if (violations.isEmpty()) {
+        mEditorUi.statusbar->clearMessage();
+    } else {
+        mEditorUi.statusbar->showMessage(violations.join("; "));
+    }
 }
 
 void BES_DrawTrace::layerComboBoxIndexChanged(int index) noexcept
@@ -487,6 +510,7 @@ void BES_DrawTrace::wireWidthComboBoxTextChanged(const QString& width) noexcept
     if (mSubState != SubState::SubState_PositioningNetPoint) return;
     if (mPositioningNetLine1) mPositioningNetLine1->setWidth(mCurrentWidth);
     if (mPositioningNetLine2) mPositioningNetLine2->setWidth(mCurrentWidth);
+    updateDesignRuleViolations();
 }
 
 void BES_DrawTrace::updateWireModeActionsCheckedState() noexcept
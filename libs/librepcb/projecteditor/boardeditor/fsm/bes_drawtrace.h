@@ -35,6 +35,7 @@ namespace project {
 
 class BI_NetPoint;
 class BI_NetLine;
+class BoardLocalDesignRuleCheck;
 
 namespace editor {
 
@@ -98,6 +99,7 @@ class BES_DrawTrace final : public BES_Base
         bool addNextNetPoint(Board& board, const Point& pos) noexcept;
         bool abortPositioning(bool showErrMsgBox) noexcept;
         void updateNetpointPositions(const Point& cursorPos) noexcept;
+        void updateDesignRuleViolations() noexcept;
         void layerComboBoxIndexChanged(int index) noexcept;
         void wireWidthComboBoxTextChanged(const QString& width) noexcept;
         void updateWireModeActionsCheckedState() noexcept;
@@ -114,6 +116,7 @@ class BES_DrawTrace final : public BES_Base
         BI_NetPoint* mPositioningNetPoint1; ///< the first netpoint to place
         BI_NetLine* mPositioningNetLine2; ///< line between p1 and p2
         BI_NetPoint* mPositioningNetPoint2; ///< the second netpoint to place
+        QScopedPointer<BoardLocalDesignRuleCheck> mDesignRuleCheck; ///< checks the new lines
 
         // Widgets for the command toolbar
         QHash<WireMode, QAction*> mWireModeActions;
@@ -63,7 +63,8 @@ AddComponentDialog::AddComponentDialog(workspace::Workspace& workspace, Project&
                                        QWidget* parent) :
     QDialog(parent), mWorkspace(workspace), mProject(project),
     mUi(new Ui::AddComponentDialog), mComponentPreviewScene(nullptr),
-    mDevicePreviewScene(nullptr), mCategoryTreeModel(nullptr),
+    mDevicePreviewScene(nullptr), mCategoryTreeModel(nullptr), mSearchTimer(nullptr),
+    mCurrentSearchId(-1),
     mSelectedComponent(nullptr), mSelectedSymbVar(nullptr), mSelectedDevice(nullptr),
     mSelectedPackage(nullptr), mPreviewFootprintGraphicsItem(nullptr)
 {
@@ -79,6 +80,17 @@ AddComponentDialog::AddComponentDialog(workspace::Workspace& workspace, Project&
     mUi->viewDevice->hide();
     connect(mUi->edtSearch, &QLineEdit::textChanged,
             this, &AddComponentDialog::searchEditTextChanged);
+    mSearch.reset(new workspace::WorkspaceLibrarySearch(mWorkspace));
+    connect(mSearch.data(), &workspace::WorkspaceLibrarySearch::resultsAvailable,
+            this, &AddComponentDialog::searchResultsAvailable, Qt::QueuedConnection);
+    connect(mSearch.data(), &workspace::WorkspaceLibrarySearch::searchFailed,
+            this, &AddComponentDialog::searchFailed, Qt::QueuedConnection);
+    mSearchTimer = new QTimer(this);
+    mSearchTimer->setSingleShot(true);
+    mSearchTimer->setInterval(150);
+    connect(mSearchTimer, &QTimer::timeout, this, [this](){
+        searchComponents(mUi->edtSearch->text().trimmed());
+    });
     connect(mUi->treeComponents, &QTreeWidget::currentItemChanged,
             this, &AddComponentDialog::treeComponents_currentItemChanged);
     connect(mUi->treeComponents, &QTreeWidget::itemDoubleClicked,
@@ -110,6 +122,7 @@ AddComponentDialog::~AddComponentDialog() noexcept
     delete mSelectedDevice;                     mSelectedDevice = nullptr;
     mSelectedSymbVar = nullptr;
     delete mSelectedComponent;                  mSelectedComponent = nullptr;
+    mSearch.reset();
     delete mCategoryTreeModel;                  mCategoryTreeModel = nullptr;
     delete mDevicePreviewScene;                 mDevicePreviewScene = nullptr;
     delete mComponentPreviewScene;              mComponentPreviewScene = nullptr;
@@ -155,13 +168,48 @@ void AddComponentDialog::searchEditTextChanged(const QString& text) noexcept
         if (text.trimmed().isEmpty() && catIndex.isValid()) {
             setSelectedCategory(Uuid(catIndex.data(Qt::UserRole).toString()));
         } else {
-            searchComponents(text.trimmed());
+            mSearchTimer->start(); // restart if already running
         }
     } catch (const Exception& e) {
         QMessageBox::critical(this, tr("Error"), e.getMsg());
     }
 }
 
+void AddComponentDialog::searchResultsAvailable(int searchId,
+    QList<workspace::WorkspaceLibrarySearch::ComponentMatch> page) noexcept
+{
+    if (searchId != mCurrentSearchId) {
+        return; // results of a superseded search
+    }
+    foreach (const workspace::WorkspaceLibrarySearch::ComponentMatch& cmp, page) {
+        // component
+        QTreeWidgetItem* cmpItem = new QTreeWidgetItem(mUi->treeComponents);
+        cmpItem->setText(0, cmp.name);
+        cmpItem->setData(0, Qt::UserRole, cmp.filepath.toStr());
+        // devices
+        foreach (const workspace::WorkspaceLibrarySearch::DeviceMatch& dev, cmp.devices) {
+            QTreeWidgetItem* devItem = new QTreeWidgetItem(cmpItem);
+            devItem->setText(0, dev.name);
+            devItem->setData(0, Qt::UserRole, dev.filepath.toStr());
+            // package
+            if (!dev.packageName.isEmpty()) {
+                devItem->setText(1, dev.packageName);
+                devItem->setTextAlignment(1, Qt::AlignRight);
+            }
+        }
+        cmpItem->setText(1, QString("[%1]").arg(cmp.devices.count()));
+        cmpItem->setTextAlignment(1, Qt::AlignRight);
+    }
+}
+
+void AddComponentDialog::searchFailed(int searchId, QString errorMsg) noexcept
+{
+    if (searchId == mCurrentSearchId) {
+        mCurrentSearchId = -1;
+        QMessageBox::critical(this, tr("Error"), errorMsg);
+    }
+}
+
 void AddComponentDialog::treeCategories_currentItemChanged(const QModelIndex& current,
                                                            const QModelIndex& previous) noexcept
 {
@@ -228,55 +276,21 @@ void AddComponentDialog::searchComponents(const QString& input)
     setSelectedComponent(nullptr);
     mUi->treeComponents->clear();
 
+    // the results are added by searchResultsAvailable(), ordered by relevance
     if (input.length() > 1) { // avoid freeze on entering first character due to huge result
         const QStringList& localeOrder = mProject.getSettings().getLocaleOrder();
-        QSet<Uuid> components = mWorkspace.getLibraryDb().getComponentsBySearchKeyword(input);
-        foreach (const Uuid& cmpUuid, components) {
-            // component
-            FilePath cmpFp = mWorkspace.getLibraryDb().getLatestComponent(cmpUuid);
-            if (!cmpFp.isValid()) continue;
-            QString cmpName;
-            mWorkspace.getLibraryDb().getElementTranslations<library::Component>(cmpFp, localeOrder, &cmpName);
-            QTreeWidgetItem* cmpItem = new QTreeWidgetItem(mUi->treeComponents);
-            cmpItem->setText(0, cmpName);
-            cmpItem->setData(0, Qt::UserRole, cmpFp.toStr());
-            // devices
-            QSet<Uuid> devices = mWorkspace.getLibraryDb().getDevicesOfComponent(cmpUuid);
-            foreach (const Uuid& devUuid, devices) {
-                try {
-                    FilePath devFp = mWorkspace.getLibraryDb().getLatestDevice(devUuid);
-                    if (!devFp.isValid()) continue;
-                    QString devName;
-                    mWorkspace.getLibraryDb().getElementTranslations<library::Device>(devFp, localeOrder, &devName);
-                    QTreeWidgetItem* devItem = new QTreeWidgetItem(cmpItem);
-                    devItem->setText(0, devName);
-                    devItem->setData(0, Qt::UserRole, devFp.toStr());
-                    // package
-                    Uuid pkgUuid;
-                    mWorkspace.getLibraryDb().getDeviceMetadata(devFp, &pkgUuid);
-                    if (!pkgUuid.isNull()) {
-                        FilePath pkgFp = mWorkspace.getLibraryDb().getLatestPackage(pkgUuid);
-                        if (pkgFp.isValid()) {
-                            QString pkgName;
-                            mWorkspace.getLibraryDb().getElementTranslations<library::Package>(pkgFp, localeOrder, &pkgName);
-                            devItem->setText(1, pkgName);
-                            devItem->setTextAlignment(1, Qt::AlignRight);
-                        }
-                    }
-                } catch (const Exception& e) {
-                    // what could we do here?
-                }
-            }
-            cmpItem->setText(1, QString("[%1]").arg(devices.count()));
-            cmpItem->setTextAlignment(1, Qt::AlignRight);
-        }
+        mCurrentSearchId = mSearch->startSearch(input, localeOrder);
+    } else {
+        mSearch->cancelSearch();
+        mCurrentSearchId = -1;
     }
-
-    mUi->treeComponents->sortByColumn(0, Qt::AscendingOrder);
 }
 
 void AddComponentDialog::setSelectedCategory(const Uuid& categoryUuid)
 {
+    mSearchTimer->stop();
+    mSearch->cancelSearch();
+    mCurrentSearchId = -1;
     setSelectedComponent(nullptr);
     mUi->treeComponents->clear();
 
@@ -29,6 +29,7 @@
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/exceptions.h>
 #include <librepcb/workspace/library/cat/categorytreemodel.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
 
 /*****************************************************************************************
  *  Namespace / Forward Declarations
@@ -94,6 +95,9 @@ class AddComponentDialog final : public QDialog
 
     private slots:
         void searchEditTextChanged(const QString& text) noexcept;
+        void searchResultsAvailable(int searchId,
+            QList<workspace::WorkspaceLibrarySearch::ComponentMatch> page) noexcept;
+        void searchFailed(int searchId, QString errorMsg) noexcept;
         void treeCategories_currentItemChanged(const QModelIndex& current,
                                                const QModelIndex& previous) noexcept;
         void treeComponents_currentItemChanged(QTreeWidgetItem *current,
@@ -121,6 +125,9 @@ class AddComponentDialog final : public QDialog
         GraphicsScene* mDevicePreviewScene;
         QScopedPointer<DefaultGraphicsLayerProvider> mGraphicsLayerProvider;
         workspace::ComponentCategoryTreeModel* mCategoryTreeModel;
+        QScopedPointer<workspace::WorkspaceLibrarySearch> mSearch;
+        QTimer* mSearchTimer; ///< delays the search until the user stopped typing
+        int mCurrentSearchId; ///< -1 if no search is running
 
 
         // Attributes
@@ -71,12 +71,25 @@ ProjectEditor::ProjectEditor(workspace::Workspace& workspace, Project& project)
         connect(&mAutoSaveTimer, &QTimer::timeout, this, &ProjectEditor::autosaveProject);
         mAutoSaveTimer.start(1000 * intervalSecs);
     }
+
+    // log the result of background writes started by autosaveProject()
+    connect(&mAutosaveWriter, &AsyncFileWriter::finished, this,
+            [](const QStringList& errors) {
+        if (errors.isEmpty()) {
+            qDebug() << "Project successfully autosaved";
+        } else {
+            foreach (const QString& error, errors) {
+                qWarning() << "Autosave failed:" << error;
+            }
+        }
+    });
 }
 
 ProjectEditor::~ProjectEditor() noexcept
 {
     // stop the autosave timer
     mAutoSaveTimer.stop();
+    mAutosaveWriter.waitForFinished();
 
     // abort all active commands!
     mSchematicEditor->abortAllCommands();
@@ -157,6 +170,9 @@ void ProjectEditor::execNetClassesEditorDialog(QWidget* parent) noexcept
 
 bool ProjectEditor::saveProject() noexcept
 {
+    // make sure a running autosave does not write files while we are saving
+    mAutosaveWriter.waitForFinished();
+
     try
     {
         // step 1: save whole project to temporary files
@@ -184,9 +200,10 @@ bool ProjectEditor::autosaveProject() noexcept
     if ((!mProject.isRestored()) && (mUndoStack->isClean()))
         return false; // do not save if there are no changes
 
-    if (mUndoStack->isCommandGroupActive())
+    if ((mUndoStack->isCommandGroupActive()) || (mAutosaveWriter.isBusy()))
     {
-        // the user is executing a command at the moment, so we should not save now,
+        // the user is executing a command at the moment (or the last autosave is still
+        // being written), so we should not save now,
         // try it a few seconds later instead...
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 4, 0))
         QTimer::singleShot(10000, this, &ProjectEditor::autosaveProject);
@@ -199,8 +216,7 @@ bool ProjectEditor::autosaveProject() noexcept
     try
     {
         qDebug() << "Begin autosaving the project to temporary files...";
-        mProject.save(false);
-        qDebug() << "Project successfully autosaved";
+        mProject.autosave(mAutosaveWriter); // schematics and boards are written later
         return true;
     }
     catch (Exception& exc)
@@ -27,6 +27,7 @@
 #include <librepcb/common/fileio/serializableobject.h>
 #include <librepcb/common/attributes/attributeprovider.h>
 #include <librepcb/common/exceptions.h>
+#include <librepcb/common/fileio/asyncfilewriter.h>
 #include <librepcb/common/fileio/directorylock.h>
 
 /*****************************************************************************************
@@ -214,6 +215,7 @@ class ProjectEditor final : public QObject
         workspace::Workspace& mWorkspace;
         Project& mProject;
         QTimer mAutoSaveTimer; ///< the timer for the periodically automatic saving functionality (see also @ref doc_project_save)
+        AsyncFileWriter mAutosaveWriter; ///< writes schematics and boards while autosaving
         UndoStack* mUndoStack; ///< See @ref doc_project_undostack
         SchematicEditor* mSchematicEditor; ///< The schematic editor (GUI)
         BoardEditor* mBoardEditor; ///< The board editor (GUI)
@@ -50,21 +50,31 @@ using namespace library;
  ****************************************************************************************/
 
 WorkspaceLibraryDb::WorkspaceLibraryDb(Workspace& ws):
-    QObject(nullptr), mWorkspace(ws)
+    QObject(nullptr), mWorkspace(ws),
+    mFilePath(ws.getLibrariesPath().getPathTo("cache.sqlite")),
+    mFullTextSearchAvailable(false)
 {
     qDebug("Load workspace library database...");
 
     // open SQLite database
-    FilePath dbFilePath = ws.getLibrariesPath().getPathTo("cache.sqlite");
-    mDb.reset(new SQLiteDatabase(dbFilePath)); // can throw
+    mDb.reset(new SQLiteDatabase(mFilePath)); // can throw
 
-    // if the db has an old version, just remove the whole db and create a new one
+    // if the db has an old version or its search index does not match the features of
+    // the SQLite library, just remove the whole db and create a new one
+    mFullTextSearchAvailable = mDb->isFullTextSearchAvailable(); // can throw
     int dbVersion = getDbVersion();
+    bool recreateDb = false;
     if (dbVersion < sCurrentDbVersion) {
         qInfo() << "Library database version" << dbVersion << "is outdated -> update triggered";
+        recreateDb = true;
+    } else if (hasFullTextSearchIndex() != mFullTextSearchAvailable) {
+        qInfo() << "Library database search index is outdated -> update triggered";
+        recreateDb = true;
+    }
+    if (recreateDb) {
         mDb.reset();
-        QFile(dbFilePath.toStr()).remove();
-        mDb.reset(new SQLiteDatabase(dbFilePath)); // can throw
+        QFile(mFilePath.toStr()).remove();
+        mDb.reset(new SQLiteDatabase(mFilePath)); // can throw
         createAllTables(); // can throw
         setDbVersion(sCurrentDbVersion); // can throw
     }
@@ -320,25 +330,25 @@ QSet<Uuid> WorkspaceLibraryDb::getDevicesOfComponent(const Uuid& component) cons
     return elements;
 }
 
-QSet<Uuid> WorkspaceLibraryDb::getComponentsBySearchKeyword(const QString& keyword) const
+QList<Uuid> WorkspaceLibraryDb::getComponentsBySearchKeyword(const QString& keyword,
+    const QStringList& localeOrder) const
 {
+    if (keyword.trimmed().isEmpty()) {
+        return QList<Uuid>();
+    }
+
     QSqlQuery query = mDb->prepareQuery(
-        "SELECT components.uuid FROM components, components_tr, devices, devices_tr "
-        "ON components.id=components_tr.component_id "
-        "AND devices.id=devices_tr.device_id "
-        "AND devices.component_uuid=components.uuid "
-        "WHERE components_tr.name LIKE :keyword "
-        "OR components_tr.keywords LIKE :keyword "
-        "OR devices_tr.name LIKE :keyword "
-        "OR devices_tr.keywords LIKE :keyword ");
-    query.bindValue(":keyword", "%" + keyword + "%");
+        "SELECT matches.uuid FROM (" %
+        getComponentMatchesSql(mFullTextSearchAvailable, localeOrder.count()) %
+        ") AS matches ORDER BY matches.locale_rank, matches.score");
+    bindComponentMatchesSql(query, mFullTextSearchAvailable, keyword, localeOrder);
     mDb->exec(query);
 
-    QSet<Uuid> elements;
+    QList<Uuid> elements;
     while (query.next()) {
         Uuid uuid(query.value(0).toString());
         if (!uuid.isNull()) {
-            elements.insert(uuid);
+            elements.append(uuid);
         } else {
             throw LogicError(__FILE__, __LINE__);
         }
@@ -355,6 +365,90 @@ void WorkspaceLibraryDb::startLibraryRescan() noexcept
     mLibraryScanner->start();
 }
 
+/*****************************************************************************************
+ *  Static Methods
+ ****************************************************************************************/
+
+QString WorkspaceLibraryDb::getComponentMatchesSql(bool fullTextSearch, int localeCount,
+                                                   bool translationIdRange) noexcept
+{
+    // a match of the component itself is as good as a match of one of its devices
+    QString componentMatches, deviceMatches;
+    if (fullTextSearch) {
+        // names are weighted higher than keywords
+        componentMatches =
+            "SELECT components_tr.component_id AS component_id, "
+            "components_tr.locale AS locale, "
+            "bm25(components_fts, 10.0, 1.0) AS score "
+            "FROM components_fts "
+            "INNER JOIN components_tr ON components_tr.id = components_fts.rowid "
+            "WHERE components_fts MATCH :keyword";
+        deviceMatches =
+            "SELECT components.id, devices_tr.locale, bm25(devices_fts, 10.0, 1.0) "
+            "FROM devices_fts "
+            "INNER JOIN devices_tr ON devices_tr.id = devices_fts.rowid "
+            "INNER JOIN devices ON devices.id = devices_tr.device_id "
+            "INNER JOIN components ON components.uuid = devices.component_uuid "
+            "WHERE devices_fts MATCH :keyword";
+    } else {
+        componentMatches =
+            "SELECT component_id AS component_id, locale AS locale, 0 AS score "
+            "FROM components_tr "
+            "WHERE (name LIKE :keyword OR keywords LIKE :keyword)";
+        deviceMatches =
+            "SELECT components.id, devices_tr.locale, 0 "
+            "FROM devices_tr "
+            "INNER JOIN devices ON devices.id = devices_tr.device_id "
+            "INNER JOIN components ON components.uuid = devices.component_uuid "
+            "WHERE (devices_tr.name LIKE :keyword OR devices_tr.keywords LIKE :keyword)";
+    }
+    if (translationIdRange) {
+        // the row IDs of the search index are the IDs of the translations
+        QString idColumn = fullTextSearch ? "_fts.rowid" : "_tr.id";
+        componentMatches += " AND components" % idColumn % " BETWEEN :first_id AND :last_id";
+        deviceMatches += " AND devices" % idColumn % " BETWEEN :first_id AND :last_id";
+    }
+    return "SELECT components.uuid AS uuid, "
+           "MIN(" % getLocaleRankSql("matches.locale", localeCount) % ") AS locale_rank, "
+           "MIN(matches.score) AS score "
+           "FROM (" % componentMatches % " UNION ALL " % deviceMatches % ") AS matches "
+           "INNER JOIN components ON components.id = matches.component_id "
+           "GROUP BY components.uuid";
+}
+
+QString WorkspaceLibraryDb::getLocaleRankSql(const QString& column,
+                                             int localeCount) noexcept
+{
+    // same order as librepcb::SerializableKeyValueMap::value(const QStringList&)
+    QString sql = "CASE " % column % " ";
+    for (int i = 0; i < localeCount; ++i) {
+        sql += QString("WHEN :locale%1 THEN %1 ").arg(i);
+    }
+    sql += QString("WHEN '' THEN %1 ELSE %2 END").arg(localeCount).arg(localeCount + 1);
+    return sql;
+}
+
+void WorkspaceLibraryDb::bindComponentMatchesSql(QSqlQuery& query, bool fullTextSearch,
+    const QString& keyword, const QStringList& localeOrder) noexcept
+{
+    if (fullTextSearch) {
+        // every word is quoted (to not interpret any FTS5 syntax) and matched as prefix,
+        // multiple words are implicitly combined with AND
+        QStringList terms;
+        QStringList words = keyword.split(QRegularExpression("\\s+"),
+                                          QString::SkipEmptyParts);
+        foreach (QString word, words) {
+            terms.append("\"" % word.replace("\"", "\"\"") % "\"*");
+        }
+        query.bindValue(":keyword", terms.join(" "));
+    } else {
+        query.bindValue(":keyword", "%" % keyword.trimmed() % "%");
+    }
+    for (int i = 0; i < localeOrder.count(); ++i) {
+        query.bindValue(QString(":locale%1").arg(i), localeOrder.at(i));
+    }
+}
+
 /*****************************************************************************************
  *  Private Methods
  ****************************************************************************************/
@@ -539,6 +633,19 @@ QList<FilePath> WorkspaceLibraryDb::getLibraryElements(const FilePath& lib,
     return elements;
 }
 
+bool WorkspaceLibraryDb::hasFullTextSearchIndex() const noexcept
+{
+    try {
+        QSqlQuery query = mDb->prepareQuery(
+            "SELECT COUNT(*) FROM sqlite_master "
+            "WHERE type = 'table' AND name = 'components_fts'");
+        mDb->exec(query);
+        return query.next() && (query.value(0).toInt() > 0);
+    } catch (const Exception& e) {
+        return false;
+    }
+}
+
 void WorkspaceLibraryDb::createAllTables()
 {
     QStringList queries;
@@ -577,7 +684,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`filepath` TEXT UNIQUE NOT NULL, "
                         "`uuid` TEXT NOT NULL, "
                         "`version` TEXT NOT NULL, "
-                        "`parent_uuid` TEXT"
+                        "`parent_uuid` TEXT, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS component_categories_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -596,7 +706,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`filepath` TEXT UNIQUE NOT NULL, "
                         "`uuid` TEXT NOT NULL, "
                         "`version` TEXT NOT NULL, "
-                        "`parent_uuid` TEXT"
+                        "`parent_uuid` TEXT, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS package_categories_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -614,7 +727,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`lib_id` INTEGER NOT NULL, "
                         "`filepath` TEXT UNIQUE NOT NULL, "
                         "`uuid` TEXT NOT NULL, "
-                        "`version` TEXT NOT NULL"
+                        "`version` TEXT NOT NULL, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS symbols_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -638,7 +754,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`lib_id` INTEGER NOT NULL, "
                         "`filepath` TEXT UNIQUE NOT NULL, "
                         "`uuid` TEXT NOT NULL, "
-                        "`version` TEXT NOT NULL "
+                        "`version` TEXT NOT NULL, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS packages_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -662,7 +781,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`lib_id` INTEGER NOT NULL, "
                         "`filepath` TEXT UNIQUE NOT NULL, "
                         "`uuid` TEXT NOT NULL, "
-                        "`version` TEXT NOT NULL"
+                        "`version` TEXT NOT NULL, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS components_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -688,7 +810,10 @@ void WorkspaceLibraryDb::createAllTables()
                         "`uuid` TEXT NOT NULL, "
                         "`version` TEXT NOT NULL, "
                         "`component_uuid` TEXT NOT NULL, "
-                        "`package_uuid` TEXT NOT NULL"
+                        "`package_uuid` TEXT NOT NULL, "
+                        "`file_modified` INTEGER NOT NULL, "
+                        "`file_size` INTEGER NOT NULL, "
+                        "`file_hash` BLOB NOT NULL"
                         ")");
     queries << QString( "CREATE TABLE IF NOT EXISTS devices_tr ("
                         "`id` INTEGER PRIMARY KEY NOT NULL, "
@@ -706,6 +831,40 @@ void WorkspaceLibraryDb::createAllTables()
                         "UNIQUE(device_id, category_uuid)"
                         ")");
 
+    // indices for lookups by UUID
+    queries << QString( "CREATE INDEX IF NOT EXISTS components_uuid ON components(uuid)");
+    queries << QString( "CREATE INDEX IF NOT EXISTS devices_uuid ON devices(uuid)");
+    queries << QString( "CREATE INDEX IF NOT EXISTS devices_component_uuid "
+                        "ON devices(component_uuid)");
+
+    // full text search index of component and device translations, kept up to date
+    // by triggers (the scanner only inserts and deletes translations)
+    if (mFullTextSearchAvailable) {
+        foreach (const QString& table, QStringList{"components", "devices"}) {
+            queries << QString( "CREATE VIRTUAL TABLE IF NOT EXISTS %1_fts USING fts5("
+                                "name, keywords, content='%1_tr', content_rowid='id', "
+                                "tokenize='unicode61 remove_diacritics 1', prefix='2 3'"
+                                ")").arg(table);
+            queries << QString( "CREATE TRIGGER IF NOT EXISTS %1_tr_insert "
+                                "AFTER INSERT ON %1_tr BEGIN "
+                                "INSERT INTO %1_fts(rowid, name, keywords) "
+                                "VALUES (new.id, new.name, new.keywords); "
+                                "END").arg(table);
+            queries << QString( "CREATE TRIGGER IF NOT EXISTS %1_tr_delete "
+                                "AFTER DELETE ON %1_tr BEGIN "
+                                "INSERT INTO %1_fts(%1_fts, rowid, name, keywords) "
+                                "VALUES ('delete', old.id, old.name, old.keywords); "
+                                "END").arg(table);
+            queries << QString( "CREATE TRIGGER IF NOT EXISTS %1_tr_update "
+                                "AFTER UPDATE ON %1_tr BEGIN "
+                                "INSERT INTO %1_fts(%1_fts, rowid, name, keywords) "
+                                "VALUES ('delete', old.id, old.name, old.keywords); "
+                                "INSERT INTO %1_fts(rowid, name, keywords) "
+                                "VALUES (new.id, new.name, new.keywords); "
+                                "END").arg(table);
+        }
+    }
+
     // execute queries
     foreach (const QString& string, queries) {
         QSqlQuery query = mDb->prepareQuery(string); // can throw
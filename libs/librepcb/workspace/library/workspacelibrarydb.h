@@ -31,6 +31,8 @@
 /*****************************************************************************************
  *  Namespace / Forward Declarations
  ****************************************************************************************/
+class QSqlQuery;
+
 namespace librepcb {
 
 class Version;
@@ -69,6 +71,10 @@ class WorkspaceLibraryDb final : public QObject
         explicit WorkspaceLibraryDb(Workspace& ws);
         ~WorkspaceLibraryDb() noexcept;
 
+        // Getters: General
+        const FilePath& getFilePath() const noexcept {return mFilePath;}
+        bool isFullTextSearchAvailable() const noexcept {return mFullTextSearchAvailable;}
+
         // Getters: Library Elements by their UUID
         QMultiMap<Version, FilePath> getComponentCategories(const Uuid& uuid) const;
         QMultiMap<Version, FilePath> getPackageCategories(const Uuid& uuid) const;
@@ -106,18 +112,67 @@ class WorkspaceLibraryDb final : public QObject
         QSet<Uuid> getComponentsByCategory(const Uuid& category) const;
         QSet<Uuid> getDevicesByCategory(const Uuid& category) const;
         QSet<Uuid> getDevicesOfComponent(const Uuid& component) const;
-        QSet<Uuid> getComponentsBySearchKeyword(const QString& keyword) const;
+
+        /**
+         * @brief Search components by their names and keywords, and those of their devices
+         *
+         * If the SQLite library supports it, a full text search index is used. Every word
+         * of the keyword is then matched as a prefix of a word in the names or keywords,
+         * and all words must match. Otherwise, the keyword is matched as substring.
+         *
+         * @param keyword       The text to search for
+         * @param localeOrder   Matches in these locales are ranked first (in this order)
+         *
+         * @return The UUIDs of all matching components, ordered by relevance
+         */
+        QList<Uuid> getComponentsBySearchKeyword(const QString& keyword,
+            const QStringList& localeOrder = QStringList()) const;
 
         // General Methods
 
         /**
          * @brief Rescan the whole library directory and update the SQLite database
+         *
+         * Only new and modified library elements are parsed, see
+         * librepcb::workspace::WorkspaceLibraryScanner.
          */
         void startLibraryRescan() noexcept;
 
         // Operator Overloadings
         WorkspaceLibraryDb& operator=(const WorkspaceLibraryDb& rhs) = delete;
 
+        // Static Methods
+
+        /**
+         * @brief Get an SQL query which searches components by a keyword
+         *
+         * This allows to use the search of #getComponentsBySearchKeyword() as subquery,
+         * e.g. to join more information in the same query. The query returns the columns
+         * `uuid` (component UUID), `locale_rank` and `score` (lower is better for both).
+         * Bind the parameters with #bindComponentMatchesSql().
+         *
+         * @param fullTextSearch    Whether the FTS5 search index is used, see
+         *                          #isFullTextSearchAvailable()
+         * @param localeCount       Count of locales in the locale order
+         * @param translationIdRange    If true, only translations with an ID between
+         *                              the parameters `:first_id` and `:last_id` are
+         *                              matched (to be bound by the caller). This allows
+         *                              to split a slow search into several short queries.
+         */
+        static QString getComponentMatchesSql(bool fullTextSearch, int localeCount,
+                                              bool translationIdRange = false) noexcept;
+
+        /**
+         * @brief Get an SQL expression which ranks a locale column by the locale order
+         *
+         * The locales must be bound with #bindComponentMatchesSql().
+         */
+        static QString getLocaleRankSql(const QString& column, int localeCount) noexcept;
+
+        static void bindComponentMatchesSql(QSqlQuery& query, bool fullTextSearch,
+                                            const QString& keyword,
+                                            const QStringList& localeOrder) noexcept;
+
 
     signals:
 
@@ -143,6 +198,7 @@ class WorkspaceLibraryDb final : public QObject
                                          const Uuid& categoryUuid) const;
         int getLibraryId(const FilePath& lib) const;
         QList<FilePath> getLibraryElements(const FilePath& lib, const QString& tablename) const;
+        bool hasFullTextSearchIndex() const noexcept;
         void createAllTables();
         void setDbVersion(int version);
         int getDbVersion() const noexcept;
@@ -150,11 +206,13 @@ class WorkspaceLibraryDb final : public QObject
 
         // Attributes
         Workspace& mWorkspace;
-        QScopedPointer<SQLiteDatabase> mDb; ///< the SQLite database "cache.sqlite"
+        FilePath mFilePath; ///< the SQLite database "cache.sqlite"
+        QScopedPointer<SQLiteDatabase> mDb;
         QScopedPointer<WorkspaceLibraryScanner> mLibraryScanner;
+        bool mFullTextSearchAvailable; ///< whether the FTS5 search index is used
 
         // Constants
-        static const int sCurrentDbVersion = 1;
+        static const int sCurrentDbVersion = 3;
 };
 
 /*****************************************************************************************
@@ -21,8 +21,11 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <QtConcurrent/QtConcurrent>
 #include "workspacelibraryscanner.h"
 #include <librepcb/common/sqlitedatabase.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/scopeguard.h>
 #include <librepcb/library/elements.h>
 #include "../workspace.h"
 
@@ -74,43 +77,69 @@ void WorkspaceLibraryScanner::run() noexcept
         FilePath dbFilePath = mWorkspace.getLibrariesPath().getPathTo("cache.sqlite");
         SQLiteDatabase db(dbFilePath); // can throw
 
+        // prepared queries are reused for all elements, but they must not outlive the db
+        auto queriesGuard = scopeGuard([this](){mPreparedQueries.clear();});
+
         // begin database transaction
         SQLiteDatabase::TransactionScopeGuard transactionGuard(db); // can throw
 
-        // clear all tables
-        clearAllTables(db);
+        // get the current content of the database, all entries which are still left
+        // after scanning all libraries do no longer exist and will be removed
+        QHash<QString, int> dbLibraries = getLibrariesFromDb(db);
+        QHash<QString, DbElement> dbComponentCategories = getElementsFromDb(db, "component_categories");
+        QHash<QString, DbElement> dbPackageCategories = getElementsFromDb(db, "package_categories");
+        QHash<QString, DbElement> dbSymbols = getElementsFromDb(db, "symbols");
+        QHash<QString, DbElement> dbPackages = getElementsFromDb(db, "packages");
+        QHash<QString, DbElement> dbComponents = getElementsFromDb(db, "components");
+        QHash<QString, DbElement> dbDevices = getElementsFromDb(db, "devices");
 
         // scan all libraries
         int count = 0;
         qreal percent = 0;
         foreach (const QSharedPointer<Library>& lib, libraries) {
-            int libId = addLibraryToDb(db, lib);
+            int libId = updateLibraryInDb(db, lib, dbLibraries);
             if (mAbort) break;
-            count += addCategoriesToDb<ComponentCategory>(db, lib->searchForElements<ComponentCategory>(),
-                                                          "component_categories", "cat_id", libId);
+            count += updateElementsInDb<ComponentCategory>(db, lib->searchForElements<ComponentCategory>(),
+                                                           "component_categories", "cat_id", libId,
+                                                           dbComponentCategories);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
             if (mAbort) break;
-            count += addCategoriesToDb<PackageCategory>(db, lib->searchForElements<PackageCategory>(),
-                                                        "package_categories", "cat_id", libId);
+            count += updateElementsInDb<PackageCategory>(db, lib->searchForElements<PackageCategory>(),
+                                                         "package_categories", "cat_id", libId,
+                                                         dbPackageCategories);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
             if (mAbort) break;
-            count += addElementsToDb<Symbol>(db, lib->searchForElements<Symbol>(),
-                                             "symbols", "symbol_id", libId);
+            count += updateElementsInDb<Symbol>(db, lib->searchForElements<Symbol>(),
+                                                "symbols", "symbol_id", libId, dbSymbols);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
             if (mAbort) break;
-            count += addElementsToDb<Package>(db, lib->searchForElements<Package>(),
-                                              "packages", "package_id", libId);
+            count += updateElementsInDb<Package>(db, lib->searchForElements<Package>(),
+                                                 "packages", "package_id", libId, dbPackages);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
             if (mAbort) break;
-            count += addElementsToDb<Component>(db, lib->searchForElements<Component>(),
-                                                "components", "component_id", libId);
+            count += updateElementsInDb<Component>(db, lib->searchForElements<Component>(),
+                                                   "components", "component_id", libId,
+                                                   dbComponents);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
             if (mAbort) break;
-            count += addDevicesToDb(db, lib->searchForElements<Device>(),
-                                    "devices", "device_id", libId);
+            count += updateElementsInDb<Device>(db, lib->searchForElements<Device>(),
+                                                "devices", "device_id", libId, dbDevices);
             emit progressUpdate(percent += qreal(100) / (libraries.count() * 6));
         }
 
+        // remove elements and libraries which do no longer exist
+        if (!mAbort) {
+            removeElementsFromDb<ComponentCategory>(db, dbComponentCategories,
+                                                    "component_categories", "cat_id");
+            removeElementsFromDb<PackageCategory>(db, dbPackageCategories,
+                                                  "package_categories", "cat_id");
+            removeElementsFromDb<Symbol>(db, dbSymbols, "symbols", "symbol_id");
+            removeElementsFromDb<Package>(db, dbPackages, "packages", "package_id");
+            removeElementsFromDb<Component>(db, dbComponents, "components", "component_id");
+            removeElementsFromDb<Device>(db, dbDevices, "devices", "device_id");
+            removeLibrariesFromDb(db, dbLibraries);
+        }
+
         // commit transaction
         if (!mAbort) {
             transactionGuard.commit(); // can throw
@@ -121,54 +150,75 @@ void WorkspaceLibraryScanner::run() noexcept
     }
 }
 
-void WorkspaceLibraryScanner::clearAllTables(SQLiteDatabase& db)
+QSqlQuery& WorkspaceLibraryScanner::prepareQuery(SQLiteDatabase& db, const QString& query)
+{
+    auto it = mPreparedQueries.find(query);
+    if (it == mPreparedQueries.end()) {
+        it = mPreparedQueries.insert(query, db.prepareQuery(query)); // can throw
+    }
+    return it.value();
+}
+
+QHash<QString, int> WorkspaceLibraryScanner::getLibrariesFromDb(SQLiteDatabase& db)
 {
-    // libraries
-    db.clearTable("libraries_tr");
-    db.clearTable("libraries");
-
-    // component categories
-    db.clearTable("component_categories_tr");
-    db.clearTable("component_categories");
-
-    // package categories
-    db.clearTable("package_categories_tr");
-    db.clearTable("package_categories");
-
-    // symbols
-    db.clearTable("symbols_tr");
-    db.clearTable("symbols_cat");
-    db.clearTable("symbols");
-
-    // packages
-    db.clearTable("packages_tr");
-    db.clearTable("packages_cat");
-    db.clearTable("packages");
-
-    // components
-    db.clearTable("components_tr");
-    db.clearTable("components_cat");
-    db.clearTable("components");
-
-    // devices
-    db.clearTable("devices_tr");
-    db.clearTable("devices_cat");
-    db.clearTable("devices");
+    QSqlQuery query = db.prepareQuery("SELECT id, filepath FROM libraries");
+    db.exec(query);
+
+    QHash<QString, int> libraries;
+    while (query.next()) {
+        libraries.insert(query.value(1).toString(), query.value(0).toInt());
+    }
+    return libraries;
 }
 
-int WorkspaceLibraryScanner::addLibraryToDb(SQLiteDatabase& db,
-                                            const QSharedPointer<library::Library>& lib)
+QHash<QString, WorkspaceLibraryScanner::DbElement> WorkspaceLibraryScanner::getElementsFromDb(
+    SQLiteDatabase& db, const QString& table)
 {
     QSqlQuery query = db.prepareQuery(
-        "INSERT INTO libraries "
-        "(filepath, uuid, version) VALUES "
-        "(:filepath, :uuid, :version)");
-    query.bindValue(":filepath",    lib->getFilePath().toRelative(mWorkspace.getLibrariesPath()));
-    query.bindValue(":uuid",        lib->getUuid().toStr());
-    query.bindValue(":version",     lib->getVersion().toStr());
-    int id = db.insert(query);
+        "SELECT id, filepath, file_modified, file_size, file_hash FROM " % table);
+    db.exec(query);
+
+    QHash<QString, DbElement> elements;
+    while (query.next()) {
+        Fingerprint fingerprint{query.value(2).toLongLong(), query.value(3).toLongLong(),
+                                query.value(4).toByteArray()};
+        elements.insert(query.value(1).toString(),
+                        DbElement{query.value(0).toInt(), fingerprint});
+    }
+    return elements;
+}
+
+int WorkspaceLibraryScanner::updateLibraryInDb(SQLiteDatabase& db,
+                                               const QSharedPointer<library::Library>& lib,
+                                               QHash<QString, int>& dbLibraries)
+{
+    // libraries are already loaded by the workspace, so there's no need to detect
+    // modifications, just keep the ID stable since all elements refer to it
+    QString filepath = lib->getFilePath().toRelative(mWorkspace.getLibrariesPath());
+    int id = -1;
+    if (dbLibraries.contains(filepath)) {
+        id = dbLibraries.take(filepath);
+        QSqlQuery& query = prepareQuery(db,
+            "UPDATE libraries SET uuid = :uuid, version = :version WHERE id = :id");
+        query.bindValue(":uuid",        lib->getUuid().toStr());
+        query.bindValue(":version",     lib->getVersion().toStr());
+        query.bindValue(":id",          id);
+        db.exec(query);
+        QSqlQuery& deleteQuery = prepareQuery(db, "DELETE FROM libraries_tr WHERE lib_id = :id");
+        deleteQuery.bindValue(":id",    id);
+        db.exec(deleteQuery);
+    } else {
+        QSqlQuery& query = prepareQuery(db,
+            "INSERT INTO libraries "
+            "(filepath, uuid, version) VALUES "
+            "(:filepath, :uuid, :version)");
+        query.bindValue(":filepath",    filepath);
+        query.bindValue(":uuid",        lib->getUuid().toStr());
+        query.bindValue(":version",     lib->getVersion().toStr());
+        id = db.insert(query);
+    }
     foreach (const QString& locale, lib->getAllAvailableLocales()) {
-        QSqlQuery query = db.prepareQuery(
+        QSqlQuery& query = prepareQuery(db,
             "INSERT INTO libraries_tr "
             "(lib_id, locale, name, description, keywords) VALUES "
             "(:element_id, :locale, :name, :description, :keywords)");
@@ -182,140 +232,231 @@ int WorkspaceLibraryScanner::addLibraryToDb(SQLiteDatabase& db,
     return id;
 }
 
+void WorkspaceLibraryScanner::removeLibrariesFromDb(SQLiteDatabase& db,
+                                                    const QHash<QString, int>& libraries)
+{
+    foreach (int id, libraries) {
+        QSqlQuery& trQuery = prepareQuery(db, "DELETE FROM libraries_tr WHERE lib_id = :id");
+        trQuery.bindValue(":id", id);
+        db.exec(trQuery);
+        QSqlQuery& query = prepareQuery(db, "DELETE FROM libraries WHERE id = :id");
+        query.bindValue(":id", id);
+        db.exec(query);
+    }
+}
+
 template <typename ElementType>
-int WorkspaceLibraryScanner::addCategoriesToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-    const QString& table, const QString& idColumn, int libId)
+int WorkspaceLibraryScanner::updateElementsInDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
+    const QString& table, const QString& idColumn, int libId,
+    QHash<QString, DbElement>& dbElements)
 {
+    // New and modified elements are read in the thread pool, but all database accesses
+    // are done in this thread. The number of pending jobs is limited to keep the memory
+    // usage low, and results are written in the original order.
+    const int maxPendingJobs = qMax(QThread::idealThreadCount(), 1) * 4;
+    QQueue<QFuture<ParsedElement>> pendingJobs;
     int count = 0;
-    foreach (const FilePath& filepath, dirs) {
+    foreach (const FilePath& dirpath, dirs) {
         if (mAbort) break;
-        try {
-            ElementType element(filepath, true); // can throw
-            QSqlQuery query = db.prepareQuery(
-                "INSERT INTO " % table % " "
-                "(lib_id, filepath, uuid, version, parent_uuid) VALUES "
-                "(:lib_id, :filepath, :uuid, :version, :parent_uuid)");
-            query.bindValue(":lib_id",      libId);
-            query.bindValue(":filepath",    filepath.toRelative(mWorkspace.getLibrariesPath()));
-            query.bindValue(":uuid",        element.getUuid().toStr());
-            query.bindValue(":version",     element.getVersion().toStr());
-            query.bindValue(":parent_uuid", element.getParentUuid().isNull() ? QVariant(QVariant::String) : element.getParentUuid().toStr());
-            int id = db.insert(query);
-            foreach (const QString& locale, element.getAllAvailableLocales()) {
-                QSqlQuery query = db.prepareQuery(
-                    "INSERT INTO " % table % "_tr "
-                    "(" % idColumn % ", locale, name, description, keywords) VALUES "
-                    "(:element_id, :locale, :name, :description, :keywords)");
-                query.bindValue(":element_id",  id);
-                query.bindValue(":locale",      locale);
-                query.bindValue(":name",        element.getNames().value(locale));
-                query.bindValue(":description", element.getDescriptions().value(locale));
-                query.bindValue(":keywords",    element.getKeywords().value(locale));
-                db.insert(query);
+        ParsedElement element{dirpath, dirpath.toRelative(mWorkspace.getLibrariesPath()),
+            DbElement{-1, Fingerprint{0, -1, QByteArray()}},
+            getFingerprint(dirpath.getPathTo(ElementType::getLongElementName() % ".lp")),
+            true, false, QString(), QString(), {}, {}, {}};
+        if (dbElements.contains(element.filepath)) {
+            element.dbElement = dbElements.take(element.filepath);
+            if ((element.dbElement.fingerprint.modified == element.fingerprint.modified) &&
+                (element.dbElement.fingerprint.size == element.fingerprint.size)) {
+                count++; // unchanged
+                continue;
             }
-            count++;
-        } catch (const Exception& e) {
-            qWarning() << "Failed to open library element:" << filepath.toNative();
+        }
+        const volatile bool* abort = &mAbort;
+        pendingJobs.enqueue(QtConcurrent::run([element, abort](){
+            return parseElement<ElementType>(element, abort);
+        }));
+        while (pendingJobs.count() >= maxPendingJobs) {
+            count += writeElementToDb<ElementType>(db, pendingJobs.dequeue().result(),
+                                                   table, idColumn, libId);
+        }
+    }
+    // always wait for all jobs since they reference this object
+    while (!pendingJobs.isEmpty()) {
+        ParsedElement element = pendingJobs.dequeue().result();
+        if (!mAbort) {
+            count += writeElementToDb<ElementType>(db, element, table, idColumn, libId);
         }
     }
     return count;
 }
 
 template <typename ElementType>
-int WorkspaceLibraryScanner::addElementsToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-    const QString& table, const QString& idColumn, int libId)
+int WorkspaceLibraryScanner::writeElementToDb(SQLiteDatabase& db,
+    const ParsedElement& element, const QString& table, const QString& idColumn,
+    int libId)
 {
-    int count = 0;
-    foreach (const FilePath& filepath, dirs) {
-        if (mAbort) break;
-        try {
-            ElementType element(filepath, true); // can throw
-            QSqlQuery query = db.prepareQuery(
-                "INSERT INTO " % table % " "
-                "(lib_id, filepath, uuid, version) VALUES "
-                "(:lib_id, :filepath, :uuid, :version)");
-            query.bindValue(":lib_id",      libId);
-            query.bindValue(":filepath",    filepath.toRelative(mWorkspace.getLibrariesPath()));
-            query.bindValue(":uuid",        element.getUuid().toStr());
-            query.bindValue(":version",     element.getVersion().toStr());
-            int id = db.insert(query);
-            foreach (const QString& locale, element.getAllAvailableLocales()) {
-                QSqlQuery query = db.prepareQuery(
-                    "INSERT INTO " % table % "_tr "
-                    "(" % idColumn % ", locale, name, description, keywords) VALUES "
-                    "(:element_id, :locale, :name, :description, :keywords)");
-                query.bindValue(":element_id",  id);
-                query.bindValue(":locale",      locale);
-                query.bindValue(":name",        element.getNames().value(locale));
-                query.bindValue(":description", element.getDescriptions().value(locale));
-                query.bindValue(":keywords",    element.getKeywords().value(locale));
-                db.insert(query);
-            }
-            foreach (const Uuid& categoryUuid, element.getCategories()) {
-                Q_ASSERT(!categoryUuid.isNull());
-                QSqlQuery query = db.prepareQuery(
-                    "INSERT INTO " % table % "_cat "
-                    "(" % idColumn % ", category_uuid) VALUES "
-                    "(:element_id, :category_uuid)");
-                query.bindValue(":element_id",  id);
-                query.bindValue(":category_uuid", categoryUuid.toStr());
-                db.insert(query);
-            }
-            count++;
-        } catch (const Exception& e) {
-            qWarning() << "Failed to open library element:" << filepath.toNative();
-        }
+    if (element.valid && (!element.contentModified)) {
+        // only touched
+        updateFingerprintInDb(db, table, element.dbElement.id, element.fingerprint);
+        return 1;
     }
-    return count;
+
+    // remove the outdated entry of modified elements
+    if (element.dbElement.id >= 0) {
+        removeElementFromDb<ElementType>(db, table, idColumn, element.dbElement.id);
+    }
+    if (!element.valid) {
+        qWarning() << "Failed to open library element:" << element.dirpath.toNative();
+        return 0;
+    }
+
+    QStringList columns{"lib_id", "filepath", "uuid", "version", "file_modified",
+                        "file_size", "file_hash"};
+    columns.append(element.columns.keys());
+    QSqlQuery& query = prepareQuery(db,
+        "INSERT INTO " % table % " "
+        "(" % columns.join(", ") % ") VALUES "
+        "(:" % columns.join(", :") % ")");
+    query.bindValue(":lib_id",          libId);
+    query.bindValue(":filepath",        element.filepath);
+    query.bindValue(":uuid",            element.uuid);
+    query.bindValue(":version",         element.version);
+    query.bindValue(":file_modified",   element.fingerprint.modified);
+    query.bindValue(":file_size",       element.fingerprint.size);
+    query.bindValue(":file_hash",       element.fingerprint.hash);
+    for (auto it = element.columns.constBegin(); it != element.columns.constEnd(); ++it) {
+        query.bindValue(":" % it.key(), it.value());
+    }
+    int id = db.insert(query);
+
+    foreach (const Translation& translation, element.translations) {
+        QSqlQuery& query = prepareQuery(db,
+            "INSERT INTO " % table % "_tr "
+            "(" % idColumn % ", locale, name, description, keywords) VALUES "
+            "(:element_id, :locale, :name, :description, :keywords)");
+        query.bindValue(":element_id",  id);
+        query.bindValue(":locale",      translation.locale);
+        query.bindValue(":name",        translation.name);
+        query.bindValue(":description", translation.description);
+        query.bindValue(":keywords",    translation.keywords);
+        db.insert(query);
+    }
+    foreach (const QString& categoryUuid, element.categories) {
+        QSqlQuery& query = prepareQuery(db,
+            "INSERT INTO " % table % "_cat "
+            "(" % idColumn % ", category_uuid) VALUES "
+            "(:element_id, :category_uuid)");
+        query.bindValue(":element_id",  id);
+        query.bindValue(":category_uuid", categoryUuid);
+        db.insert(query);
+    }
+    return 1;
 }
 
-int WorkspaceLibraryScanner::addDevicesToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-    const QString& table, const QString& idColumn, int libId)
+template <typename ElementType>
+void WorkspaceLibraryScanner::removeElementsFromDb(SQLiteDatabase& db,
+    const QHash<QString, DbElement>& elements, const QString& table,
+    const QString& idColumn)
 {
-    int count = 0;
-    foreach (const FilePath& filepath, dirs) {
-        if (mAbort) break;
-        try {
-            Device element(filepath, true); // can throw
-            QSqlQuery query = db.prepareQuery(
-                "INSERT INTO " % table % " "
-                "(lib_id, filepath, uuid, version, component_uuid, package_uuid) VALUES "
-                "(:lib_id, :filepath, :uuid, :version, :component_uuid, :package_uuid)");
-            query.bindValue(":lib_id",      libId);
-            query.bindValue(":filepath",        filepath.toRelative(mWorkspace.getLibrariesPath()));
-            query.bindValue(":uuid",            element.getUuid().toStr());
-            query.bindValue(":version",         element.getVersion().toStr());
-            query.bindValue(":component_uuid",  element.getComponentUuid().toStr());
-            query.bindValue(":package_uuid",    element.getPackageUuid().toStr());
-            int id = db.insert(query);
-            foreach (const QString& locale, element.getAllAvailableLocales()) {
-                QSqlQuery query = db.prepareQuery(
-                    "INSERT INTO " % table % "_tr "
-                    "(" % idColumn % ", locale, name, description, keywords) VALUES "
-                    "(:element_id, :locale, :name, :description, :keywords)");
-                query.bindValue(":element_id",  id);
-                query.bindValue(":locale",      locale);
-                query.bindValue(":name",        element.getNames().value(locale));
-                query.bindValue(":description", element.getDescriptions().value(locale));
-                query.bindValue(":keywords",    element.getKeywords().value(locale));
-                db.insert(query);
-            }
-            foreach (const Uuid& categoryUuid, element.getCategories()) {
+    foreach (const DbElement& element, elements) {
+        removeElementFromDb<ElementType>(db, table, idColumn, element.id);
+    }
+}
+
+template <typename ElementType>
+void WorkspaceLibraryScanner::removeElementFromDb(SQLiteDatabase& db, const QString& table,
+                                                  const QString& idColumn, int id)
+{
+    QSqlQuery& trQuery = prepareQuery(db,
+        "DELETE FROM " % table % "_tr WHERE " % idColumn % " = :id");
+    trQuery.bindValue(":id", id);
+    db.exec(trQuery);
+    if (std::is_base_of<LibraryElement, ElementType>::value) { // categories have no *_cat
+        QSqlQuery& catQuery = prepareQuery(db,
+            "DELETE FROM " % table % "_cat WHERE " % idColumn % " = :id");
+        catQuery.bindValue(":id", id);
+        db.exec(catQuery);
+    }
+    QSqlQuery& query = prepareQuery(db, "DELETE FROM " % table % " WHERE id = :id");
+    query.bindValue(":id", id);
+    db.exec(query);
+}
+
+void WorkspaceLibraryScanner::updateFingerprintInDb(SQLiteDatabase& db,
+    const QString& table, int id, const Fingerprint& fingerprint)
+{
+    QSqlQuery& query = prepareQuery(db,
+        "UPDATE " % table % " SET file_modified = :file_modified, "
+        "file_size = :file_size, file_hash = :file_hash WHERE id = :id");
+    query.bindValue(":file_modified",   fingerprint.modified);
+    query.bindValue(":file_size",       fingerprint.size);
+    query.bindValue(":file_hash",       fingerprint.hash);
+    query.bindValue(":id",              id);
+    db.exec(query);
+}
+
+/*****************************************************************************************
+ *  Private Methods executed in the Thread Pool
+ ****************************************************************************************/
+
+template <typename ElementType>
+WorkspaceLibraryScanner::ParsedElement WorkspaceLibraryScanner::parseElement(
+    ParsedElement element, const volatile bool* abort) noexcept
+{
+    if (*abort) {
+        element.valid = false;
+        return element;
+    }
+    try {
+        FilePath filepath = element.dirpath.getPathTo(ElementType::getLongElementName() % ".lp");
+        element.fingerprint.hash = calculateHash(filepath); // can throw
+        if ((element.dbElement.id >= 0) &&
+            (element.fingerprint.hash == element.dbElement.fingerprint.hash)) {
+            element.contentModified = false;
+            element.valid = true;
+            return element;
+        }
+        LibraryBaseElement::Metadata metadata =
+            LibraryBaseElement::readMetadata<ElementType>(element.dirpath); // can throw
+        element.uuid = metadata.uuid.toStr();
+        element.version = metadata.version.toStr();
+        foreach (const QString& locale, metadata.getAllAvailableLocales()) {
+            element.translations.append(Translation{locale, metadata.names.value(locale),
+                metadata.descriptions.value(locale), metadata.keywords.value(locale)});
+        }
+        if (std::is_base_of<LibraryCategory, ElementType>::value) {
+            element.columns.insert("parent_uuid", metadata.parentUuid.isNull()
+                ? QVariant(QVariant::String) : QVariant(metadata.parentUuid.toStr()));
+        }
+        if (std::is_base_of<LibraryElement, ElementType>::value) {
+            foreach (const Uuid& categoryUuid, metadata.categories) {
                 Q_ASSERT(!categoryUuid.isNull());
-                QSqlQuery query = db.prepareQuery(
-                    "INSERT INTO " % table % "_cat "
-                    "(" % idColumn % ", category_uuid) VALUES "
-                    "(:element_id, :category_uuid)");
-                query.bindValue(":element_id",  id);
-                query.bindValue(":category_uuid", categoryUuid.toStr());
-                db.insert(query);
+                element.categories.append(categoryUuid.toStr());
             }
-            count++;
-        } catch (const Exception& e) {
-            qWarning() << "Failed to open library element:" << filepath.toNative();
         }
+        if (std::is_same<Device, ElementType>::value) {
+            element.columns.insert("component_uuid", metadata.componentUuid.toStr());
+            element.columns.insert("package_uuid", metadata.packageUuid.toStr());
+        }
+        element.valid = true;
+    } catch (const Exception& e) {
+        element.valid = false;
     }
-    return count;
+    return element;
+}
+
+WorkspaceLibraryScanner::Fingerprint WorkspaceLibraryScanner::getFingerprint(
+    const FilePath& filepath) noexcept
+{
+    // a missing file leads to an invalid timestamp and size -1, so it is considered as
+    // modified and parsing the element will fail
+    QFileInfo info(filepath.toStr());
+    return Fingerprint{info.lastModified().toMSecsSinceEpoch(), info.size(), QByteArray()};
+}
+
+QByteArray WorkspaceLibraryScanner::calculateHash(const FilePath& filepath)
+{
+    return QCryptographicHash::hash(FileUtils::readFile(filepath), // can throw
+                                    QCryptographicHash::Sha256);
 }
 
 /*****************************************************************************************
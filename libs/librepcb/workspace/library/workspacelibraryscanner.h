@@ -24,6 +24,7 @@
  *  Includes
  ****************************************************************************************/
 #include <QtCore>
+#include <QtSql>
 #include <librepcb/common/exceptions.h>
 
 /*****************************************************************************************
@@ -36,6 +37,10 @@ class SQLiteDatabase;
 
 namespace library {
 class Library;
+class LibraryBaseElement;
+class LibraryCategory;
+class LibraryElement;
+class Device;
 }
 
 namespace workspace {
@@ -49,6 +54,18 @@ class Workspace;
 /**
  * @brief The WorkspaceLibraryScanner class
  *
+ * The scan is incremental: For every library element, the modification time, size and
+ * SHA-256 hash of its main file (e.g. `symbol.lp`) is stored in the database. Only new
+ * elements and elements whose file has changed are parsed, rows of removed elements
+ * are deleted. If only the modification time or size of a file has changed but not its
+ * content (e.g. after a `git checkout`), just the stored fingerprint gets updated. All
+ * modifications are done in a single transaction, so an aborted scan leaves the
+ * database untouched.
+ *
+ * Reading new or modified elements is distributed to the global thread pool, while
+ * only the scanner thread accesses the database. Prepared queries are reused for all
+ * elements of the same type.
+ *
  * @warning Be very careful with dependencies to other objects as the #run() method is
  *          executed in a separate thread! Keep the number of dependencies as small as
  *          possible and consider thread synchronization and object lifetimes.
@@ -84,25 +101,82 @@ class WorkspaceLibraryScanner final : public QThread
         void failed(QString errorMsg);
 
 
+    private: // Types
+
+        /// The state of the main file of a library element, used to detect modifications
+        struct Fingerprint {
+            qint64 modified;    ///< last modification [ms since epoch]
+            qint64 size;        ///< file size [bytes]
+            QByteArray hash;    ///< SHA-256 of the file content (empty if not known yet)
+        };
+
+        /// A library element row in the database
+        struct DbElement {
+            int id;
+            Fingerprint fingerprint;
+        };
+
+        struct Translation {
+            QString locale;
+            QString name;
+            QString description;
+            QString keywords;
+        };
+
+        /// The result of reading a new or modified library element in the thread pool
+        struct ParsedElement {
+            FilePath dirpath;
+            QString filepath;           ///< relative to the workspace libraries directory
+            DbElement dbElement;        ///< the existing row (ID is -1 for new elements)
+            Fingerprint fingerprint;
+            bool contentModified;       ///< false if only the timestamp/size has changed
+            bool valid;                 ///< false if the element could not be read
+            QString uuid;
+            QString version;
+            QMap<QString, QVariant> columns; ///< additional, type specific columns
+            QList<Translation> translations;
+            QStringList categories;
+        };
+
+
     private: // Methods
 
         void run() noexcept override;
-        void clearAllTables(SQLiteDatabase& db);
-        int addLibraryToDb(SQLiteDatabase& db, const QSharedPointer<library::Library>& lib);
+        QSqlQuery& prepareQuery(SQLiteDatabase& db, const QString& query);
+        QHash<QString, int> getLibrariesFromDb(SQLiteDatabase& db);
+        QHash<QString, DbElement> getElementsFromDb(SQLiteDatabase& db, const QString& table);
+        int updateLibraryInDb(SQLiteDatabase& db, const QSharedPointer<library::Library>& lib,
+                              QHash<QString, int>& dbLibraries);
+        void removeLibrariesFromDb(SQLiteDatabase& db, const QHash<QString, int>& libraries);
         template <typename ElementType>
-        int addCategoriesToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-                              const QString& table, const QString& idColumn, int libId);
+        int updateElementsInDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
+                               const QString& table, const QString& idColumn, int libId,
+                               QHash<QString, DbElement>& dbElements);
+        template <typename ElementType>
+        int writeElementToDb(SQLiteDatabase& db, const ParsedElement& element,
+                             const QString& table, const QString& idColumn, int libId);
+        template <typename ElementType>
+        void removeElementsFromDb(SQLiteDatabase& db, const QHash<QString, DbElement>& elements,
+                                  const QString& table, const QString& idColumn);
+        template <typename ElementType>
+        void removeElementFromDb(SQLiteDatabase& db, const QString& table,
+                                 const QString& idColumn, int id);
+        void updateFingerprintInDb(SQLiteDatabase& db, const QString& table, int id,
+                                   const Fingerprint& fingerprint);
+
+        // Methods executed in the thread pool
         template <typename ElementType>
-        int addElementsToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-                            const QString& table, const QString& idColumn, int libId);
-        int addDevicesToDb(SQLiteDatabase& db, const QList<FilePath>& dirs,
-                           const QString& table, const QString& idColumn, int libId);
+        static ParsedElement parseElement(ParsedElement element,
+                                          const volatile bool* abort) noexcept;
+        static Fingerprint getFingerprint(const FilePath& filepath) noexcept;
+        static QByteArray calculateHash(const FilePath& filepath);
 
 
     private: // Data
 
         Workspace& mWorkspace;
         volatile bool mAbort;
+        QHash<QString, QSqlQuery> mPreparedQueries; ///< key: query string (see #run())
 };
 
 /*****************************************************************************************
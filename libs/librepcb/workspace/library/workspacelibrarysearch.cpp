@@ -0,0 +1,276 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtSql>
+#include "workspacelibrarysearch.h"
+#include <librepcb/common/sqlitedatabase.h>
+#include "workspacelibrarydb.h"
+#include "../workspace.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace workspace {
+
+/*****************************************************************************************
+ *  Constructors / Destructor
+ ****************************************************************************************/
+
+WorkspaceLibrarySearch::WorkspaceLibrarySearch(Workspace& ws) noexcept :
+    QThread(nullptr), mLibrariesPath(ws.getLibrariesPath()),
+    mDbFilePath(ws.getLibraryDb().getFilePath()),
+    mFullTextSearch(ws.getLibraryDb().isFullTextSearchAvailable()), mAbort(false),
+    mHasPendingRequest(false), mPendingRequest(), mLatestSearchId(0)
+{
+    qRegisterMetaType<QList<ComponentMatch>>();
+    start();
+}
+
+WorkspaceLibrarySearch::~WorkspaceLibrarySearch() noexcept
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mAbort = true;
+        mWaitCondition.wakeAll();
+    }
+    mLatestSearchId.fetchAndAddOrdered(1); // abort the running search
+    if (!wait(2000)) {
+        qWarning() << "Could not abort the library search worker thread!";
+        terminate();
+        if (!wait(2000)) {
+            qCritical() << "Could not terminate the library search worker thread!";
+        }
+    }
+}
+
+/*****************************************************************************************
+ *  General Methods
+ ****************************************************************************************/
+
+int WorkspaceLibrarySearch::startSearch(const QString& keyword,
+                                        const QStringList& localeOrder) noexcept
+{
+    int id = mLatestSearchId.fetchAndAddOrdered(1) + 1;
+    QMutexLocker locker(&mMutex);
+    mPendingRequest = Request{id, keyword, localeOrder};
+    mHasPendingRequest = true;
+    mWaitCondition.wakeAll();
+    return id;
+}
+
+void WorkspaceLibrarySearch::cancelSearch() noexcept
+{
+    mLatestSearchId.fetchAndAddOrdered(1);
+    QMutexLocker locker(&mMutex);
+    mHasPendingRequest = false;
+}
+
+/*****************************************************************************************
+ *  Private Methods
+ ****************************************************************************************/
+
+void WorkspaceLibrarySearch::run() noexcept
+{
+    // the connection is opened in (and must only be used by) the worker thread
+    QScopedPointer<SQLiteDatabase> db;
+    forever {
+        // wait for the next search, superseded requests were already overwritten
+        Request request;
+        {
+            QMutexLocker locker(&mMutex);
+            while ((!mAbort) && (!mHasPendingRequest)) {
+                mWaitCondition.wait(&mMutex);
+            }
+            if (mAbort) {
+                break;
+            }
+            request = mPendingRequest;
+            mHasPendingRequest = false;
+        }
+
+        try {
+            if (!db) {
+                db.reset(new SQLiteDatabase(mDbFilePath)); // can throw
+            }
+            int count = search(*db, request); // can throw
+            if (!isCancelled(request.id)) {
+                emit searchSucceeded(request.id, count);
+            }
+        } catch (const Exception& e) {
+            if (!isCancelled(request.id)) {
+                emit searchFailed(request.id, e.getMsg());
+            }
+        }
+    }
+}
+
+int WorkspaceLibrarySearch::search(SQLiteDatabase& db, const Request& request)
+{
+    if (request.keyword.trimmed().isEmpty()) {
+        return 0;
+    }
+
+    // A running query cannot be interrupted through the Qt SQL driver, so the matching
+    // components are collected with several short queries, each over a range of
+    // translation IDs. Thus a superseded search (e.g. a slow LIKE search on a huge
+    // library) stops after the current range instead of keeping the worker busy.
+    db.exec("CREATE TEMP TABLE IF NOT EXISTS search_matches ("
+            "`uuid` TEXT NOT NULL, "
+            "`locale_rank` INTEGER NOT NULL, "
+            "`score` REAL NOT NULL"
+            ")"); // can throw
+    db.exec("DELETE FROM temp.search_matches"); // can throw
+    QSqlQuery maxIdQuery = db.prepareQuery(
+        "SELECT MAX(IFNULL((SELECT MAX(id) FROM components_tr), 0), "
+        "IFNULL((SELECT MAX(id) FROM devices_tr), 0))");
+    db.exec(maxIdQuery); // can throw
+    int maxId = maxIdQuery.next() ? maxIdQuery.value(0).toInt() : 0;
+    QSqlQuery matchesQuery = db.prepareQuery(
+        "INSERT INTO temp.search_matches (uuid, locale_rank, score) " %
+        WorkspaceLibraryDb::getComponentMatchesSql(mFullTextSearch,
+                                                   request.localeOrder.count(), true));
+    WorkspaceLibraryDb::bindComponentMatchesSql(matchesQuery, mFullTextSearch,
+                                                request.keyword, request.localeOrder);
+    for (int firstId = 0; firstId <= maxId; firstId += sTranslationsPerQuery) {
+        if (isCancelled(request.id)) {
+            return 0;
+        }
+        matchesQuery.bindValue(":first_id", firstId);
+        matchesQuery.bindValue(":last_id", firstId + sTranslationsPerQuery - 1);
+        db.exec(matchesQuery); // can throw
+    }
+
+    // one row per matching component version and device version, ordered by relevance
+    QString localeRank = WorkspaceLibraryDb::getLocaleRankSql("locale",
+                                                              request.localeOrder.count());
+    QString packageLocaleRank = WorkspaceLibraryDb::getLocaleRankSql("packages_tr.locale",
+        request.localeOrder.count());
+    QSqlQuery query = db.prepareQuery(
+        "SELECT components.uuid, components.filepath, components.version, "
+        "(SELECT name FROM components_tr "
+        "WHERE component_id = components.id AND name IS NOT NULL "
+        "ORDER BY " % localeRank % " LIMIT 1), "
+        "devices.uuid, devices.filepath, devices.version, "
+        "(SELECT name FROM devices_tr "
+        "WHERE device_id = devices.id AND name IS NOT NULL "
+        "ORDER BY " % localeRank % " LIMIT 1), "
+        "(SELECT packages_tr.name FROM packages "
+        "INNER JOIN packages_tr ON packages_tr.package_id = packages.id "
+        "WHERE packages.uuid = devices.package_uuid AND packages_tr.name IS NOT NULL "
+        "ORDER BY " % packageLocaleRank % " LIMIT 1) "
+        "FROM (SELECT uuid, MIN(locale_rank) AS locale_rank, MIN(score) AS score "
+        "FROM temp.search_matches GROUP BY uuid) AS matches "
+        "INNER JOIN components ON components.uuid = matches.uuid "
+        "LEFT JOIN devices ON devices.component_uuid = matches.uuid "
+        "ORDER BY matches.locale_rank, matches.score, matches.uuid");
+    for (int i = 0; i < request.localeOrder.count(); ++i) {
+        query.bindValue(QString(":locale%1").arg(i), request.localeOrder.at(i));
+    }
+    db.exec(query); // can throw
+
+    // rows of the same component are adjacent, so every component can be emitted as
+    // soon as the first row of the next component is read
+    int count = 0;
+    QList<ComponentMatch> page;
+    PendingComponent component;
+    while (query.next()) {
+        if (isCancelled(request.id)) {
+            return count;
+        }
+        Uuid uuid(query.value(0).toString());
+        if (uuid.isNull()) {
+            throw LogicError(__FILE__, __LINE__);
+        }
+        if ((!component.match.uuid.isNull()) && (uuid != component.match.uuid)) {
+            page.append(finishComponent(component));
+            component = PendingComponent();
+            if (page.count() >= sPageSize) {
+                emit resultsAvailable(request.id, page);
+                count += page.count();
+                page.clear();
+            }
+        }
+        component.match.uuid = uuid;
+        addRowToComponent(component, query, mLibrariesPath);
+    }
+    if (!component.match.uuid.isNull()) {
+        page.append(finishComponent(component));
+    }
+    if ((!page.isEmpty()) && (!isCancelled(request.id))) {
+        emit resultsAvailable(request.id, page);
+        count += page.count();
+    }
+    return count;
+}
+
+bool WorkspaceLibrarySearch::isCancelled(int searchId) const noexcept
+{
+    return mLatestSearchId.load() != searchId;
+}
+
+void WorkspaceLibrarySearch::addRowToComponent(PendingComponent& component,
+    const QSqlQuery& query, const FilePath& librariesPath) noexcept
+{
+    // only the latest version of every component and device is used
+    Version cmpVersion(query.value(2).toString());
+    if ((!component.version.isValid()) || (component.version < cmpVersion)) {
+        component.version = cmpVersion;
+        component.match.filepath = FilePath::fromRelative(librariesPath,
+                                                          query.value(1).toString());
+        component.match.name = query.value(3).toString();
+    }
+
+    Uuid devUuid(query.value(4).toString());
+    if (devUuid.isNull()) {
+        return; // component without devices
+    }
+    Version devVersion(query.value(6).toString());
+    if ((!component.devices.contains(devUuid)) ||
+        (component.deviceVersions.value(devUuid) < devVersion)) {
+        component.deviceVersions.insert(devUuid, devVersion);
+        component.devices.insert(devUuid, DeviceMatch{devUuid,
+            FilePath::fromRelative(librariesPath, query.value(5).toString()),
+            query.value(7).toString(), query.value(8).toString()});
+    }
+}
+
+WorkspaceLibrarySearch::ComponentMatch WorkspaceLibrarySearch::finishComponent(
+    const PendingComponent& component) noexcept
+{
+    ComponentMatch match = component.match;
+    match.devices = component.devices.values();
+    std::sort(match.devices.begin(), match.devices.end(),
+              [](const DeviceMatch& a, const DeviceMatch& b) {
+        return QString::localeAwareCompare(a.name, b.name) < 0;
+    });
+    return match;
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace workspace
+} // namespace librepcb
@@ -0,0 +1,172 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
+#define LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <librepcb/common/uuid.h>
+#include <librepcb/common/version.h>
+#include <librepcb/common/fileio/filepath.h>
+
+/*****************************************************************************************
+ *  Namespace / Forward Declarations
+ ****************************************************************************************/
+class QSqlQuery;
+
+namespace librepcb {
+
+class SQLiteDatabase;
+
+namespace workspace {
+
+class Workspace;
+
+/*****************************************************************************************
+ *  Class WorkspaceLibrarySearch
+ ****************************************************************************************/
+
+/**
+ * @brief The WorkspaceLibrarySearch class searches components in a worker thread
+ *
+ * The search uses the same matching and ranking as
+ * librepcb::workspace::WorkspaceLibraryDb::getComponentsBySearchKeyword(), but all
+ * information required to display the results (file paths and names of the matching
+ * components, their devices and packages) is fetched with a single query on a separate
+ * database connection. The results are emitted in pages with #resultsAvailable() while
+ * the query is still running.
+ *
+ * Starting a new search cancels the currently running one. As running SQL queries
+ * cannot be interrupted, the matching components are collected with several short
+ * queries first, so even a slow search stops quickly. Results of cancelled
+ * searches are not emitted anymore, but a page which was emitted shortly before
+ * cancelling may still arrive, so the receiver has to compare the search ID.
+ *
+ * @warning Like librepcb::workspace::WorkspaceLibraryScanner, the worker thread must
+ *          not access any other objects, so all data is passed by value.
+ */
+class WorkspaceLibrarySearch final : public QThread
+{
+        Q_OBJECT
+
+    public:
+
+        // Types
+        struct DeviceMatch {
+            Uuid uuid;
+            FilePath filepath;      ///< directory of the latest version
+            QString name;
+            QString packageName;    ///< empty if the package was not found
+        };
+        struct ComponentMatch {
+            Uuid uuid;
+            FilePath filepath;      ///< directory of the latest version
+            QString name;
+            QList<DeviceMatch> devices;
+        };
+
+        // Constructors / Destructor
+        explicit WorkspaceLibrarySearch(Workspace& ws) noexcept;
+        WorkspaceLibrarySearch(const WorkspaceLibrarySearch& other) = delete;
+        ~WorkspaceLibrarySearch() noexcept;
+
+        // General Methods
+
+        /**
+         * @brief Start a new search and cancel the running one (if any)
+         *
+         * @param keyword       The text to search for
+         * @param localeOrder   The locale order used for ranking and for the names
+         *
+         * @return The ID of the new search (passed to all signals of this search)
+         */
+        int startSearch(const QString& keyword, const QStringList& localeOrder) noexcept;
+
+        /**
+         * @brief Cancel the running search (if any)
+         */
+        void cancelSearch() noexcept;
+
+        // Operator Overloadings
+        WorkspaceLibrarySearch& operator=(const WorkspaceLibrarySearch& rhs) = delete;
+
+
+    signals:
+
+        void resultsAvailable(int searchId, QList<ComponentMatch> page);
+        void searchSucceeded(int searchId, int componentCount);
+        void searchFailed(int searchId, QString errorMsg);
+
+
+    private: // Types
+
+        struct Request {
+            int id;
+            QString keyword;
+            QStringList localeOrder;
+        };
+
+        /// A component whose rows are currently read (one row per version and device)
+        struct PendingComponent {
+            ComponentMatch match;
+            Version version;
+            QHash<Uuid, DeviceMatch> devices;
+            QHash<Uuid, Version> deviceVersions;
+        };
+
+
+    private: // Methods
+        void run() noexcept override;
+        int search(SQLiteDatabase& db, const Request& request);
+        bool isCancelled(int searchId) const noexcept;
+        static void addRowToComponent(PendingComponent& component, const QSqlQuery& query,
+                                      const FilePath& librariesPath) noexcept;
+        static ComponentMatch finishComponent(const PendingComponent& component) noexcept;
+
+
+    private: // Data
+        FilePath mLibrariesPath;
+        FilePath mDbFilePath;
+        bool mFullTextSearch;
+        QMutex mMutex;
+        QWaitCondition mWaitCondition;
+        bool mAbort;                    ///< protected by #mMutex
+        bool mHasPendingRequest;        ///< protected by #mMutex
+        Request mPendingRequest;        ///< protected by #mMutex
+        QAtomicInt mLatestSearchId;     ///< ID of the latest started or cancelled search
+
+        // Constants
+        static const int sPageSize = 50; ///< count of components per emitted page
+        static const int sTranslationsPerQuery = 2000; ///< see #search()
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace workspace
+} // namespace librepcb
+
+Q_DECLARE_METATYPE(QList<librepcb::workspace::WorkspaceLibrarySearch::ComponentMatch>)
+
+#endif // LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
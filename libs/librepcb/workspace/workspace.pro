@@ -27,6 +27,7 @@ SOURCES += \
     library/cat/categorytreemodel.cpp \
     library/workspacelibrarydb.cpp \
     library/workspacelibraryscanner.cpp \
+    library/workspacelibrarysearch.cpp \
     projecttreemodel.cpp \
     recentprojectsmodel.cpp \
     settings/items/wsi_appdefaultmeasurementunits.cpp \
@@ -49,6 +50,7 @@ HEADERS += \
     library/cat/categorytreemodel.h \
     library/workspacelibrarydb.h \
     library/workspacelibraryscanner.h \
+    library/workspacelibrarysearch.h \
     projecttreemodel.h \
     recentprojectsmodel.h \
     settings/items/wsi_appdefaultmeasurementunits.h \
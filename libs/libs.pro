@@ -2,7 +2,6 @@ TEMPLATE = subdirs
 
 SUBDIRS = \
     clipper \
-    delaunay-triangulation \
     fontobene \
     hoedown \
     googletest \
@@ -13,7 +12,6 @@ SUBDIRS = \
 
 librepcb.depends = \
     clipper \
-    delaunay-triangulation \
     fontobene \
     parseagle \
     hoedown \
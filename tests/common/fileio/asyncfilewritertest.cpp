@@ -0,0 +1,125 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/asyncfilewriter.h>
+#include <librepcb/common/fileio/fileutils.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+class AsyncFileWriterTest : public ::testing::Test
+{
+    protected:
+
+        virtual void SetUp() override
+        {
+            // create temporary, empty directory
+            mTempDir = FilePath::getApplicationTempPath().getPathTo("AsyncFileWriterTest");
+            if (mTempDir.isExistingDir()) {
+                FileUtils::removeDirRecursively(mTempDir); // can throw
+            }
+            FileUtils::makePath(mTempDir);
+        }
+
+        virtual void TearDown() override
+        {
+            // remove temporary directory
+            FileUtils::removeDirRecursively(mTempDir); // can throw
+        }
+
+        FilePath mTempDir;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(AsyncFileWriterTest, testWriteSnapshot)
+{
+    FilePath fp = mTempDir.getPathTo("test.lp");
+    SExpression root = SExpression::createList("test");
+    root.appendTokenChild("value", 42, false);
+
+    AsyncFileWriter writer;
+    writer.addFile(fp, root);
+    root.appendTokenChild("modified", true, false); // must not affect the written file
+    writer.start();
+    writer.waitForFinished();
+    EXPECT_FALSE(writer.isBusy());
+    EXPECT_EQ("(test (value 42))\n", FileUtils::readFile(fp).toStdString());
+}
+
+TEST_F(AsyncFileWriterTest, testWriteMultipleBatches)
+{
+    FilePath fp1 = mTempDir.getPathTo("1.lp");
+    FilePath fp2 = mTempDir.getPathTo("sub/2.lp");
+
+    AsyncFileWriter writer;
+    writer.addFile(fp1, SExpression::createList("first"));
+    writer.start();
+    writer.addFile(fp2, SExpression::createList("second"));
+    writer.start(); // waits for the first batch
+    writer.waitForFinished();
+    EXPECT_EQ("(first)\n", FileUtils::readFile(fp1).toStdString());
+    EXPECT_EQ("(second)\n", FileUtils::readFile(fp2).toStdString());
+}
+
+TEST_F(AsyncFileWriterTest, testResultOfWaitedBatchIsReported)
+{
+    FilePath dir = mTempDir.getPathTo("dir");
+    FileUtils::makePath(dir);
+    FilePath fp = mTempDir.getPathTo("test.lp");
+
+    AsyncFileWriter writer;
+    QList<QStringList> results;
+    QObject::connect(&writer, &AsyncFileWriter::finished,
+                     [&results](const QStringList& errors) {results.append(errors);});
+    writer.addFile(dir, SExpression::createList("first")); // fails, it's a directory
+    writer.start();
+    writer.addFile(fp, SExpression::createList("second"));
+    writer.start(); // waits for the first batch and reports its result
+    ASSERT_EQ(1, results.count());
+    EXPECT_EQ(1, results.at(0).count());
+
+    writer.waitForFinished();
+    QCoreApplication::processEvents();
+    ASSERT_EQ(2, results.count());
+    EXPECT_TRUE(results.at(1).isEmpty());
+    EXPECT_EQ("(second)\n", FileUtils::readFile(fp).toStdString());
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace librepcb
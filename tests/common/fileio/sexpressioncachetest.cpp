@@ -0,0 +1,141 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/sexpressioncache.h>
+#include <librepcb/common/fileio/fileutils.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+class SExpressionCacheTest : public ::testing::Test
+{
+    protected:
+
+        virtual void SetUp() override
+        {
+            // create temporary, empty directory
+            mTempDir = FilePath::getApplicationTempPath().getPathTo("SExpressionCacheTest");
+            if (mTempDir.isExistingDir()) {
+                FileUtils::removeDirRecursively(mTempDir); // can throw
+            }
+            FileUtils::makePath(mTempDir);
+        }
+
+        virtual void TearDown() override
+        {
+            // remove temporary directory
+            FileUtils::removeDirRecursively(mTempDir); // can throw
+        }
+
+        static QByteArray hash(const QByteArray& content) noexcept {
+            return QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+        }
+
+        FilePath mTempDir;
+        QByteArray mContent = "(board 1ba7f4d7-4e01-4bd0-bcb6-4c4f5cb5dcd6\n"
+                              " (name \"Foo \\\"Bar\\\" \xC3\xA4\")\n"
+                              " (via (pos 1.0 -2.5) (size 0.7))\n"
+                              " (via (pos 3.0 -2.5) (size 0.7))\n"
+                              ")\n";
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(SExpressionCacheTest, testSerializeDeserialize)
+{
+    FilePath fp = mTempDir.getPathTo("board.lp");
+    SExpression parsed = SExpression::parse(mContent, fp);
+    QByteArray data = SExpressionCache::serialize(parsed, hash(mContent));
+    SExpression loaded = SExpressionCache::deserialize(
+        reinterpret_cast<const uchar*>(data.constData()), data.size(), hash(mContent), fp);
+    EXPECT_EQ(parsed.toByteArray().toStdString(), loaded.toByteArray().toStdString());
+    EXPECT_EQ(fp, loaded.getFilePath());
+    const SExpression& size = loaded.getChildren("via").last().getChildByPath("size");
+    EXPECT_EQ(4, size.getFileLine());
+    EXPECT_EQ(22, size.getFileColumn());
+    EXPECT_TRUE(loaded.getChildByIndex(0).isString());
+}
+
+TEST_F(SExpressionCacheTest, testDeserializeInvalidData)
+{
+    FilePath fp = mTempDir.getPathTo("board.lp");
+    SExpression parsed = SExpression::parse(mContent, fp);
+    QByteArray data = SExpressionCache::serialize(parsed, hash(mContent));
+    const uchar* ptr = reinterpret_cast<const uchar*>(data.constData());
+    EXPECT_THROW(SExpressionCache::deserialize(ptr, data.size(), hash("foo"), fp),
+                 RuntimeError);
+    EXPECT_THROW(SExpressionCache::deserialize(ptr, data.size() - 1, hash(mContent), fp),
+                 RuntimeError);
+    EXPECT_THROW(SExpressionCache::deserialize(ptr, 10, hash(mContent), fp),
+                 RuntimeError);
+    QByteArray corrupted = data;
+    corrupted[0] = 'X';
+    EXPECT_THROW(SExpressionCache::deserialize(
+        reinterpret_cast<const uchar*>(corrupted.constData()), corrupted.size(),
+        hash(mContent), fp), RuntimeError);
+}
+
+TEST_F(SExpressionCacheTest, testParseUpdatesCacheFile)
+{
+    FilePath fp = mTempDir.getPathTo("boards/board.lp");
+    SExpressionCache cache(mTempDir.getPathTo("cache"), mTempDir);
+
+    // first parse creates the cache file, second parse uses it
+    SExpression first = cache.parse(mContent, fp);
+    ASSERT_EQ(1, FileUtils::getFilesInDirectory(cache.getDirectory()).count());
+    SExpression second = cache.parse(mContent, fp);
+    EXPECT_EQ(first.toByteArray().toStdString(), second.toByteArray().toStdString());
+
+    // modified content must not use the outdated cache file
+    QByteArray modified = mContent;
+    modified.replace("0.7", "0.9");
+    SExpression third = cache.parse(modified, fp);
+    const SExpression& via = third.getChildren("via").first();
+    EXPECT_EQ("0.9", via.getValueByPath<QString>("size", true).toStdString());
+    EXPECT_EQ(1, FileUtils::getFilesInDirectory(cache.getDirectory()).count());
+
+    // invalid cache files are ignored and overwritten
+    FilePath cacheFile = FileUtils::getFilesInDirectory(cache.getDirectory()).first();
+    FileUtils::writeFile(cacheFile, "garbage");
+    SExpression fourth = cache.parse(modified, fp);
+    EXPECT_EQ(third.toByteArray().toStdString(), fourth.toByteArray().toStdString());
+    EXPECT_NE(QByteArray("garbage"), FileUtils::readFile(cacheFile));
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace librepcb
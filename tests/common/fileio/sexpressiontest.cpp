@@ -0,0 +1,329 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/sexpression.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+class SExpressionTest : public ::testing::Test
+{
+    protected:
+        FilePath mFilePath = FilePath::getApplicationTempPath().getPathTo("test.lp");
+
+        // returns the error message or an empty string if parsing succeeded
+        QString getParseError(const QByteArray& content) const noexcept {
+            try {
+                SExpression::parse(content, mFilePath);
+                return QString();
+            } catch (const FileParseError& e) {
+                return e.getMsg();
+            }
+        }
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(SExpressionTest, testParseNestedLists)
+{
+    QByteArray content = "(board 1ba7f4d7-4e01-4bd0-bcb6-4c4f5cb5dcd6\n"
+                         " (name \"Foo Bar\")\n"
+                         " (layer top_cu (visible true))\n"
+                         " (empty)\n"
+                         ")\n";
+    SExpression root = SExpression::parse(content, mFilePath);
+    EXPECT_TRUE(root.isList());
+    EXPECT_EQ(QString("board"), root.getName());
+    EXPECT_EQ(mFilePath, root.getFilePath());
+    ASSERT_EQ(4, root.getChildren().count());
+    EXPECT_TRUE(root.getChildByIndex(0).isString()); // tokens are returned as strings
+    EXPECT_EQ(Uuid("1ba7f4d7-4e01-4bd0-bcb6-4c4f5cb5dcd6"),
+              root.getChildByIndex(0).getValue<Uuid>(true));
+    EXPECT_EQ(QString("Foo Bar"), root.getValueByPath<QString>("name", true));
+    EXPECT_EQ(QString("top_cu"), root.getValueByPath<QString>("layer", true));
+    EXPECT_TRUE(root.getValueByPath<bool>("layer/visible", true));
+    EXPECT_EQ(0, root.getChildByPath("empty").getChildren().count());
+    EXPECT_EQ(mFilePath, root.getChildByPath("layer/visible").getFilePath());
+}
+
+TEST_F(SExpressionTest, testParseStrings)
+{
+    QByteArray content = "(test \"\" \"a\\\"b\\\\c\\nd\\te\" \"(no list)\" \"\xC3\xA4\xE2\x82\xAC\""
+                         " t\xC3\xB6ken)";
+    SExpression root = SExpression::parse(content, mFilePath);
+    ASSERT_EQ(5, root.getChildren().count());
+    EXPECT_EQ(QString(""), root.getChildByIndex(0).getValue<QString>(false));
+    EXPECT_EQ(QString("a\"b\\c\nd\te"), root.getChildByIndex(1).getValue<QString>(true));
+    EXPECT_EQ(QString("(no list)"), root.getChildByIndex(2).getValue<QString>(true));
+    EXPECT_EQ(QString::fromUtf8("\xC3\xA4\xE2\x82\xAC"),
+              root.getChildByIndex(3).getValue<QString>(true));
+    EXPECT_EQ(QString::fromUtf8("t\xC3\xB6ken"),
+              root.getChildByIndex(4).getValue<QString>(true));
+}
+
+TEST_F(SExpressionTest, testParseWhitespaceAndByteOrderMark)
+{
+    QByteArray content = "\xEF\xBB\xBF\r\n\t( list\ta(sub)\"str\"b )\r\n\r\n";
+    SExpression root = SExpression::parse(content, mFilePath);
+    EXPECT_EQ(QString("list"), root.getName());
+    ASSERT_EQ(4, root.getChildren().count());
+    EXPECT_EQ(QString("a"), root.getChildByIndex(0).getValue<QString>(true));
+    EXPECT_EQ(QString("sub"), root.getChildByIndex(1).getName());
+    EXPECT_EQ(QString("str"), root.getChildByIndex(2).getValue<QString>(true));
+    EXPECT_EQ(QString("b"), root.getChildByIndex(3).getValue<QString>(true));
+}
+
+TEST_F(SExpressionTest, testParseSharesEqualNamesAndTokens)
+{
+    QByteArray content = "(root (pos 0.0 1.5) (pos 0.0 2.5))";
+    SExpression root = SExpression::parse(content, mFilePath);
+    const SExpression& pos1 = root.getChildByIndex(0);
+    const SExpression& pos2 = root.getChildByIndex(1);
+    EXPECT_EQ(pos1.getName().constData(), pos2.getName().constData());
+    EXPECT_EQ(pos1.getChildByIndex(0).getValue<QString>(true).constData(),
+              pos2.getChildByIndex(0).getValue<QString>(true).constData());
+    EXPECT_EQ(QString("1.5"), pos1.getChildByIndex(1).getValue<QString>(true));
+    EXPECT_EQ(QString("2.5"), pos2.getChildByIndex(1).getValue<QString>(true));
+}
+
+TEST_F(SExpressionTest, testParseQStringOverload)
+{
+    QString content = QString::fromUtf8("(n\xC3\xA4me \"v\xC3\xA4lue\")");
+    SExpression root = SExpression::parse(content, mFilePath);
+    EXPECT_EQ(QString::fromUtf8("n\xC3\xA4me"), root.getName());
+    EXPECT_EQ(QString::fromUtf8("v\xC3\xA4lue"), root.getValueOfFirstChild<QString>(true));
+}
+
+TEST_F(SExpressionTest, testParseSerializedContent)
+{
+    QString str = "with \"quotes\"\nand\\backslashes\t";
+    SExpression original = SExpression::createList("root");
+    original.appendStringChild("name", str, true);
+    original.appendTokenChild("value", QString("-12.34"), true);
+    SExpression parsed = SExpression::parse(original.toString(0).toUtf8(), mFilePath);
+    EXPECT_EQ(str, parsed.getValueByPath<QString>("name", true));
+    EXPECT_EQ(QString("-12.34"), parsed.getValueByPath<QString>("value", true));
+}
+
+TEST_F(SExpressionTest, testParseErrors)
+{
+    EXPECT_FALSE(getParseError("").isEmpty());
+    EXPECT_FALSE(getParseError("  \n ").isEmpty());
+    EXPECT_FALSE(getParseError("()").isEmpty());
+    EXPECT_FALSE(getParseError("((a))").isEmpty());
+    EXPECT_FALSE(getParseError("(a \"b\" (c)").isEmpty());
+    EXPECT_FALSE(getParseError("(a))").isEmpty());
+    EXPECT_FALSE(getParseError("(a) (b)").isEmpty());
+    EXPECT_FALSE(getParseError("token").isEmpty());
+    EXPECT_FALSE(getParseError("(a) b").isEmpty());
+    EXPECT_FALSE(getParseError("(a \"b)").isEmpty());
+    EXPECT_FALSE(getParseError("(a \"b\\\")").isEmpty());
+    EXPECT_FALSE(getParseError("(a \"\\x\")").isEmpty());
+    EXPECT_TRUE(getParseError("(a \"b\\\"\")").isEmpty());
+}
+
+TEST_F(SExpressionTest, testParseErrorPosition)
+{
+    QString msg = getParseError("(root\n  (a 1)\n  (b \"2)\n)\n");
+    EXPECT_TRUE(msg.contains("Line,Column: 3,6")) << qPrintable(msg);
+    EXPECT_TRUE(msg.contains("(b \"2)")) << qPrintable(msg);
+}
+
+TEST_F(SExpressionTest, testParseErrorPositionAfterNonAsciiCharacters)
+{
+    // columns are counted in characters, not in bytes
+    QString msg = getParseError("(root\n  (name \"Gr\xC3\xB6\xC3\x9F" "e\") (b \"2)\n)\n");
+    EXPECT_TRUE(msg.contains("Line,Column: 2,21")) << qPrintable(msg);
+}
+
+TEST_F(SExpressionTest, testParsePositions)
+{
+    QByteArray content = "(root\n  (a 1)\n\n  (b \"x\" tok)\n)\n";
+    SExpression root = SExpression::parse(content, mFilePath);
+    EXPECT_EQ(1, root.getFileLine());
+    EXPECT_EQ(1, root.getFileColumn());
+    EXPECT_EQ(2, root.getChildByPath("a").getFileLine());
+    EXPECT_EQ(3, root.getChildByPath("a").getFileColumn());
+    EXPECT_EQ(2, root.getChildByPath("a").getChildByIndex(0).getFileLine());
+    EXPECT_EQ(6, root.getChildByPath("a").getChildByIndex(0).getFileColumn());
+    EXPECT_EQ(4, root.getChildByPath("b").getChildByIndex(0).getFileLine());
+    EXPECT_EQ(6, root.getChildByPath("b").getChildByIndex(0).getFileColumn());
+    EXPECT_EQ(4, root.getChildByPath("b").getChildByIndex(1).getFileLine());
+    EXPECT_EQ(10, root.getChildByPath("b").getChildByIndex(1).getFileColumn());
+
+    // copies keep the position and file path
+    SExpression copy = root.getChildByPath("b");
+    EXPECT_EQ(4, copy.getFileLine());
+    EXPECT_EQ(3, copy.getFileColumn());
+    EXPECT_EQ(mFilePath, copy.getFilePath());
+
+    // errors report the position of the invalid node
+    try {
+        root.getChildByPath("b").getValueOfFirstChild<bool>(true);
+        FAIL() << "Exception not thrown";
+    } catch (const FileParseError& e) {
+        EXPECT_TRUE(e.getMsg().contains("Line,Column: 4,6")) << qPrintable(e.getMsg());
+    }
+}
+
+TEST_F(SExpressionTest, testParsePartially)
+{
+    QByteArray content = "(root 1ba7f4d7-4e01-4bd0-bcb6-4c4f5cb5dcd6\n"
+                         " (name \"Foo\")\n"
+                         " (geometry (a \"(\") (b \"\\\")\" (c)))\n"
+                         " (version 0.1 (name \"nested\"))\n"
+                         " (skipped)\n"
+                         ")\n";
+    SExpression root = SExpression::parsePartially(content, mFilePath,
+                                                   {"name", "version"});
+    ASSERT_EQ(3, root.getChildren().count());
+    EXPECT_EQ(Uuid("1ba7f4d7-4e01-4bd0-bcb6-4c4f5cb5dcd6"),
+              root.getChildByIndex(0).getValue<Uuid>(true));
+    EXPECT_EQ(QString("Foo"), root.getValueByPath<QString>("name", true));
+    EXPECT_EQ(QString("0.1"), root.getValueByPath<QString>("version", true));
+    // children of parsed lists are not filtered
+    EXPECT_EQ(QString("nested"), root.getValueByPath<QString>("version/name", true));
+    EXPECT_TRUE(root.tryGetChildByPath("geometry") == nullptr);
+    EXPECT_TRUE(root.tryGetChildByPath("skipped") == nullptr);
+    EXPECT_EQ(4, root.getChildByPath("version").getFileLine());
+
+    // skipped lists must still be valid
+    EXPECT_THROW(SExpression::parsePartially("(root (a (b)", mFilePath, {}),
+                 FileParseError);
+    EXPECT_THROW(SExpression::parsePartially("(root (a \"b))", mFilePath, {}),
+                 FileParseError);
+    EXPECT_THROW(SExpression::parsePartially("(root (a)) (b)", mFilePath, {}),
+                 FileParseError);
+}
+
+TEST_F(SExpressionTest, testParsePositionsAfterNonAsciiCharacters)
+{
+    // two and four byte UTF-8 sequences, each one is a single character
+    QByteArray content = "(root (a \"\xC3\xA4\xF0\x9F\x98\x80\" tok)\n"
+                         " (c \"\xC3\xA4\") (b 2))\n";
+    SExpression root = SExpression::parse(content, mFilePath);
+    EXPECT_EQ(1, root.getChildByPath("a").getChildByIndex(1).getFileLine());
+    EXPECT_EQ(15, root.getChildByPath("a").getChildByIndex(1).getFileColumn());
+    EXPECT_EQ(2, root.getChildByPath("b").getFileLine());
+    EXPECT_EQ(10, root.getChildByPath("b").getFileColumn());
+}
+
+TEST_F(SExpressionTest, testCreatedNodesHaveNoPosition)
+{
+    SExpression root = SExpression::createList("root");
+    root.appendToken(QString("a"));
+    EXPECT_EQ(-1, root.getFileLine());
+    EXPECT_EQ(-1, root.getFileColumn());
+    EXPECT_EQ(-1, root.getChildByIndex(0).getFileLine());
+    EXPECT_FALSE(root.getFilePath().isValid());
+}
+
+TEST_F(SExpressionTest, testGetChildByPath)
+{
+    SExpression root = SExpression::parse(QByteArray("(root (a (b 1)) (c 2) (a (b 3)))"),
+                                          mFilePath);
+    // the last list with a given name is returned
+    EXPECT_EQ(3, root.getValueByPath<int>("a/b", true));
+    EXPECT_EQ(3, root.getValueByPath<int>(QString("a/b"), true));
+    EXPECT_EQ(2, root.getValueByPath<int>("c", true));
+    EXPECT_EQ(&root.getChildByIndex(2), root.tryGetChildByPath("a"));
+    EXPECT_EQ(&root.getChildByIndex(2), root.tryGetChildByPath(QString("a")));
+    EXPECT_TRUE(root.tryGetChildByPath("a/c") == nullptr);
+    EXPECT_TRUE(root.tryGetChildByPath("a/") == nullptr);
+    EXPECT_TRUE(root.tryGetChildByPath("") == nullptr);
+    EXPECT_TRUE(root.tryGetChildByPath(QString("b")) == nullptr);
+    EXPECT_THROW(root.getChildByPath("x"), FileParseError);
+    EXPECT_THROW(root.getChildByPath(QString("a/x")), FileParseError);
+}
+
+TEST_F(SExpressionTest, testSerialize)
+{
+    SExpression root = SExpression::createList("root");
+    root.appendTokenChild("a", QString("1"), false);
+    root.appendStringChild("name", QString("x\"y"), true);
+    SExpression& sub = root.appendList("sub", true);
+    sub.appendToken(QString("t"));
+    sub.appendTokenChild("c", QString("2"), true);
+    root.appendLineBreak();
+    root.appendLineBreak();
+    root.appendList("end", false);
+    QByteArray expected = "(root (a 1)\n"
+                          " (name \"x\\\"y\")\n"
+                          " (sub t\n"
+                          "  (c 2)\n"
+                          " )\n"
+                          "\n"
+                          " (end)\n"
+                          ")";
+    EXPECT_EQ(expected.toStdString(), root.toByteArray().toStdString());
+    EXPECT_EQ(QString::fromUtf8(expected), root.toString(0));
+}
+
+TEST_F(SExpressionTest, testSerializeUnicodeAndEscapedStrings)
+{
+    QStringList values = {QString::fromUtf8("\xC3\xA4\xE2\x82\xAC"), "a?b", "it's",
+                          "tab\there", "back\\slash", "new\nline", "plain text 123."};
+    SExpression root = SExpression::createList("root");
+    foreach (const QString& value, values) {
+        root.appendString(value);
+    }
+    QByteArray output = root.toByteArray();
+    EXPECT_EQ(QString::fromUtf8(output), root.toString(0));
+    EXPECT_TRUE(output.contains("\"plain text 123.\""));
+    SExpression parsed = SExpression::parse(output, mFilePath);
+    ASSERT_EQ(values.count(), parsed.getChildren().count());
+    for (int i = 0; i < values.count(); ++i) {
+        EXPECT_EQ(values.at(i), parsed.getChildByIndex(i).getValue<QString>(true));
+    }
+}
+
+TEST_F(SExpressionTest, testSerializeInvalidNamesAndTokens)
+{
+    EXPECT_THROW(SExpression::createList("Root").toByteArray(), LogicError);
+    EXPECT_THROW(SExpression::createList("1root").toByteArray(), LogicError);
+    EXPECT_THROW(SExpression::createList("").toByteArray(), LogicError);
+    EXPECT_THROW(SExpression::createList("root").appendToken(QString("a b")).toByteArray(),
+                 LogicError);
+    EXPECT_THROW(SExpression::createList("root").appendToken(QString()).toByteArray(),
+                 LogicError);
+    EXPECT_EQ(QByteArray("(r_2 aZ.:_-09)"),
+              SExpression::createList("r_2").appendToken(QString("aZ.:_-09")).toByteArray());
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace librepcb
@@ -0,0 +1,146 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/geometry/pointinpolygonindex.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+class PointInPolygonIndexTest : public ::testing::Test
+{
+    protected:
+        // the reference implementation which was used before
+        static bool containsReference(const Path& path, const Point& point) noexcept {
+            return path.toQPainterPathPx().contains(point.toPxQPointF());
+        }
+
+        // whether a point lies exactly on a sloped edge (where QPainterPath is unreliable)
+        static bool isOnSlopedEdge(const Path& path, const Point& point) noexcept {
+            const QVector<Vertex>& vertices = path.getVertices();
+            for (int i = 0; i < vertices.count(); ++i) {
+                const Point& p1 = vertices.at(i).getPos();
+                const Point& p2 = vertices.at((i + 1) % vertices.count()).getPos();
+                if ((p1.getX() == p2.getX()) || (p1.getY() == p2.getY())) continue;
+                qint64 cross = (p2.getX() - p1.getX()).toNm() * (point.getY() - p1.getY()).toNm()
+                             - (p2.getY() - p1.getY()).toNm() * (point.getX() - p1.getX()).toNm();
+                if ((cross == 0) &&
+                    (point.getY() >= qMin(p1.getY(), p2.getY())) &&
+                    (point.getY() <= qMax(p1.getY(), p2.getY()))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static Point randomPoint(int range) noexcept {
+            return Point(Length(qrand() % range), Length(qrand() % range));
+        }
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(PointInPolygonIndexTest, testEmptyPath)
+{
+    PointInPolygonIndex index((Path()));
+    EXPECT_FALSE(index.contains(Point(0, 0)));
+    EXPECT_TRUE(index.getContainedPoints({Point(0, 0), Point(1, 1)}).isEmpty());
+}
+
+TEST_F(PointInPolygonIndexTest, testRectilinearPolygonIncludingBorders)
+{
+    // L-shaped polygon, open (i.e. implicitly closed)
+    Path path;
+    path.addVertex(Point(0, 0));
+    path.addVertex(Point(4000, 0));
+    path.addVertex(Point(4000, 1000));
+    path.addVertex(Point(1000, 1000));
+    path.addVertex(Point(1000, 3000));
+    path.addVertex(Point(0, 3000));
+    PointInPolygonIndex index(path);
+    for (int x = -500; x <= 4500; x += 250) {
+        for (int y = -500; y <= 3500; y += 250) {
+            Point p(x, y);
+            EXPECT_EQ(containsReference(path, p), index.contains(p))
+                    << qPrintable(QString("x=%1 y=%2").arg(x).arg(y));
+        }
+    }
+}
+
+TEST_F(PointInPolygonIndexTest, testRandomPolygons)
+{
+    qsrand(42);
+    for (int n = 0; n < 50; ++n) {
+        // random (possibly self-intersecting) polygons, some of them explicitly closed
+        Path path;
+        int vertexCount = 3 + (qrand() % 50);
+        for (int i = 0; i < vertexCount; ++i) {
+            path.addVertex(randomPoint(100000));
+        }
+        if (n % 2) {
+            path.close();
+        }
+        PointInPolygonIndex index(path);
+        QVector<Point> points;
+        QVector<int> expected;
+        for (int i = 0; i < 500; ++i) {
+            // also test points at the Y coordinates of the vertices since they are the
+            // most critical ones
+            Point p = randomPoint(110000);
+            if (i < vertexCount) p.setY(path.getVertices().at(i).getPos().getY());
+            if (isOnSlopedEdge(path, p)) continue;
+            bool reference = containsReference(path, p);
+            EXPECT_EQ(reference, index.contains(p));
+            if (reference) expected.append(points.count());
+            points.append(p);
+        }
+        EXPECT_EQ(expected, index.getContainedPoints(points));
+    }
+}
+
+TEST_F(PointInPolygonIndexTest, testPathWithArcs)
+{
+    qsrand(42);
+    Path path = Path::circle(Length(100000));
+    PointInPolygonIndex index(path);
+    for (int i = 0; i < 1000; ++i) {
+        Point p = randomPoint(120000) - Point(60000, 60000);
+        EXPECT_EQ(containsReference(path, p), index.contains(p));
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace librepcb
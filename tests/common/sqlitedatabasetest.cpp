@@ -178,6 +178,28 @@ TEST_F(SQLiteDatabaseTest, testClearNonExistingTable)
     EXPECT_THROW(db.clearTable("test"), Exception);
 }
 
+TEST_F(SQLiteDatabaseTest, testFullTextSearchPrefixQuery)
+{
+    SQLiteDatabase db(mTempDbFilePath);
+    if (!db.isFullTextSearchAvailable()) {
+        return; // nothing to test with this SQLite library
+    }
+    db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+    db.exec("CREATE VIRTUAL TABLE test_fts USING fts5(name, content='test', "
+            "content_rowid='id', prefix='2 3')");
+    db.exec("CREATE TRIGGER test_insert AFTER INSERT ON test BEGIN "
+            "INSERT INTO test_fts(rowid, name) VALUES (new.id, new.name); END");
+    db.exec("INSERT INTO test (name) VALUES ('Resistor 0603')");
+    db.exec("INSERT INTO test (name) VALUES ('Capacitor 0603')");
+    QSqlQuery query = db.prepareQuery(
+        "SELECT rowid FROM test_fts WHERE test_fts MATCH :query ORDER BY rank");
+    query.bindValue(":query", "\"res\"* \"06\"*");
+    db.exec(query);
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(1, query.value(0).toInt());
+    EXPECT_FALSE(query.next());
+}
+
 TEST_F(SQLiteDatabaseTest, testTransactionScopeGuardCommit)
 {
     SQLiteDatabase db(mTempDbFilePath);
@@ -66,6 +66,35 @@ TEST(ToolboxTest, testStringOrNumberToQVariant_mixed)
     EXPECT_EQ(QVariant("l33t"), variant);
 }
 
+TEST(ToolboxTest, testDecimalStringToFixedPoint_valid)
+{
+    qint32 value = 0;
+    EXPECT_TRUE(Toolbox::decimalStringToFixedPoint("-1.25", 6, value));
+    EXPECT_EQ(-1250000, value);
+    EXPECT_TRUE(Toolbox::decimalStringToFixedPoint("+0.000001", 6, value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(Toolbox::decimalStringToFixedPoint("42", 6, value));
+    EXPECT_EQ(42000000, value);
+    EXPECT_TRUE(Toolbox::decimalStringToFixedPoint(".5", 6, value));
+    EXPECT_EQ(500000, value);
+    EXPECT_TRUE(Toolbox::decimalStringToFixedPoint("2147.483647", 6, value));
+    EXPECT_EQ(2147483647, value);
+}
+
+TEST(ToolboxTest, testDecimalStringToFixedPoint_unsupported)
+{
+    qint32 value = 0;
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("-", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint(".", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("1.2.3", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint(" 1", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("1e3", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("0.0000001", 6, value));
+    EXPECT_FALSE(Toolbox::decimalStringToFixedPoint("2147.483648", 6, value));
+    EXPECT_EQ(0, value); // not modified
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
@@ -0,0 +1,125 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2016 The LibrePCB developers
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/utils/rtree.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+class RTreeTest : public ::testing::Test
+{
+    protected:
+        // brute force reference implementation of RTree::find()
+        static QSet<int> findLinear(const QVector<QRectF>& rects, const QVector<bool>& inserted,
+                                    const QRectF& area) noexcept {
+            QSet<int> result;
+            for (int i = 0; i < rects.count(); ++i) {
+                const QRectF& r = rects.at(i);
+                if (inserted.at(i) && (r.left() <= area.right()) && (area.left() <= r.right())
+                    && (r.top() <= area.bottom()) && (area.top() <= r.bottom())) {
+                    result.insert(i);
+                }
+            }
+            return result;
+        }
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(RTreeTest, testEmpty)
+{
+    RTree<int> tree;
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_EQ(0, tree.size());
+    EXPECT_TRUE(tree.find(QRectF(-1000, -1000, 2000, 2000)).isEmpty());
+    EXPECT_FALSE(tree.remove(QRectF(0, 0, 1, 1), 0));
+}
+
+TEST_F(RTreeTest, testPointQueries)
+{
+    RTree<int> tree;
+    tree.insert(QRectF(0, 0, 10, 10), 1);
+    tree.insert(QRectF(5, 5, 0, 0), 2); // zero size
+    tree.insert(QRectF(20, 0, -10, 10), 3); // not normalized
+    EXPECT_EQ(3, tree.size());
+    EXPECT_EQ(QList<int>{1}, tree.find(QRectF(1, 1, 0, 0)));
+    EXPECT_EQ(2, tree.find(QRectF(5, 5, 0, 0)).count());
+    EXPECT_EQ(2, tree.find(QRectF(10, 10, 0, 0)).count()); // borders are included
+    EXPECT_EQ(QList<int>{3}, tree.find(QRectF(15, 5, 0, 0)));
+    EXPECT_TRUE(tree.find(QRectF(25, 5, 0, 0)).isEmpty());
+}
+
+TEST_F(RTreeTest, testRandomInsertRemove)
+{
+    qsrand(42);
+    RTree<int> tree;
+    QVector<QRectF> rects;
+    QVector<bool> inserted;
+    for (int i = 0; i < 2000; ++i) {
+        rects.append(QRectF(qrand() % 1000, qrand() % 1000, qrand() % 20, qrand() % 20));
+        inserted.append(true);
+        tree.insert(rects.last(), i);
+    }
+    for (int n = 0; n < 10000; ++n) {
+        int i = qrand() % rects.count();
+        if (inserted.at(i)) {
+            EXPECT_TRUE(tree.remove(rects.at(i), i));
+            inserted[i] = false;
+        } else {
+            rects[i] = QRectF(qrand() % 1000, qrand() % 1000, qrand() % 20, qrand() % 20);
+            tree.insert(rects.at(i), i);
+            inserted[i] = true;
+        }
+        if (n % 500 == 0) {
+            QRectF area(qrand() % 1000, qrand() % 1000, qrand() % 100, qrand() % 100);
+            QList<int> found = tree.find(area);
+            EXPECT_EQ(found.count(), found.toSet().count()); // no duplicates
+            EXPECT_EQ(findLinear(rects, inserted, area), found.toSet());
+        }
+    }
+    EXPECT_EQ(inserted.count(true), tree.size());
+    for (int i = 0; i < rects.count(); ++i) {
+        if (inserted.at(i)) {
+            EXPECT_TRUE(tree.remove(rects.at(i), i));
+        }
+    }
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_TRUE(tree.find(QRectF(-1000, -1000, 3000, 3000)).isEmpty());
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace librepcb
@@ -0,0 +1,171 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/library/elements.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace library {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The LibraryBaseElementTest checks that
+ *        librepcb::library::LibraryBaseElement::readMetadata() returns the same
+ *        attributes as opening the element
+ */
+class LibraryBaseElementTest : public ::testing::Test
+{
+    protected:
+
+        LibraryBaseElementTest() {
+            mTempDir = FilePath::getRandomTempPath();
+        }
+
+        virtual ~LibraryBaseElementTest() {
+            QDir(mTempDir.toStr()).removeRecursively();
+        }
+
+        /// Set all common attributes (in several locales) and save the element
+        template <typename ElementType>
+        FilePath saveElement(ElementType& element) {
+            element.setDeprecated(true);
+            element.setName("de_CH", "Name DE");
+            element.setDescription("de_CH", "Description DE");
+            element.setKeywords("de_CH", "keyword1,keyword2");
+            element.setKeywords("fr_FR", "keyword FR");
+            element.saveIntoParentDirectory(mTempDir);
+            return element.getFilePath();
+        }
+
+        template <typename ElementType>
+        LibraryBaseElement::Metadata expectMetadataEqualsElement(const FilePath& dir) {
+            LibraryBaseElement::Metadata metadata =
+                LibraryBaseElement::readMetadata<ElementType>(dir);
+            ElementType element(dir, true);
+            EXPECT_EQ(element.getUuid(), metadata.uuid);
+            EXPECT_EQ(element.getVersion(), metadata.version);
+            EXPECT_EQ(element.isDeprecated(), metadata.deprecated);
+            EXPECT_TRUE(element.getNames() == metadata.names);
+            EXPECT_TRUE(element.getDescriptions() == metadata.descriptions);
+            EXPECT_TRUE(element.getKeywords() == metadata.keywords);
+            EXPECT_EQ(element.getAllAvailableLocales(), metadata.getAllAvailableLocales());
+            return metadata;
+        }
+
+        FilePath mTempDir;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfComponentCategory)
+{
+    ComponentCategory category(Uuid::createRandom(), Version("1.2.3"), "author",
+                               "name", "description", "keywords");
+    category.setParentUuid(Uuid::createRandom());
+    FilePath dir = saveElement(category);
+    LibraryBaseElement::Metadata metadata =
+        expectMetadataEqualsElement<ComponentCategory>(dir);
+    EXPECT_EQ(ComponentCategory(dir, true).getParentUuid(), metadata.parentUuid);
+    EXPECT_TRUE(metadata.categories.isEmpty());
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfRootPackageCategory)
+{
+    PackageCategory category(Uuid::createRandom(), Version("0.1"), "author",
+                             "name", "description", "keywords");
+    FilePath dir = saveElement(category);
+    LibraryBaseElement::Metadata metadata =
+        expectMetadataEqualsElement<PackageCategory>(dir);
+    EXPECT_TRUE(metadata.parentUuid.isNull());
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfSymbol)
+{
+    Symbol symbol(Uuid::createRandom(), Version("0.1"), "author",
+                  "name", "description", "keywords");
+    symbol.setCategories({Uuid::createRandom(), Uuid::createRandom()});
+    FilePath dir = saveElement(symbol);
+    LibraryBaseElement::Metadata metadata = expectMetadataEqualsElement<Symbol>(dir);
+    EXPECT_EQ(Symbol(dir, true).getCategories(), metadata.categories);
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfPackage)
+{
+    Package package(Uuid::createRandom(), Version("0.1"), "author",
+                    "name", "description", "keywords");
+    package.setCategories({Uuid::createRandom()});
+    FilePath dir = saveElement(package);
+    LibraryBaseElement::Metadata metadata = expectMetadataEqualsElement<Package>(dir);
+    EXPECT_EQ(Package(dir, true).getCategories(), metadata.categories);
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfComponent)
+{
+    Component component(Uuid::createRandom(), Version("0.1"), "author",
+                        "name", "description", "keywords");
+    component.setCategories({Uuid::createRandom()});
+    component.getPrefixes().setDefaultValue("U");
+    FilePath dir = saveElement(component);
+    LibraryBaseElement::Metadata metadata = expectMetadataEqualsElement<Component>(dir);
+    EXPECT_EQ(Component(dir, true).getCategories(), metadata.categories);
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfDevice)
+{
+    Device device(Uuid::createRandom(), Version("0.1"), "author",
+                  "name", "description", "keywords");
+    device.setCategories({Uuid::createRandom()});
+    device.setComponentUuid(Uuid::createRandom());
+    device.setPackageUuid(Uuid::createRandom());
+    FilePath dir = saveElement(device);
+    LibraryBaseElement::Metadata metadata = expectMetadataEqualsElement<Device>(dir);
+    Device loaded(dir, true);
+    EXPECT_EQ(loaded.getCategories(), metadata.categories);
+    EXPECT_EQ(loaded.getComponentUuid(), metadata.componentUuid);
+    EXPECT_EQ(loaded.getPackageUuid(), metadata.packageUuid);
+}
+
+TEST_F(LibraryBaseElementTest, testReadMetadataOfWrongElementTypeFails)
+{
+    Symbol symbol(Uuid::createRandom(), Version("0.1"), "author",
+                  "name", "description", "keywords");
+    FilePath dir = saveElement(symbol);
+    EXPECT_THROW(LibraryBaseElement::readMetadata<Package>(dir), Exception);
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace library
+} // namespace librepcb
@@ -0,0 +1,211 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <limits>
+#include <gtest/gtest.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/circuit/netsignal.h>
+#include <librepcb/project/circuit/cmd/cmdnetsignaladd.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardairwiresbuilder.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_via.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentadd.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentaddelements.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentremoveelements.h>
+#include <librepcb/project/boards/cmd/cmdboardviaedit.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardAirWiresBuilderTest checks the airwires of a new net signal which
+ *        contains only (unconnected) vias (using the BoardPlaneFragmentsBuilderTest
+ *        project)
+ */
+class BoardAirWiresBuilderTest : public ::testing::Test
+{
+    protected:
+        BoardAirWiresBuilderTest() {
+            FilePath projectFp(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest"
+                                             "/test_project/test_project.lpp");
+            mProject.reset(new Project(projectFp, true));
+            mBoard = mProject->getBoards().first();
+
+            Circuit& circuit = mProject->getCircuit();
+            CmdNetSignalAdd* cmdNetSignal = new CmdNetSignalAdd(circuit,
+                *circuit.getNetClasses().first());
+            execute(cmdNetSignal);
+            mNetSignal = cmdNetSignal->getNetSignal();
+            CmdBoardNetSegmentAdd* cmdNetSegment = new CmdBoardNetSegmentAdd(*mBoard, *mNetSignal);
+            execute(cmdNetSegment);
+            mNetSegment = cmdNetSegment->getNetSegment();
+        }
+
+        ~BoardAirWiresBuilderTest() {
+            qDeleteAll(mCmds);
+        }
+
+        void execute(UndoCommand* cmd) {
+            mCmds.append(cmd);
+            cmd->execute();
+        }
+
+        static Point getRandomPosition() noexcept {
+            // 0..100mm in steps of 1um
+            return Point(Length((qrand() % 100001) * 1000), Length((qrand() % 100001) * 1000));
+        }
+
+        static qreal getDistance(const Point& p1, const Point& p2) noexcept {
+            qreal dx = p2.getX().toNm() - p1.getX().toNm();
+            qreal dy = p2.getY().toNm() - p1.getY().toNm();
+            return qSqrt(dx * dx + dy * dy) / 1000000; // in mm
+        }
+
+        static QList<QPair<Point, Point>> normalize(QVector<QPair<Point, Point>> airwires) noexcept {
+            QList<QPair<Point, Point>> list;
+            foreach (const auto& airwire, airwires) {
+                if ((airwire.second.getX() < airwire.first.getX()) ||
+                    ((airwire.second.getX() == airwire.first.getX()) &&
+                     (airwire.second.getY() < airwire.first.getY()))) {
+                    list.append(qMakePair(airwire.second, airwire.first));
+                } else {
+                    list.append(airwire);
+                }
+            }
+            std::sort(list.begin(), list.end(), [](const QPair<Point, Point>& a,
+                                                   const QPair<Point, Point>& b) {
+                return qMakePair(qMakePair(a.first.getX(), a.first.getY()),
+                                 qMakePair(a.second.getX(), a.second.getY())) <
+                       qMakePair(qMakePair(b.first.getX(), b.first.getY()),
+                                 qMakePair(b.second.getX(), b.second.getY()));
+            });
+            return list;
+        }
+
+        /**
+         * @brief Calculate the length of the minimum spanning tree of all vias with
+         *        Prim's algorithm in O(n^2), i.e. without any candidate graph
+         */
+        qreal getMinimumSpanningTreeLength() const noexcept {
+            QList<Point> positions;
+            foreach (const BI_Via* via, mNetSegment->getVias()) {
+                positions.append(via->getPosition());
+            }
+            qreal length = 0;
+            QVector<qreal> distances(positions.count(), std::numeric_limits<qreal>::max());
+            QVector<bool> done(positions.count(), false);
+            if (!positions.isEmpty()) distances[0] = 0;
+            for (int i = 0; i < positions.count(); ++i) {
+                int next = -1;
+                for (int j = 0; j < positions.count(); ++j) {
+                    if ((!done.at(j)) && ((next < 0) || (distances.at(j) < distances.at(next)))) {
+                        next = j;
+                    }
+                }
+                done[next] = true;
+                length += distances.at(next);
+                for (int j = 0; j < positions.count(); ++j) {
+                    distances[j] = qMin(distances.at(j),
+                                        getDistance(positions.at(j), positions.at(next)));
+                }
+            }
+            return length;
+        }
+
+        QScopedPointer<Project> mProject;
+        Board* mBoard;
+        NetSignal* mNetSignal;
+        BI_NetSegment* mNetSegment;
+        QList<UndoCommand*> mCmds;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(BoardAirWiresBuilderTest, testRandomModifications)
+{
+    qsrand(42);
+    BoardAirWiresBuilder incrementalBuilder(*mBoard, *mNetSignal);
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        QList<BI_Via*> vias = mNetSegment->getVias();
+
+        // add some vias, sometimes many of them at once (rebuilds the whole graph) and
+        // sometimes at the same position as an existing via
+        int count = (iteration % 10 == 0) ? 100 : (qrand() % 5);
+        CmdBoardNetSegmentAddElements* cmdAdd = new CmdBoardNetSegmentAddElements(*mNetSegment);
+        for (int i = 0; i < count; ++i) {
+            Point pos = ((!vias.isEmpty()) && (qrand() % 4 == 0))
+                ? vias.at(qrand() % vias.count())->getPosition() : getRandomPosition();
+            cmdAdd->addVia(pos, BI_Via::Shape::Round, Length(700000), Length(300000));
+        }
+        execute(cmdAdd);
+
+        // move some vias
+        for (int i = 0; (i < 5) && (!vias.isEmpty()); ++i) {
+            CmdBoardViaEdit* cmdEdit = new CmdBoardViaEdit(*vias.at(qrand() % vias.count()));
+            cmdEdit->setPosition(getRandomPosition(), true);
+            execute(cmdEdit);
+        }
+
+        // remove some vias
+        CmdBoardNetSegmentRemoveElements* cmdRemove =
+            new CmdBoardNetSegmentRemoveElements(*mNetSegment);
+        for (int i = 0; (i < 3) && (!vias.isEmpty()); ++i) {
+            cmdRemove->removeVia(*vias.takeAt(qrand() % vias.count()));
+        }
+        execute(cmdRemove);
+
+        // the incremental result must be the same as building from scratch
+        QVector<QPair<Point, Point>> airwires = incrementalBuilder.buildAirWires();
+        BoardAirWiresBuilder freshBuilder(*mBoard, *mNetSignal);
+        EXPECT_EQ(normalize(freshBuilder.buildAirWires()), normalize(airwires));
+
+        // the airwires must be the minimum spanning tree, without zero-length airwires
+        qreal length = 0;
+        foreach (const auto& airwire, airwires) {
+            EXPECT_NE(airwire.first, airwire.second);
+            length += getDistance(airwire.first, airwire.second);
+        }
+        EXPECT_NEAR(getMinimumSpanningTreeLength(), length, 1e-6);
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace project
+} // namespace librepcb
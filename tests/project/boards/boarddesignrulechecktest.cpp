@@ -0,0 +1,268 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/geometry/hole.h>
+#include <librepcb/common/graphics/graphicslayer.h>
+#include <librepcb/library/pkg/footprintpad.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boarddesignrulecheck.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_footprint.h>
+#include <librepcb/project/boards/items/bi_footprintpad.h>
+#include <librepcb/project/boards/items/bi_hole.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+#include <librepcb/project/boards/items/bi_via.h>
+#include <librepcb/project/boards/cmd/cmdboardholeadd.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentaddelements.h>
+#include <librepcb/project/boards/cmd/cmdboardplaneadd.h>
+#include <librepcb/project/erc/ercmsg.h>
+#include <librepcb/project/erc/ercmsglist.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardDesignRuleCheckTest checks the DRC with the project of the
+ *        BoardPlaneFragmentsBuilderTest
+ */
+class BoardDesignRuleCheckTest : public ::testing::Test
+{
+    protected:
+        BoardDesignRuleCheckTest() {
+            FilePath projectFp(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest"
+                                             "/test_project/test_project.lpp");
+            mProject.reset(new Project(projectFp, true));
+            mBoard = mProject->getBoards().first();
+            mBoard->rebuildAllPlanes();
+        }
+
+        static BoardDesignRules createRules(const Length& clearance, const Length& width,
+                                            const Length& ring, const Length& drill) noexcept {
+            BoardDesignRules rules;
+            rules.setMinCopperClearance(clearance);
+            rules.setMinCopperWidth(width);
+            rules.setMinAnnularRing(ring);
+            rules.setMinDrillCopperClearance(drill);
+            return rules;
+        }
+
+        QList<BoardDesignRuleCheck::Violation> check(const BoardDesignRules& rules) const noexcept {
+            BoardDesignRuleCheck drc(*mBoard, rules);
+            return drc.execute();
+        }
+
+        static int count(const QList<BoardDesignRuleCheck::Violation>& violations,
+                         const QString& msgKey) noexcept {
+            int count = 0;
+            foreach (const BoardDesignRuleCheck::Violation& violation, violations) {
+                if (violation.msgKey == msgKey) ++count;
+            }
+            return count;
+        }
+
+        QScopedPointer<Project> mProject;
+        Board* mBoard;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(BoardDesignRuleCheckTest, testMinCopperWidth)
+{
+    int expected = mBoard->getPlanes().count();
+    foreach (const BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+        expected += netsegment->getNetLines().count();
+    }
+    Length huge(1000000000); // 1m
+    EXPECT_EQ(0, count(check(createRules(0, 0, 0, 0)), "MinCopperWidth"));
+    EXPECT_EQ(expected, count(check(createRules(0, huge, 0, 0)), "MinCopperWidth"));
+}
+
+TEST_F(BoardDesignRuleCheckTest, testMinAnnularRing)
+{
+    int expected = 0;
+    foreach (const BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+        expected += netsegment->getVias().count();
+    }
+    foreach (const BI_Device* device, mBoard->getDeviceInstances()) {
+        foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
+            if (pad->getLibPad().getBoardSide() == library::FootprintPad::BoardSide::THT) {
+                ++expected;
+            }
+        }
+    }
+    Length huge(1000000000); // 1m
+    EXPECT_EQ(0, count(check(createRules(0, 0, 0, 0)), "MinAnnularRing"));
+    EXPECT_EQ(expected, count(check(createRules(0, 0, huge, 0)), "MinAnnularRing"));
+}
+
+TEST_F(BoardDesignRuleCheckTest, testClearancesIncreaseWithRules)
+{
+    QList<int> copper, drill;
+    for (const Length& clearance : {Length(0), Length(200000), Length(100000000)}) {
+        QList<BoardDesignRuleCheck::Violation> violations =
+            check(createRules(clearance, 0, 0, clearance));
+        copper.append(count(violations, "CopperClearance"));
+        drill.append(count(violations, "DrillCopperClearance"));
+    }
+    EXPECT_LE(copper.at(0), copper.at(1));
+    EXPECT_LE(copper.at(1), copper.at(2));
+    EXPECT_LE(drill.at(0), drill.at(1));
+    EXPECT_LE(drill.at(1), drill.at(2));
+}
+
+TEST_F(BoardDesignRuleCheckTest, testViolationsAreUniqueAndStable)
+{
+    BoardDesignRules rules = createRules(Length(100000000), Length(1000000000),
+                                         Length(1000000000), Length(100000000));
+    QSet<QString> keys1, keys2;
+    foreach (const BoardDesignRuleCheck::Violation& violation, check(rules)) {
+        QString key = violation.msgKey % "/" % violation.ownerKey;
+        EXPECT_FALSE(keys1.contains(key)) << qPrintable(key);
+        keys1.insert(key);
+    }
+    foreach (const BoardDesignRuleCheck::Violation& violation, check(rules)) {
+        keys2.insert(violation.msgKey % "/" % violation.ownerKey);
+    }
+    EXPECT_EQ(keys1, keys2);
+}
+
+TEST_F(BoardDesignRuleCheckTest, testKnownViolations)
+{
+    // find net segments of two different nets
+    BI_NetSegment* segmentA = nullptr;
+    BI_NetSegment* segmentB = nullptr;
+    foreach (BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+        if (!segmentA) {
+            segmentA = netsegment;
+        } else if (&netsegment->getNetSignal() != &segmentA->getNetSignal()) {
+            segmentB = netsegment;
+            break;
+        }
+    }
+    ASSERT_TRUE(segmentA && segmentB);
+
+    // rules and violations of the existing items
+    BoardDesignRules rules = createRules(Length(300000), Length(200000), 0,
+                                         Length(500000));
+    QSet<QPair<QString, QString>> existingViolations;
+    foreach (const BoardDesignRuleCheck::Violation& violation, check(rules)) {
+        existingViolations.insert(qMakePair(violation.msgKey, violation.ownerKey));
+    }
+
+    // add items far away from the existing ones (vias: 1mm, drill 0.3mm)
+    // - via A1 and via B1 of different nets with 0.2mm copper clearance (0.55mm
+    //   drill to copper clearance, so no drill violation)
+    // - a 1mm board hole with 0.4mm clearance to via A2
+    // - a plane with a minimum width of 0.1mm (the plane and hole are owned by the
+    //   board once added)
+    QScopedPointer<CmdBoardNetSegmentAddElements> cmdA(
+        new CmdBoardNetSegmentAddElements(*segmentA));
+    BI_Via* viaA1 = cmdA->addVia(Point(1000000000, 0), BI_Via::Shape::Round,
+                                 Length(1000000), Length(300000));
+    BI_Via* viaA2 = cmdA->addVia(Point(1011400000, 0), BI_Via::Shape::Round,
+                                 Length(1000000), Length(300000));
+    cmdA->execute();
+    QScopedPointer<CmdBoardNetSegmentAddElements> cmdB(
+        new CmdBoardNetSegmentAddElements(*segmentB));
+    BI_Via* viaB1 = cmdB->addVia(Point(1001200000, 0), BI_Via::Shape::Round,
+                                 Length(1000000), Length(300000));
+    cmdB->execute();
+    BI_Hole* hole = new BI_Hole(*mBoard,
+        Hole(Uuid::createRandom(), Point(1010000000, 0), Length(1000000)));
+    CmdBoardHoleAdd(*hole).execute();
+    BI_Plane* plane = new BI_Plane(*mBoard, Uuid::createRandom(),
+        GraphicsLayer::sTopCopper, segmentA->getNetSignal(),
+        Path::rect(Point(1020000000, 0), Point(1030000000, 10000000)));
+    plane->setMinWidth(Length(100000));
+    CmdBoardPlaneAdd(*plane).execute();
+
+    // exactly these violations must be added
+    QString viaKeyA1 = viaA1->getUuid().toStr();
+    QString viaKeyB1 = viaB1->getUuid().toStr();
+    QSet<QPair<QString, QString>> expectedViolations = existingViolations;
+    expectedViolations.insert(qMakePair(QString("CopperClearance"),
+        (viaKeyA1 < viaKeyB1) ? QString("%1/%2").arg(viaKeyA1, viaKeyB1)
+                              : QString("%1/%2").arg(viaKeyB1, viaKeyA1)));
+    expectedViolations.insert(qMakePair(QString("DrillCopperClearance"),
+        QString("%1/%2").arg(hole->getHole().getUuid().toStr(),
+                             viaA2->getUuid().toStr())));
+    expectedViolations.insert(qMakePair(QString("MinCopperWidth"),
+                                        plane->getUuid().toStr()));
+    QSet<QPair<QString, QString>> actualViolations;
+    foreach (const BoardDesignRuleCheck::Violation& violation, check(rules)) {
+        actualViolations.insert(qMakePair(violation.msgKey, violation.ownerKey));
+    }
+    EXPECT_EQ(expectedViolations, actualViolations);
+}
+
+TEST_F(BoardDesignRuleCheckTest, testErcMessages)
+{
+    auto getMessages = [this](){
+        QSet<ErcMsg*> messages;
+        foreach (ErcMsg* msg, mProject->getErcMsgList().getItems()) {
+            if (&msg->getOwner() == mBoard) messages.insert(msg);
+        }
+        return messages;
+    };
+    QSet<ErcMsg*> initialMessages = getMessages(); // e.g. unplaced components
+
+    // report violations
+    mBoard->getDesignRules().setMinCopperWidth(Length(1000000000));
+    int violations = mBoard->runDesignRuleCheck();
+    QSet<ErcMsg*> messages = getMessages();
+    EXPECT_GT(violations, 0);
+    EXPECT_EQ(initialMessages.count() + violations, messages.count());
+
+    // messages of still existing violations are kept
+    EXPECT_EQ(violations, mBoard->runDesignRuleCheck());
+    EXPECT_EQ(messages, getMessages());
+
+    // messages of fixed violations are removed
+    mBoard->getDesignRules().setMinCopperWidth(Length(0));
+    mBoard->getDesignRules().setMinCopperClearance(Length(0));
+    mBoard->getDesignRules().setMinAnnularRing(Length(0));
+    mBoard->getDesignRules().setMinDrillCopperClearance(Length(0));
+    violations = mBoard->runDesignRuleCheck();
+    EXPECT_EQ(initialMessages.count() + violations, getMessages().count());
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace project
+} // namespace librepcb
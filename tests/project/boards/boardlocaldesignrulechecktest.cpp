@@ -0,0 +1,192 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boarddesignrulecheck.h>
+#include <librepcb/project/boards/boardlocaldesignrulecheck.h>
+#include <librepcb/project/boards/items/bi_netline.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardLocalDesignRuleCheckTest compares the local check of netlines with
+ *        the board-wide design rule check (using the BoardPlaneFragmentsBuilderTest
+ *        project)
+ */
+class BoardLocalDesignRuleCheckTest : public ::testing::Test
+{
+    protected:
+        BoardLocalDesignRuleCheckTest() {
+            FilePath projectFp(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest"
+                                             "/test_project/test_project.lpp");
+            mProject.reset(new Project(projectFp, true));
+            mBoard = mProject->getBoards().first();
+            mBoard->rebuildAllPlanes();
+        }
+
+        QList<const BI_NetLine*> getNetLines() const noexcept {
+            QList<const BI_NetLine*> netlines;
+            foreach (const BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+                foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
+                    netlines.append(netline);
+                }
+            }
+            return netlines;
+        }
+
+        QScopedPointer<Project> mProject;
+        Board* mBoard;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(BoardLocalDesignRuleCheckTest, testNoViolations)
+{
+    mBoard->getDesignRules().setMinCopperWidth(Length(0));
+    mBoard->getDesignRules().setMinCopperClearance(Length(0));
+    mBoard->getDesignRules().setMinAnnularRing(Length(0));
+    mBoard->getDesignRules().setMinDrillCopperClearance(Length(0));
+    BoardDesignRuleCheck boardDrc(*mBoard, mBoard->getDesignRules());
+    ASSERT_EQ(0, boardDrc.execute().count());
+    BoardLocalDesignRuleCheck drc(*mBoard);
+    QList<const BI_NetLine*> netlines = getNetLines();
+    ASSERT_FALSE(netlines.isEmpty());
+
+    // the first pass fills the geometry cache, the second pass is measured
+    for (int i = 0; i < 2; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        foreach (const BI_NetLine* netline, netlines) {
+            EXPECT_EQ(QStringList(), drc.checkNetLine(*netline));
+        }
+        qint64 nsPerCheck = timer.nsecsElapsed() / netlines.count();
+
+        // two netlines are checked on every mouse move while drawing a trace, which
+        // must not take longer than 2ms
+        if (i == 1) {
+            EXPECT_LT(nsPerCheck, 1000000);
+        }
+    }
+}
+
+TEST_F(BoardLocalDesignRuleCheckTest, testMinCopperWidth)
+{
+    mBoard->getDesignRules().setMinCopperWidth(Length(1000000000)); // 1m
+    BoardLocalDesignRuleCheck drc(*mBoard);
+    foreach (const BI_NetLine* netline, getNetLines()) {
+        EXPECT_FALSE(drc.checkNetLine(*netline).isEmpty());
+    }
+}
+
+TEST_F(BoardLocalDesignRuleCheckTest, testSameClearanceViolationsAsBoardCheck)
+{
+    // use a huge clearance to get violations for all netlines with foreign copper nearby
+    mBoard->getDesignRules().setMinCopperWidth(Length(0));
+    mBoard->getDesignRules().setMinCopperClearance(Length(100000000)); // 100mm
+    BoardDesignRuleCheck boardDrc(*mBoard, mBoard->getDesignRules());
+    QList<BoardDesignRuleCheck::Violation> violations = boardDrc.execute();
+    BoardLocalDesignRuleCheck drc(*mBoard);
+
+    // planes are not checked by the local check (they will keep clearance after the
+    // next rebuild anyway)
+    QStringList planeKeys;
+    foreach (const BI_Plane* plane, mBoard->getPlanes()) {
+        planeKeys.append(plane->getUuid().toStr());
+    }
+
+    foreach (const BI_NetLine* netline, getNetLines()) {
+        QString key = netline->getUuid().toStr();
+        bool expected = false;
+        foreach (const BoardDesignRuleCheck::Violation& violation, violations) {
+            QStringList ownerKeys = violation.ownerKey.split('/');
+            if ((violation.msgKey == "CopperClearance") && ownerKeys.contains(key)) {
+                bool withPlane = false;
+                foreach (const QString& ownerKey, ownerKeys) {
+                    withPlane = withPlane || planeKeys.contains(ownerKey);
+                }
+                expected = expected || (!withPlane);
+            }
+        }
+        EXPECT_EQ(expected, !drc.checkNetLine(*netline).isEmpty()) << qPrintable(key);
+    }
+}
+
+TEST_F(BoardLocalDesignRuleCheckTest, testPlanesAreIgnored)
+{
+    // make all netlines overlap with the (not yet rebuilt) planes
+    mBoard->getDesignRules().setMinCopperWidth(Length(0));
+    mBoard->getDesignRules().setMinCopperClearance(Length(0));
+    foreach (BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+        foreach (BI_NetLine* netline, netsegment->getNetLines()) {
+            netline->setWidth(Length(50000000)); // 50mm
+        }
+    }
+
+    // the board check reports the overlaps with the outdated planes...
+    QStringList planeDescriptions;
+    foreach (const BI_Plane* plane, mBoard->getPlanes()) {
+        planeDescriptions.append(BoardDesignRuleCheck::getDescription(*plane));
+    }
+    bool planeViolations = false;
+    BoardDesignRuleCheck boardDrc(*mBoard, mBoard->getDesignRules());
+    foreach (const BoardDesignRuleCheck::Violation& violation, boardDrc.execute()) {
+        if (violation.msgKey != "CopperClearance") continue;
+        foreach (const QString& description, planeDescriptions) {
+            planeViolations = planeViolations || violation.message.contains(description);
+        }
+    }
+    ASSERT_TRUE(planeViolations);
+
+    // ...but they are no violations since the planes will be rebuilt around the netlines
+    BoardLocalDesignRuleCheck drc(*mBoard);
+    foreach (const BI_NetLine* netline, getNetLines()) {
+        foreach (const QString& violation, drc.checkNetLine(*netline)) {
+            foreach (const QString& description, planeDescriptions) {
+                EXPECT_FALSE(violation.contains(description)) << qPrintable(violation);
+            }
+        }
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace project
+} // namespace librepcb
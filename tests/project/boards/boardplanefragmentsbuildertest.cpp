@@ -26,6 +26,13 @@
 #include <librepcb/project/project.h>
 #include <librepcb/project/boards/board.h>
 #include <librepcb/project/boards/items/bi_plane.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_via.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentaddelements.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentremove.h>
+#include <librepcb/project/boards/cmd/cmdboardviaedit.h>
+#include <librepcb/project/boards/cmd/cmddeviceinstanceedit.h>
 
 /*****************************************************************************************
  *  Namespace
@@ -47,13 +54,23 @@ namespace tests {
  */
 class BoardPlaneFragmentsBuilderTest : public ::testing::Test
 {
+    protected:
+        QMap<Uuid, QSet<Path>> getPlaneFragments(const Board& board) const noexcept {
+            QMap<Uuid, QSet<Path>> fragments;
+            foreach (const BI_Plane* plane, board.getPlanes()) {
+                foreach (const Path& fragment, plane->getFragments()) {
+                    fragments[plane->getUuid()].insert(fragment);
+                }
+            }
+            return fragments;
+        }
 };
 
 /*****************************************************************************************
  *  Test Methods
  ****************************************************************************************/
 
-TEST(BoardPlaneFragmentsBuilderTest, testFragments)
+TEST_F(BoardPlaneFragmentsBuilderTest, testFragments)
 {
     FilePath testDataDir(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest");
 
@@ -83,7 +100,7 @@ TEST(BoardPlaneFragmentsBuilderTest, testFragments)
         }
         actualSexpr.appendChild(child, true);
     }
-    FileUtils::writeFile(testDataDir.getPathTo("actual.lp"), actualSexpr.toString(0).toUtf8());
+    FileUtils::writeFile(testDataDir.getPathTo("actual.lp"), actualSexpr.toByteArray());
 
     // load expected plane fragments from file
     FilePath expectedFp = testDataDir.getPathTo("expected.lp");
@@ -100,6 +117,93 @@ TEST(BoardPlaneFragmentsBuilderTest, testFragments)
     EXPECT_EQ(expectedPlaneFragments, actualPlaneFragments);
 }
 
+TEST_F(BoardPlaneFragmentsBuilderTest, testIncrementalRebuild)
+{
+    FilePath testDataDir(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest");
+
+    // open project from test data directory
+    FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+    QScopedPointer<Project> project(new Project(projectFp, true));
+    Board* board = project->getBoards().first();
+    board->rebuildAllPlanes();
+
+    // move one via and one device, add one via and remove one net segment
+    QList<UndoCommand*> cmds;
+    foreach (BI_NetSegment* netsegment, board->getNetSegments()) {
+        if (!netsegment->getVias().isEmpty()) {
+            CmdBoardViaEdit* cmd = new CmdBoardViaEdit(*netsegment->getVias().first());
+            cmd->setDeltaToStartPos(Point(1000000, 500000), true);
+            cmds.append(cmd);
+            break;
+        }
+    }
+    if (!board->getDeviceInstances().isEmpty()) {
+        CmdDeviceInstanceEdit* cmd = new CmdDeviceInstanceEdit(*board->getDeviceInstances().first());
+        cmd->setDeltaToStartPos(Point(-2000000, 1500000), true);
+        cmd->rotate(Angle::deg90(), Point(0, 0), true);
+        cmds.append(cmd);
+    }
+    if (!board->getNetSegments().isEmpty()) {
+        CmdBoardNetSegmentAddElements* cmd =
+            new CmdBoardNetSegmentAddElements(*board->getNetSegments().first());
+        cmd->addVia(Point(3000000, 2000000), BI_Via::Shape::Round, Length(700000),
+                    Length(300000));
+        cmds.append(cmd);
+    }
+    if (board->getNetSegments().count() > 1) {
+        cmds.append(new CmdBoardNetSegmentRemove(*board->getNetSegments().last()));
+    }
+    ASSERT_EQ(4, cmds.count());
+    foreach (UndoCommand* cmd, cmds) {
+        cmd->execute();
+    }
+
+    // incremental rebuild must lead to the same result as a full rebuild
+    board->rebuildDirtyPlanes();
+    board->waitForPlanesRebuild();
+    QMap<Uuid, QSet<Path>> incrementalFragments = getPlaneFragments(*board);
+    board->rebuildAllPlanes();
+    EXPECT_EQ(getPlaneFragments(*board), incrementalFragments);
+
+    // same after undo (in reverse order, like the undo stack does)
+    for (int i = cmds.count() - 1; i >= 0; --i) {
+        cmds.at(i)->undo();
+    }
+    board->rebuildDirtyPlanes();
+    board->waitForPlanesRebuild();
+    incrementalFragments = getPlaneFragments(*board);
+    board->rebuildAllPlanes();
+    EXPECT_EQ(getPlaneFragments(*board), incrementalFragments);
+
+    qDeleteAll(cmds);
+}
+
+TEST_F(BoardPlaneFragmentsBuilderTest, testModifyPlanesDuringRebuild)
+{
+    FilePath testDataDir(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest");
+
+    // open project from test data directory
+    FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+    QScopedPointer<Project> project(new Project(projectFp, true));
+    Board* board = project->getBoards().first();
+    board->rebuildAllPlanes();
+    QMap<Uuid, QSet<Path>> fragments = getPlaneFragments(*board);
+    ASSERT_FALSE(fragments.isEmpty());
+
+    // a running rebuild must only work on the snapshot taken when it was started
+    board->invalidatePlanes(QRectF(-1e6, -1e6, 2e6, 2e6));
+    board->rebuildDirtyPlanes();
+    foreach (BI_Plane* plane, board->getPlanes()) {
+        plane->setMinWidth(Length::fromMm(1000)); // no fragment is that wide
+    }
+    board->waitForPlanesRebuild();
+    EXPECT_EQ(fragments, getPlaneFragments(*board));
+
+    // the next rebuild takes the modifications into account
+    board->rebuildAllPlanes();
+    EXPECT_TRUE(getPlaneFragments(*board).isEmpty());
+}
+
 /*****************************************************************************************
  *  End of File
  ****************************************************************************************/
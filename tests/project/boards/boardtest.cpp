@@ -0,0 +1,191 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/utils/clipperhelpers.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardgeometrycache.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_footprint.h>
+#include <librepcb/project/boards/items/bi_footprintpad.h>
+#include <librepcb/project/boards/items/bi_netsegment.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+#include <librepcb/project/boards/items/bi_via.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentaddelements.h>
+#include <librepcb/project/boards/cmd/cmdboardnetsegmentremoveelements.h>
+#include <librepcb/project/boards/cmd/cmdboardviaedit.h>
+#include <librepcb/project/boards/cmd/cmddeviceinstanceedit.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The BoardTest checks the general behaviour of boards (using the
+ *        BoardPlaneFragmentsBuilderTest project)
+ */
+class BoardTest : public ::testing::Test
+{
+    protected:
+        BoardTest() {
+            FilePath projectFp(TEST_DATA_DIR "/project/boards/BoardPlaneFragmentsBuilderTest"
+                                             "/test_project/test_project.lpp");
+            mProject.reset(new Project(projectFp, true));
+            mBoard = mProject->getBoards().first();
+        }
+
+        QMap<Uuid, QSet<Path>> getPlaneFragments() const noexcept {
+            QMap<Uuid, QSet<Path>> fragments;
+            foreach (const BI_Plane* plane, mBoard->getPlanes()) {
+                foreach (const Path& fragment, plane->getFragments()) {
+                    fragments[plane->getUuid()].insert(fragment);
+                }
+            }
+            return fragments;
+        }
+
+        void expectGeometryCacheUpToDate() const noexcept {
+            Length expansion(150000);
+            Length tolerance(5000);
+            BoardGeometryCache& cache = mBoard->getGeometryCache();
+            foreach (const BI_NetSegment* netsegment, mBoard->getNetSegments()) {
+                foreach (const BI_Via* via, netsegment->getVias()) {
+                    ClipperLib::Path outline = ClipperHelpers::convert(
+                        via->getSceneOutline(expansion), tolerance);
+                    EXPECT_EQ(outline, cache.getViaOutline(*via, expansion, tolerance));
+                }
+            }
+            foreach (const BI_Device* device, mBoard->getDeviceInstances()) {
+                foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
+                    ClipperLib::Path outline = ClipperHelpers::convert(
+                        pad->getSceneOutline(expansion), tolerance);
+                    EXPECT_EQ(outline, cache.getPadOutline(*pad, expansion, tolerance));
+                }
+            }
+        }
+
+        QScopedPointer<Project> mProject;
+        Board* mBoard;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(BoardTest, testLazyActivation)
+{
+    // inactive boards neither contain plane fragments nor populate the graphics scene
+    int sceneItemsCount = mBoard->getGraphicsScene().items().count();
+    EXPECT_FALSE(mBoard->isActivated());
+    EXPECT_TRUE(getPlaneFragments().isEmpty());
+
+    // activation builds everything needed to display the board
+    mBoard->activate();
+    EXPECT_TRUE(mBoard->isActivated());
+    EXPECT_GT(mBoard->getGraphicsScene().items().count(), sceneItemsCount);
+    QMap<Uuid, QSet<Path>> activatedFragments = getPlaneFragments();
+    EXPECT_FALSE(activatedFragments.isEmpty());
+    mBoard->rebuildAllPlanes();
+    EXPECT_EQ(getPlaneFragments(), activatedFragments);
+}
+
+TEST_F(BoardTest, testGeometryCacheIsInvalidatedOnModifications)
+{
+    ASSERT_FALSE(mBoard->getNetSegments().isEmpty());
+    ASSERT_FALSE(mBoard->getDeviceInstances().isEmpty());
+    BI_NetSegment* netsegment = mBoard->getNetSegments().first();
+    expectGeometryCacheUpToDate(); // fill the cache
+
+    // edit a via and a device
+    QList<UndoCommand*> cmds;
+    foreach (BI_NetSegment* segment, mBoard->getNetSegments()) {
+        if (!segment->getVias().isEmpty()) {
+            CmdBoardViaEdit* cmd = new CmdBoardViaEdit(*segment->getVias().first());
+            cmd->setDeltaToStartPos(Point(1000000, 500000), true);
+            cmd->setSize(Length(1500000), true);
+            cmds.append(cmd);
+            break;
+        }
+    }
+    CmdDeviceInstanceEdit* cmdDevEdit =
+        new CmdDeviceInstanceEdit(*mBoard->getDeviceInstances().first());
+    cmdDevEdit->setDeltaToStartPos(Point(-2000000, 1500000), true);
+    cmdDevEdit->rotate(Angle::deg90(), Point(0, 0), true);
+    cmds.append(cmdDevEdit);
+    ASSERT_EQ(2, cmds.count());
+    foreach (UndoCommand* cmd, cmds) {
+        cmd->execute();
+        expectGeometryCacheUpToDate();
+    }
+
+    // add a via
+    CmdBoardNetSegmentAddElements* cmdAdd = new CmdBoardNetSegmentAddElements(*netsegment);
+    BI_Via* via = cmdAdd->addVia(Point(3000000, 2000000), BI_Via::Shape::Round,
+                                 Length(700000), Length(300000));
+    cmds.append(cmdAdd);
+    cmdAdd->execute();
+    expectGeometryCacheUpToDate();
+
+    // remove the added via (and add it again at another position)
+    CmdBoardNetSegmentRemoveElements* cmdRemove =
+        new CmdBoardNetSegmentRemoveElements(*netsegment);
+    cmdRemove->removeVia(*via);
+    cmds.append(cmdRemove);
+    cmdRemove->execute();
+    expectGeometryCacheUpToDate();
+    cmdRemove->undo();
+    expectGeometryCacheUpToDate();
+    CmdBoardViaEdit* cmdViaEdit = new CmdBoardViaEdit(*via);
+    cmdViaEdit->setPosition(Point(-3000000, 4000000), true);
+    cmdViaEdit->setShape(BI_Via::Shape::Octagon, true);
+    cmdViaEdit->execute();
+    expectGeometryCacheUpToDate();
+    cmdViaEdit->undo();
+    delete cmdViaEdit;
+    cmdRemove->redo();
+    expectGeometryCacheUpToDate();
+
+    // undo everything (in reverse order, like the undo stack does)
+    for (int i = cmds.count() - 1; i >= 0; --i) {
+        cmds.at(i)->undo();
+        expectGeometryCacheUpToDate();
+    }
+    qDeleteAll(cmds);
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace project
+} // namespace librepcb
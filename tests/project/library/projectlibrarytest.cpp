@@ -0,0 +1,144 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <gtest/gtest.h>
+#include <librepcb/common/scopeguard.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/library/elements.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/library/projectlibrary.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The ProjectLibraryTest checks the (parallel) loading of the project library
+ *        (using the BoardPlaneFragmentsBuilderTest project)
+ */
+class ProjectLibraryTest : public ::testing::Test
+{
+    protected:
+
+        ProjectLibraryTest() {
+            mProjectDir = FilePath(TEST_DATA_DIR "/project/boards/"
+                                   "BoardPlaneFragmentsBuilderTest/test_project");
+            mTempDir = FilePath::getRandomTempPath();
+        }
+
+        virtual ~ProjectLibraryTest() {
+            QDir(mTempDir.toStr()).removeRecursively();
+        }
+
+        static FilePath getProjectFile(const FilePath& dir) noexcept {
+            return dir.getPathTo("test_project.lpp");
+        }
+
+        /// UUID -> (version, directory relative to the project) of all elements
+        template <typename ElementType>
+        static QMap<Uuid, QPair<QString, QString>> getElements(
+                const Project& project, const QHash<Uuid, ElementType*>& elements) {
+            QMap<Uuid, QPair<QString, QString>> result;
+            foreach (const ElementType* element, elements) {
+                EXPECT_EQ(element->thread(), QThread::currentThread());
+                result.insert(element->getUuid(), qMakePair(
+                    element->getVersion().toStr(),
+                    element->getFilePath().toRelative(project.getPath())));
+            }
+            return result;
+        }
+
+        FilePath mProjectDir;
+        FilePath mTempDir;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(ProjectLibraryTest, testParallelLoadEqualsSequentialLoad)
+{
+    // load in parallel
+    QScopedPointer<Project> parallel(new Project(getProjectFile(mProjectDir), true));
+    const ProjectLibrary& parallelLib = parallel->getLibrary();
+    EXPECT_FALSE(parallelLib.getSymbols().isEmpty());
+    EXPECT_FALSE(parallelLib.getPackages().isEmpty());
+    EXPECT_FALSE(parallelLib.getComponents().isEmpty());
+    EXPECT_FALSE(parallelLib.getDevices().isEmpty());
+
+    // load sequentially (only one element at a time in the thread pool)
+    int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    auto threadCountGuard = scopeGuard([maxThreadCount](){
+        QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+    });
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    QScopedPointer<Project> sequential(new Project(getProjectFile(mProjectDir), true));
+    const ProjectLibrary& sequentialLib = sequential->getLibrary();
+
+    EXPECT_EQ(getElements(*sequential, sequentialLib.getSymbols()),
+              getElements(*parallel, parallelLib.getSymbols()));
+    EXPECT_EQ(getElements(*sequential, sequentialLib.getPackages()),
+              getElements(*parallel, parallelLib.getPackages()));
+    EXPECT_EQ(getElements(*sequential, sequentialLib.getComponents()),
+              getElements(*parallel, parallelLib.getComponents()));
+    EXPECT_EQ(getElements(*sequential, sequentialLib.getDevices()),
+              getElements(*parallel, parallelLib.getDevices()));
+    EXPECT_EQ(sequential->getSchematics().count(), parallel->getSchematics().count());
+    EXPECT_EQ(sequential->getBoards().count(), parallel->getBoards().count());
+}
+
+TEST_F(ProjectLibraryTest, testParseErrorInElementIsReported)
+{
+    // copy the project and corrupt one of its components
+    FilePath projectDir = mTempDir.getPathTo("test_project");
+    FileUtils::copyDirRecursively(mProjectDir, projectDir);
+    QString cmpDir;
+    {
+        Project project(getProjectFile(projectDir), true);
+        ASSERT_FALSE(project.getLibrary().getComponents().isEmpty());
+        cmpDir = project.getLibrary().getComponents().values().first()->getFilePath()
+                 .toRelative(projectDir);
+    }
+    FilePath cmpFile = projectDir.getPathTo(cmpDir).getPathTo(
+        library::Component::getLongElementName() % ".lp");
+    ASSERT_TRUE(cmpFile.isExistingFile());
+    FileUtils::writeFile(cmpFile, "(librepcb_component"); // can't be parsed
+
+    // all other elements are still loaded in parallel, but opening the project fails
+    EXPECT_THROW(Project(getProjectFile(projectDir), true), Exception);
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace project
+} // namespace librepcb
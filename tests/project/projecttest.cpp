@@ -23,8 +23,12 @@
 #include <QtCore>
 #include <gtest/gtest.h>
 #include <librepcb/common/systeminfo.h>
+#include <librepcb/common/gridproperties.h>
+#include <librepcb/common/fileio/fileutils.h>
 #include <librepcb/project/project.h>
 #include <librepcb/project/metadata/projectmetadata.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/schematics/schematic.h>
 
 /*****************************************************************************************
  *  Namespace
@@ -129,6 +133,47 @@ TEST_F(ProjectTest, testSave)
     project.reset(new Project(mProjectFile, false));
 }
 
+TEST_F(ProjectTest, testSaveOnlyRewritesModifiedFiles)
+{
+    // copy a project with a schematic and a board to the temporary directory
+    FileUtils::copyDirRecursively(FilePath(TEST_DATA_DIR "/project/boards/"
+        "BoardPlaneFragmentsBuilderTest/test_project"), mProjectDir);
+    QScopedPointer<Project> project(new Project(
+        mProjectDir.getPathTo("test_project.lpp"), false));
+    ASSERT_FALSE(project->getSchematics().isEmpty());
+    ASSERT_FALSE(project->getBoards().isEmpty());
+    FilePath schematicFp = project->getSchematics().first()->getFilePath();
+    FilePath boardFp = project->getBoards().first()->getFilePath();
+    project->save(true);
+    QByteArray schematicContent = FileUtils::readFile(schematicFp);
+    QByteArray boardContent = FileUtils::readFile(boardFp);
+    QDateTime schematicModified = QFileInfo(schematicFp.toStr()).lastModified();
+    QDateTime boardModified = QFileInfo(boardFp.toStr()).lastModified();
+
+    // saving again must not touch unchanged files
+    QThread::msleep(1100); // make sure a rewrite would change the modification time
+    project->save(true);
+    EXPECT_EQ(schematicModified, QFileInfo(schematicFp.toStr()).lastModified());
+    EXPECT_EQ(boardModified, QFileInfo(boardFp.toStr()).lastModified());
+
+    // files modified by another application must be rewritten, even if their size
+    // did not change
+    QByteArray modifiedContent = boardContent;
+    modifiedContent[modifiedContent.indexOf('(') + 1] = 'X';
+    FileUtils::writeFile(boardFp, modifiedContent);
+    project->save(true);
+    EXPECT_EQ(boardContent, FileUtils::readFile(boardFp));
+    EXPECT_EQ(schematicModified, QFileInfo(schematicFp.toStr()).lastModified());
+
+    // modifications made without undo commands must be saved as well
+    GridProperties grid = project->getBoards().first()->getGridProperties();
+    grid.setInterval(grid.getInterval() * 2);
+    project->getBoards().first()->setGridProperties(grid);
+    project->save(true);
+    EXPECT_NE(boardContent, FileUtils::readFile(boardFp));
+    EXPECT_EQ(schematicContent, FileUtils::readFile(schematicFp));
+}
+
 TEST_F(ProjectTest, testIfLastModifiedDateTimeIsUpdatedOnSave)
 {
     // create new project
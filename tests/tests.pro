@@ -67,8 +67,12 @@ SOURCES += \
     common/attributes/attributesubstitutortest.cpp \
     common/directorylocktest.cpp \
     common/filedownloadtest.cpp \
+    common/fileio/asyncfilewritertest.cpp \
     common/fileio/serializableobjectlisttest.cpp \
+    common/fileio/sexpressioncachetest.cpp \
+    common/fileio/sexpressiontest.cpp \
     common/filepathtest.cpp \
+    common/geometry/pointinpolygonindextest.cpp \
     common/networkrequesttest.cpp \
     common/pointtest.cpp \
     common/ratiotest.cpp \
@@ -76,21 +80,32 @@ SOURCES += \
     common/sqlitedatabasetest.cpp \
     common/systeminfotest.cpp \
     common/toolboxtest.cpp \
+    common/utils/rtreetest.cpp \
     common/uuidtest.cpp \
     common/versiontest.cpp \
     eagleimport/deviceconvertertest.cpp \
     eagleimport/devicesetconvertertest.cpp \
     eagleimport/packageconvertertest.cpp \
     eagleimport/symbolconvertertest.cpp \
+    library/librarybaseelementtest.cpp \
     main.cpp \
+    project/boards/boardairwiresbuildertest.cpp \
+    project/boards/boarddesignrulechecktest.cpp \
+    project/boards/boardlocaldesignrulechecktest.cpp \
     project/boards/boardplanefragmentsbuildertest.cpp \
+    project/boards/boardtest.cpp \
+    project/library/projectlibrarytest.cpp \
     project/projecttest.cpp \
+    workspace/library/workspacelibrarydbtest.cpp \
+    workspace/library/workspacelibraryscannertest.cpp \
+    workspace/library/workspacelibrarysearchtest.cpp \
     workspace/workspacetest.cpp \
 
 HEADERS += \
     common/attributes/attributeproviderdummy.h \
     common/fileio/serializableobjectmock.h \
     common/networkrequestbasesignalreceiver.h \
+    workspace/library/workspacelibrarydbfixture.h \
 
 FORMS += \
 
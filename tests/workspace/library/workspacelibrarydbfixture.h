@@ -0,0 +1,165 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKSPACELIBRARYDBFIXTURE_H
+#define WORKSPACELIBRARYDBFIXTURE_H
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+
+#include <QtCore>
+#include <QtSql>
+#include <gtest/gtest.h>
+#include <librepcb/common/sqlitedatabase.h>
+#include <librepcb/common/uuid.h>
+#include <librepcb/workspace/workspace.h>
+#include <librepcb/workspace/library/workspacelibrarydb.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+/*****************************************************************************************
+ *  Class WorkspaceLibraryDbFixture
+ ****************************************************************************************/
+
+/**
+ * @brief Test fixture with a new workspace whose library database is filled directly
+ *        with SQL, so no library elements are needed
+ *
+ * The database contains some resistors and a capacitor, tests can add more elements
+ * with the helper methods.
+ */
+class WorkspaceLibraryDbFixture : public ::testing::Test
+{
+    protected:
+
+        struct Translation {
+            QString locale;
+            QString name;
+            QString keywords;
+        };
+
+        WorkspaceLibraryDbFixture() {
+            mWsDir = FilePath::getRandomTempPath().getPathTo("test workspace dir");
+            Workspace::createNewWorkspace(mWsDir);
+            mWs.reset(new Workspace(mWsDir));
+            mDb.reset(new SQLiteDatabase(mWs->getLibraryDb().getFilePath()));
+
+            // locale '' is the default locale (en_US)
+            mResistor0805 = addComponent({{"", "Resistor 0805", "smd,passive"}});
+            mCapacitor0805 = addComponent({{"", "Capacitor 0805", "smd,passive"},
+                                           {"de_CH", "Kondensator 0805", "smd,passiv"}});
+            mResistorTht = addComponent({{"", "Resistor THT", "passive"}});
+            mResistorArray = addComponent({{"", "Widerstand Array", ""},
+                                           {"de_CH", "Resistor Array", ""}});
+        }
+
+        virtual ~WorkspaceLibraryDbFixture() {
+            mDb.reset();
+            mWs.reset();
+            QDir(mWsDir.getParentDir().toStr()).removeRecursively();
+        }
+
+        Uuid addComponent(const QList<Translation>& translations,
+                          const Uuid& uuid = Uuid::createRandom(),
+                          const QString& version = "0.1") {
+            int id = addElement("components", uuid, version);
+            addTranslations("components", "component_id", id, translations);
+            return uuid;
+        }
+
+        Uuid addPackage(const QList<Translation>& translations) {
+            Uuid uuid = Uuid::createRandom();
+            int id = addElement("packages", uuid, "0.1");
+            addTranslations("packages", "package_id", id, translations);
+            return uuid;
+        }
+
+        void addDevice(const Uuid& component, const QString& name,
+                       const QString& keywords = QString(),
+                       const Uuid& package = Uuid::createRandom()) {
+            Uuid uuid = Uuid::createRandom();
+            QSqlQuery query = mDb->prepareQuery(
+                "INSERT INTO devices "
+                "(lib_id, filepath, uuid, version, component_uuid, package_uuid, "
+                "file_modified, file_size, file_hash) "
+                "VALUES (1, :filepath, :uuid, '0.1', :component, :package, 0, 0, '')");
+            query.bindValue(":filepath", getFilePath("devices", uuid, "0.1"));
+            query.bindValue(":uuid", uuid.toStr());
+            query.bindValue(":component", component.toStr());
+            query.bindValue(":package", package.toStr());
+            int id = mDb->insert(query);
+            addTranslations("devices", "device_id", id, {{"", name, keywords}});
+        }
+
+        int addElement(const QString& table, const Uuid& uuid, const QString& version) {
+            QSqlQuery query = mDb->prepareQuery(
+                "INSERT INTO " % table % " "
+                "(lib_id, filepath, uuid, version, file_modified, file_size, file_hash) "
+                "VALUES (1, :filepath, :uuid, :version, 0, 0, '')");
+            query.bindValue(":filepath", getFilePath(table, uuid, version));
+            query.bindValue(":uuid", uuid.toStr());
+            query.bindValue(":version", version);
+            return mDb->insert(query);
+        }
+
+        void addTranslations(const QString& table, const QString& idColumn, int id,
+                             const QList<Translation>& translations) {
+            foreach (const Translation& translation, translations) {
+                QSqlQuery query = mDb->prepareQuery(
+                    "INSERT INTO " % table % "_tr "
+                    "(" % idColumn % ", locale, name, keywords) "
+                    "VALUES (:id, :locale, :name, :keywords)");
+                query.bindValue(":id", id);
+                query.bindValue(":locale", translation.locale);
+                query.bindValue(":name", translation.name);
+                query.bindValue(":keywords", translation.keywords);
+                mDb->insert(query);
+            }
+        }
+
+        /// The file path of an element (relative to the libraries directory)
+        static QString getFilePath(const QString& table, const Uuid& uuid,
+                                   const QString& version) noexcept {
+            return table % "/" % uuid.toStr() % "_" % version;
+        }
+
+        FilePath mWsDir;
+        QScopedPointer<Workspace> mWs;
+        QScopedPointer<SQLiteDatabase> mDb;
+        Uuid mResistor0805;
+        Uuid mCapacitor0805;
+        Uuid mResistorTht;
+        Uuid mResistorArray;
+};
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace workspace
+} // namespace librepcb
+
+#endif // WORKSPACELIBRARYDBFIXTURE_H
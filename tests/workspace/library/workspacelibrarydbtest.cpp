@@ -0,0 +1,183 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtSql>
+#include <gtest/gtest.h>
+#include "workspacelibrarydbfixture.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The WorkspaceLibraryDbTest checks the component search of the workspace
+ *        library database
+ *
+ * Both the full text search and the LIKE fallback are tested with the same content
+ * (see librepcb::workspace::tests::WorkspaceLibraryDbFixture), the fallback is also
+ * tested if the SQLite library supports FTS5.
+ */
+class WorkspaceLibraryDbTest : public WorkspaceLibraryDbFixture
+{
+    protected:
+
+        WorkspaceLibraryDbTest() {
+            mDiode = addComponent({{"", "Diode", "semiconductor"}});
+            addDevice(mDiode, "Zener Diode 5V1", "z-diode");
+        }
+
+        /// Same query as WorkspaceLibraryDb::getComponentsBySearchKeyword()
+        QList<Uuid> search(bool fullTextSearch, const QString& keyword,
+                           const QStringList& localeOrder = QStringList()) {
+            QSqlQuery query = mDb->prepareQuery(
+                "SELECT matches.uuid FROM (" %
+                WorkspaceLibraryDb::getComponentMatchesSql(fullTextSearch,
+                                                           localeOrder.count()) %
+                ") AS matches ORDER BY matches.locale_rank, matches.score");
+            WorkspaceLibraryDb::bindComponentMatchesSql(query, fullTextSearch, keyword,
+                                                        localeOrder);
+            mDb->exec(query);
+            QList<Uuid> uuids;
+            while (query.next()) {
+                uuids.append(Uuid(query.value(0).toString()));
+            }
+            return uuids;
+        }
+
+        bool isFullTextSearchAvailable() {
+            if (!mWs->getLibraryDb().isFullTextSearchAvailable()) {
+                RecordProperty("skipped", "FTS5 is not available in this SQLite library");
+                return false;
+            }
+            return true;
+        }
+
+        static QSet<Uuid> toSet(const QList<Uuid>& list) noexcept {
+            return QSet<Uuid>::fromList(list);
+        }
+
+        Uuid mDiode;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(WorkspaceLibraryDbTest, testGetComponentsBySearchKeyword)
+{
+    // these keywords give the same result with and without full text search index
+    WorkspaceLibraryDb& db = mWs->getLibraryDb();
+    EXPECT_EQ(QList<Uuid>(), db.getComponentsBySearchKeyword("   "));
+    EXPECT_EQ(QList<Uuid>(), db.getComponentsBySearchKeyword("inductor"));
+    EXPECT_EQ(QSet<Uuid>({mResistor0805, mCapacitor0805}),
+              toSet(db.getComponentsBySearchKeyword("0805")));
+    EXPECT_EQ(QSet<Uuid>({mResistor0805, mResistorTht, mResistorArray}),
+              toSet(db.getComponentsBySearchKeyword(" Resistor ")));
+    EXPECT_EQ(QList<Uuid>{mDiode}, db.getComponentsBySearchKeyword("zener"));
+}
+
+TEST_F(WorkspaceLibraryDbTest, testFullTextSearchMultiWordPrefix)
+{
+    if (!isFullTextSearchAvailable()) return;
+    EXPECT_EQ(mWs->getLibraryDb().getComponentsBySearchKeyword("res 08"),
+              search(true, "res 08"));
+    EXPECT_EQ(QList<Uuid>{mResistor0805}, search(true, "res 08"));
+    EXPECT_EQ(QList<Uuid>{mResistor0805}, search(true, "08 RES"));
+    EXPECT_EQ(QSet<Uuid>({mResistor0805, mCapacitor0805}), toSet(search(true, "smd pass")));
+    EXPECT_EQ(QList<Uuid>{mDiode}, search(true, "z diode"));
+    EXPECT_EQ(QList<Uuid>(), search(true, "sistor")); // only prefixes match
+    EXPECT_EQ(QList<Uuid>(), search(true, "res tht 08"));
+    EXPECT_EQ(QList<Uuid>(), search(true, "\"res\" OR NOT")); // no FTS5 syntax
+}
+
+TEST_F(WorkspaceLibraryDbTest, testFullTextSearchLocaleRanking)
+{
+    if (!isFullTextSearchAvailable()) return;
+    QList<Uuid> resistors = search(true, "resistor", {"de_CH"});
+    ASSERT_EQ(3, resistors.count());
+    EXPECT_EQ(mResistorArray, resistors.first()); // matches in de_CH
+    resistors = search(true, "resistor");
+    ASSERT_EQ(3, resistors.count());
+    EXPECT_EQ(mResistorArray, resistors.last()); // doesn't match in default locale
+    resistors = search(true, "resistor", {"fr_FR", "de_CH"});
+    ASSERT_EQ(3, resistors.count());
+    EXPECT_EQ(mResistorArray, resistors.first());
+}
+
+TEST_F(WorkspaceLibraryDbTest, testLikeFallback)
+{
+    EXPECT_EQ(QList<Uuid>(), search(false, "res 08")); // no prefix matching
+    EXPECT_EQ(QList<Uuid>{mResistor0805}, search(false, "sistor 08")); // substring
+    EXPECT_EQ(QList<Uuid>{mResistor0805}, search(false, "  RESISTOR 0805 "));
+    EXPECT_EQ(QSet<Uuid>({mResistor0805, mCapacitor0805}), toSet(search(false, "smd")));
+    EXPECT_EQ(QList<Uuid>{mDiode}, search(false, "5V1")); // device name
+    EXPECT_EQ(QList<Uuid>{mCapacitor0805}, search(false, "kondensator"));
+    QList<Uuid> resistors = search(false, "resistor", {"de_CH"});
+    ASSERT_EQ(3, resistors.count());
+    EXPECT_EQ(mResistorArray, resistors.first());
+    resistors = search(false, "resistor");
+    ASSERT_EQ(3, resistors.count());
+    EXPECT_EQ(mResistorArray, resistors.last());
+}
+
+TEST_F(WorkspaceLibraryDbTest, testFullTextSearchIndexFollowsTranslations)
+{
+    if (!isFullTextSearchAvailable()) return;
+
+    // insert
+    Uuid inductor = addComponent({{"", "Inductor 0805", "coil"}});
+    EXPECT_EQ(QList<Uuid>{inductor}, search(true, "coil"));
+
+    // update
+    mDb->exec("UPDATE components_tr SET name = 'Choke 0805', keywords = 'ferrite' "
+              "WHERE name = 'Inductor 0805'");
+    EXPECT_EQ(QList<Uuid>(), search(true, "induct"));
+    EXPECT_EQ(QList<Uuid>(), search(true, "coil"));
+    EXPECT_EQ(QList<Uuid>{inductor}, search(true, "choke"));
+    EXPECT_EQ(QList<Uuid>{inductor}, search(true, "ferr"));
+    mDb->exec("UPDATE devices_tr SET name = 'Schottky Diode'");
+    EXPECT_EQ(QList<Uuid>(), search(true, "zener"));
+    EXPECT_EQ(QList<Uuid>{mDiode}, search(true, "schottky"));
+
+    // delete
+    mDb->exec("DELETE FROM components_tr WHERE name = 'Choke 0805'");
+    EXPECT_EQ(QList<Uuid>(), search(true, "choke"));
+    mDb->exec("DELETE FROM devices_tr");
+    EXPECT_EQ(QList<Uuid>(), search(true, "schottky"));
+    EXPECT_EQ(QList<Uuid>{mDiode}, search(true, "diode")); // component name
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace workspace
+} // namespace librepcb
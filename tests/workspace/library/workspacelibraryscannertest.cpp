@@ -0,0 +1,308 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtSql>
+#include <gtest/gtest.h>
+#include <librepcb/common/scopeguard.h>
+#include <librepcb/common/sqlitedatabase.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/library/library.h>
+#include <librepcb/library/cat/componentcategory.h>
+#include <librepcb/library/sym/symbol.h>
+#include <librepcb/workspace/workspace.h>
+#include <librepcb/workspace/library/workspacelibrarydb.h>
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+using namespace library;
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The WorkspaceLibraryScannerTest checks the incremental library scan by
+ *        comparing the content of the library database with the files on disk
+ */
+class WorkspaceLibraryScannerTest : public ::testing::Test
+{
+    protected:
+
+        /// A row of the symbols table (with the en_US name joined)
+        struct DbSymbol {
+            int id;
+            qint64 modified;
+            qint64 size;
+            QString name;
+        };
+
+        WorkspaceLibraryScannerTest() {
+            mWsDir = FilePath::getRandomTempPath().getPathTo("test workspace dir");
+            Workspace::createNewWorkspace(mWsDir);
+            mWs.reset(new Workspace(mWsDir));
+            mLibDir = mWs->getLibrariesPath().getPathTo("local/Test.lplib");
+            Library lib(Uuid::createRandom(), Version("0.1"), "test", "Test Library", "", "");
+            lib.saveTo(mLibDir);
+            reopenWorkspace(); // load the library without triggering a scan
+        }
+
+        virtual ~WorkspaceLibraryScannerTest() {
+            mWs.reset();
+            QDir(mWsDir.getParentDir().toStr()).removeRecursively();
+        }
+
+        void reopenWorkspace() {
+            mWs.reset(); // release the workspace lock first
+            mWs.reset(new Workspace(mWsDir));
+        }
+
+        Uuid addComponentCategory(const QString& name) {
+            ComponentCategory category(Uuid::createRandom(), Version("0.1"), "test", name,
+                                       "", "");
+            category.saveIntoParentDirectory(mLibDir.getPathTo("cmpcat"));
+            return category.getUuid();
+        }
+
+        Uuid addSymbol(const QString& name, const QSet<Uuid>& categories = QSet<Uuid>()) {
+            Symbol symbol(Uuid::createRandom(), Version("0.1"), "test", name, "", "");
+            symbol.setCategories(categories);
+            symbol.saveIntoParentDirectory(mLibDir.getPathTo("sym"));
+            return symbol.getUuid();
+        }
+
+        FilePath getSymbolFilePath(const Uuid& uuid) const noexcept {
+            return mLibDir.getPathTo("sym").getPathTo(uuid.toStr()).getPathTo("symbol.lp");
+        }
+
+        int scan() {
+            int elementCount = -1;
+            bool finished = false;
+            QObject context;
+            QObject::connect(&mWs->getLibraryDb(), &WorkspaceLibraryDb::scanSucceeded,
+                             &context, [&](int count){elementCount = count; finished = true;});
+            QObject::connect(&mWs->getLibraryDb(), &WorkspaceLibraryDb::scanFailed,
+                             &context, [&](QString errorMsg){
+                ADD_FAILURE() << "Library scan failed: " << qPrintable(errorMsg);
+                finished = true;
+            });
+            mWs->getLibraryDb().startLibraryRescan();
+
+            // wait until the scan finished (with timeout)
+            qint64 start = QDateTime::currentDateTime().toMSecsSinceEpoch();
+            auto currentTime = [](){return QDateTime::currentDateTime().toMSecsSinceEpoch();};
+            while ((!finished) && (currentTime() - start < 30000)) {
+                QThread::msleep(10);
+                qApp->processEvents();
+            }
+            EXPECT_TRUE(finished) << "Library scan timed out!";
+            return elementCount;
+        }
+
+        QHash<Uuid, DbSymbol> getSymbolsFromDb() const {
+            SQLiteDatabase db(mWs->getLibraryDb().getFilePath());
+            QSqlQuery query = db.prepareQuery(
+                "SELECT symbols.id, symbols.uuid, symbols.file_modified, symbols.file_size, "
+                "symbols_tr.name FROM symbols "
+                "LEFT JOIN symbols_tr ON symbols_tr.symbol_id = symbols.id "
+                "AND symbols_tr.locale = 'en_US'");
+            db.exec(query);
+            QHash<Uuid, DbSymbol> symbols;
+            while (query.next()) {
+                symbols.insert(Uuid(query.value(1).toString()),
+                               DbSymbol{query.value(0).toInt(), query.value(2).toLongLong(),
+                                        query.value(3).toLongLong(),
+                                        query.value(4).toString()});
+            }
+            return symbols;
+        }
+
+        int getRowCount(const QString& table) const {
+            SQLiteDatabase db(mWs->getLibraryDb().getFilePath());
+            QSqlQuery query = db.prepareQuery("SELECT COUNT(*) FROM " % table);
+            db.exec(query);
+            return query.next() ? query.value(0).toInt() : -1;
+        }
+
+        QList<QVariantList> getTableContentFromDb(const QString& table) const {
+            SQLiteDatabase db(mWs->getLibraryDb().getFilePath());
+            QSqlQuery query = db.prepareQuery("SELECT * FROM " % table % " ORDER BY id");
+            db.exec(query);
+            QList<QVariantList> rows;
+            while (query.next()) {
+                QVariantList row;
+                for (int i = 0; i < query.record().count(); ++i) {
+                    row.append(query.value(i));
+                }
+                rows.append(row);
+            }
+            return rows;
+        }
+
+        void execInDb(const QString& sql) const {
+            SQLiteDatabase db(mWs->getLibraryDb().getFilePath());
+            db.exec(sql);
+        }
+
+        FilePath mWsDir;
+        FilePath mLibDir;
+        QScopedPointer<Workspace> mWs;
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(WorkspaceLibraryScannerTest, testNewElementIsInserted)
+{
+    Uuid uuid1 = addSymbol("Symbol 1");
+    EXPECT_EQ(1, scan());
+    EXPECT_EQ(1, getRowCount("libraries"));
+    EXPECT_EQ(QList<Uuid>{uuid1}, getSymbolsFromDb().keys());
+
+    Uuid uuid2 = addSymbol("Symbol 2");
+    EXPECT_EQ(2, scan());
+    QHash<Uuid, DbSymbol> symbols = getSymbolsFromDb();
+    EXPECT_EQ(2, symbols.count());
+    EXPECT_EQ("Symbol 1", symbols.value(uuid1).name.toStdString());
+    EXPECT_EQ("Symbol 2", symbols.value(uuid2).name.toStdString());
+    QFileInfo info(getSymbolFilePath(uuid2).toStr());
+    EXPECT_EQ(info.lastModified().toMSecsSinceEpoch(), symbols.value(uuid2).modified);
+    EXPECT_EQ(info.size(), symbols.value(uuid2).size);
+}
+
+TEST_F(WorkspaceLibraryScannerTest, testModifiedElementIsUpdated)
+{
+    Uuid uuid = addSymbol("Symbol");
+    Uuid otherUuid = addSymbol("Other Symbol");
+    EXPECT_EQ(2, scan());
+    DbSymbol other = getSymbolsFromDb().value(otherUuid);
+
+    // the file size changes with the name, so it's detected even if the timestamp of
+    // the file has a low resolution
+    {
+        Symbol symbol(getSymbolFilePath(uuid).getParentDir(), false);
+        symbol.setName("en_US", "Modified Symbol");
+        symbol.save();
+    }
+    EXPECT_EQ(2, scan());
+    QHash<Uuid, DbSymbol> symbols = getSymbolsFromDb();
+    EXPECT_EQ(2, symbols.count());
+    EXPECT_EQ("Modified Symbol", symbols.value(uuid).name.toStdString());
+    EXPECT_EQ(QFileInfo(getSymbolFilePath(uuid).toStr()).size(), symbols.value(uuid).size);
+    EXPECT_EQ(other.id, symbols.value(otherUuid).id); // not touched at all
+}
+
+TEST_F(WorkspaceLibraryScannerTest, testTouchedElementIsNotReinserted)
+{
+    Uuid uuid = addSymbol("Symbol");
+    EXPECT_EQ(1, scan());
+    DbSymbol original = getSymbolsFromDb().value(uuid);
+
+    // pretend the file was touched (e.g. by a git checkout) without modifying it
+    execInDb("UPDATE symbols SET file_modified = 0");
+    EXPECT_EQ(1, scan());
+    DbSymbol touched = getSymbolsFromDb().value(uuid);
+    EXPECT_EQ(original.id, touched.id);
+    EXPECT_EQ(original.modified, touched.modified); // fingerprint updated
+    EXPECT_EQ(original.size, touched.size);
+    EXPECT_EQ(original.name, touched.name);
+}
+
+TEST_F(WorkspaceLibraryScannerTest, testRemovedElementIsDeleted)
+{
+    Uuid uuid1 = addSymbol("Symbol 1");
+    Uuid uuid2 = addSymbol("Symbol 2");
+    EXPECT_EQ(2, scan());
+
+    FileUtils::removeDirRecursively(getSymbolFilePath(uuid1).getParentDir());
+    EXPECT_EQ(1, scan());
+    EXPECT_EQ(QList<Uuid>{uuid2}, getSymbolsFromDb().keys());
+    EXPECT_EQ(1, getRowCount("symbols_tr"));
+}
+
+TEST_F(WorkspaceLibraryScannerTest, testRemovedLibraryIsDeleted)
+{
+    addSymbol("Symbol");
+    EXPECT_EQ(1, scan());
+    EXPECT_EQ(1, getRowCount("libraries"));
+
+    FileUtils::removeDirRecursively(mLibDir);
+    reopenWorkspace();
+    EXPECT_EQ(0, scan());
+    EXPECT_EQ(0, getRowCount("libraries"));
+    EXPECT_EQ(0, getRowCount("libraries_tr"));
+    EXPECT_EQ(0, getRowCount("symbols"));
+    EXPECT_EQ(0, getRowCount("symbols_tr"));
+}
+
+TEST_F(WorkspaceLibraryScannerTest, testParallelScanEqualsSequentialScan)
+{
+    // add more elements than the scanner reads in parallel, so the queue of pending
+    // jobs is full several times
+    Uuid category = addComponentCategory("Category");
+    int count = qMax(QThread::idealThreadCount(), 1) * 4 * 3 + 1;
+    for (int i = 0; i < count; ++i) {
+        addSymbol(QString("Symbol %1").arg(i),
+                  (i % 2) ? QSet<Uuid>{category} : QSet<Uuid>());
+    }
+    QStringList tables{"libraries", "libraries_tr", "component_categories",
+                       "component_categories_tr", "symbols", "symbols_tr", "symbols_cat"};
+
+    // parallel scan
+    EXPECT_EQ(count + 1, scan());
+    QMap<QString, QList<QVariantList>> parallelContent;
+    foreach (const QString& table, tables) {
+        parallelContent.insert(table, getTableContentFromDb(table));
+    }
+    EXPECT_EQ(count, parallelContent.value("symbols").count());
+    EXPECT_EQ(count / 2, parallelContent.value("symbols_cat").count());
+
+    // sequential scan into a new database
+    mWs.reset();
+    QFile(mWsDir.getPathTo("v" % qApp->getFileFormatVersion().toStr())
+          .getPathTo("libraries/cache.sqlite").toStr()).remove();
+    reopenWorkspace();
+    int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    auto threadCountGuard = scopeGuard([maxThreadCount](){
+        QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+    });
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    EXPECT_EQ(count + 1, scan());
+    foreach (const QString& table, tables) {
+        EXPECT_EQ(parallelContent.value(table), getTableContentFromDb(table))
+            << "Content of table " << qPrintable(table) << " differs";
+    }
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace workspace
+} // namespace librepcb
@@ -0,0 +1,254 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * http://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*****************************************************************************************
+ *  Includes
+ ****************************************************************************************/
+#include <QtCore>
+#include <QtSql>
+#include <functional>
+#include <gtest/gtest.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
+#include "workspacelibrarydbfixture.h"
+
+/*****************************************************************************************
+ *  Namespace
+ ****************************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+/*****************************************************************************************
+ *  Test Class
+ ****************************************************************************************/
+
+/**
+ * @brief The WorkspaceLibrarySearchTest checks the results, paging and cancellation of
+ *        the component search worker thread
+ *
+ * The signals are received with direct connections in the worker thread, which allows
+ * to start or cancel searches at a well-defined point of a running search.
+ */
+class WorkspaceLibrarySearchTest : public WorkspaceLibraryDbFixture
+{
+    protected:
+
+        /// Everything received for a single search ID
+        struct Result {
+            QList<int> pageSizes;
+            QList<WorkspaceLibrarySearch::ComponentMatch> components;
+            int componentCount;     ///< -1 if searchSucceeded() was not emitted
+            QString errorMsg;
+        };
+
+        WorkspaceLibrarySearchTest() {
+            addComponent({{"", "Resistor 0805 (old)", "smd"}}, mResistor0805, "0.0.1");
+            addDevice(mResistor0805, "Resistor 0805 Device", QString(),
+                      addPackage({{"", "R0805"}, {"de_CH", "R0805 DE"}}));
+        }
+
+        void addParts(int count) {
+            for (int i = 0; i < count; ++i) {
+                addComponent({{"", QString("Part %1").arg(i), ""}});
+            }
+        }
+
+        /// Receive the signals of the search in the worker thread (see class description)
+        void connectSignals(WorkspaceLibrarySearch& search,
+                            std::function<void(int)> pageReceived = nullptr) {
+            QObject::connect(&search, &WorkspaceLibrarySearch::resultsAvailable,
+                [this, pageReceived](int searchId,
+                                     QList<WorkspaceLibrarySearch::ComponentMatch> page) {
+                    {
+                        QMutexLocker locker(&mMutex);
+                        getResult(searchId).pageSizes.append(page.count());
+                        getResult(searchId).components.append(page);
+                    }
+                    if (pageReceived) pageReceived(searchId);
+                }, Qt::DirectConnection);
+            QObject::connect(&search, &WorkspaceLibrarySearch::searchSucceeded,
+                [this](int searchId, int componentCount) {
+                    QMutexLocker locker(&mMutex);
+                    getResult(searchId).componentCount = componentCount;
+                }, Qt::DirectConnection);
+            QObject::connect(&search, &WorkspaceLibrarySearch::searchFailed,
+                [this](int searchId, QString errorMsg) {
+                    QMutexLocker locker(&mMutex);
+                    getResult(searchId).errorMsg = errorMsg;
+                }, Qt::DirectConnection);
+        }
+
+        Result waitForSearch(int searchId) {
+            qint64 start = QDateTime::currentDateTime().toMSecsSinceEpoch();
+            auto currentTime = [](){return QDateTime::currentDateTime().toMSecsSinceEpoch();};
+            while (currentTime() - start < 10000) {
+                {
+                    QMutexLocker locker(&mMutex);
+                    Result result = getResult(searchId);
+                    if ((result.componentCount >= 0) || (!result.errorMsg.isEmpty())) {
+                        EXPECT_EQ("", result.errorMsg.toStdString());
+                        return result;
+                    }
+                }
+                QThread::msleep(10);
+            }
+            ADD_FAILURE() << "Search timed out!";
+            return getResultLocked(searchId);
+        }
+
+        Result getResultLocked(int searchId) {
+            QMutexLocker locker(&mMutex);
+            return getResult(searchId);
+        }
+
+        Result& getResult(int searchId) noexcept {
+            if (!mResults.contains(searchId)) {
+                mResults.insert(searchId, Result{{}, {}, -1, QString()});
+            }
+            return mResults[searchId];
+        }
+
+        static QList<Uuid> getUuids(const Result& result) noexcept {
+            QList<Uuid> uuids;
+            foreach (const auto& match, result.components) {
+                uuids.append(match.uuid);
+            }
+            return uuids;
+        }
+
+        QMutex mMutex;
+        QHash<int, Result> mResults;    ///< protected by #mMutex
+};
+
+/*****************************************************************************************
+ *  Test Methods
+ ****************************************************************************************/
+
+TEST_F(WorkspaceLibrarySearchTest, testResults)
+{
+    WorkspaceLibrarySearch search(*mWs);
+    connectSignals(search);
+    Result result = waitForSearch(search.startSearch("resistor", {"de_CH"}));
+    EXPECT_EQ(3, result.componentCount);
+    EXPECT_EQ(QList<int>{3}, result.pageSizes);
+    ASSERT_EQ(3, result.components.count());
+    EXPECT_EQ(QSet<Uuid>({mResistor0805, mResistorTht, mResistorArray}),
+              QSet<Uuid>::fromList(getUuids(result)));
+
+    // names in the requested locale are ranked first
+    const WorkspaceLibrarySearch::ComponentMatch& array = result.components.first();
+    EXPECT_EQ(mResistorArray, array.uuid);
+    EXPECT_EQ("Resistor Array", array.name.toStdString());
+    EXPECT_TRUE(array.devices.isEmpty());
+
+    // only the latest version of a component is returned, with its devices
+    foreach (const WorkspaceLibrarySearch::ComponentMatch& match, result.components) {
+        if (match.uuid != mResistor0805) continue;
+        EXPECT_EQ("Resistor 0805", match.name.toStdString());
+        EXPECT_EQ(mWs->getLibrariesPath().getPathTo(
+                      getFilePath("components", mResistor0805, "0.1")), match.filepath);
+        ASSERT_EQ(1, match.devices.count());
+        EXPECT_EQ("Resistor 0805 Device", match.devices.first().name.toStdString());
+        EXPECT_EQ("R0805 DE", match.devices.first().packageName.toStdString());
+    }
+}
+
+TEST_F(WorkspaceLibrarySearchTest, testNoResults)
+{
+    WorkspaceLibrarySearch search(*mWs);
+    connectSignals(search);
+    Result result = waitForSearch(search.startSearch("inductor", {}));
+    EXPECT_EQ(0, result.componentCount);
+    EXPECT_TRUE(result.pageSizes.isEmpty());
+    result = waitForSearch(search.startSearch("  ", {}));
+    EXPECT_EQ(0, result.componentCount);
+    EXPECT_TRUE(result.pageSizes.isEmpty());
+}
+
+TEST_F(WorkspaceLibrarySearchTest, testPaging)
+{
+    addParts(120);
+    WorkspaceLibrarySearch search(*mWs);
+    connectSignals(search);
+    Result result = waitForSearch(search.startSearch("part", {}));
+    EXPECT_EQ(120, result.componentCount);
+    EXPECT_EQ(QList<int>({50, 50, 20}), result.pageSizes);
+    EXPECT_EQ(120, QSet<Uuid>::fromList(getUuids(result)).count());
+}
+
+TEST_F(WorkspaceLibrarySearchTest, testSupersededSearchIsCancelled)
+{
+    addParts(120);
+    WorkspaceLibrarySearch search(*mWs);
+    QAtomicInt secondSearchId(-1);
+    connectSignals(search, [&](int){
+        // start a new search while the first one is still running
+        if (secondSearchId.load() < 0) {
+            secondSearchId.store(search.startSearch("resistor", {}));
+        }
+    });
+    int firstSearchId = search.startSearch("part", {});
+    for (int i = 0; (i < 1000) && (secondSearchId.load() < 0); ++i) {
+        QThread::msleep(10);
+    }
+    ASSERT_GE(secondSearchId.load(), 0) << "First page not received!";
+    Result second = waitForSearch(secondSearchId.load());
+    EXPECT_EQ(3, second.componentCount);
+
+    // the first search was cancelled after its first page
+    Result first = getResultLocked(firstSearchId);
+    EXPECT_EQ(QList<int>{50}, first.pageSizes);
+    EXPECT_EQ(-1, first.componentCount);
+    EXPECT_EQ("", first.errorMsg.toStdString());
+}
+
+TEST_F(WorkspaceLibrarySearchTest, testCancelledSearch)
+{
+    addParts(120);
+    WorkspaceLibrarySearch search(*mWs);
+    QAtomicInt cancelled(0);
+    connectSignals(search, [&](int){
+        // cancel the first search after its first page
+        if (cancelled.load() == 0) {
+            search.cancelSearch();
+            cancelled.store(1);
+        }
+    });
+    int firstSearchId = search.startSearch("part", {});
+    for (int i = 0; (i < 1000) && (cancelled.load() == 0); ++i) {
+        QThread::msleep(10);
+    }
+    ASSERT_EQ(1, cancelled.load()) << "First page not received!";
+
+    // searches are processed sequentially, so the first one is finished after the next
+    Result second = waitForSearch(search.startSearch("resistor", {}));
+    EXPECT_EQ(3, second.componentCount);
+    Result first = getResultLocked(firstSearchId);
+    EXPECT_EQ(QList<int>{50}, first.pageSizes);
+    EXPECT_EQ(-1, first.componentCount);
+    EXPECT_EQ("", first.errorMsg.toStdString());
+}
+
+/*****************************************************************************************
+ *  End of File
+ ****************************************************************************************/
+
+} // namespace tests
+} // namespace workspace
+} // namespace librepcb